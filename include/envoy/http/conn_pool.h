@@ -96,6 +96,13 @@ public:
    */
   virtual void drainConnections() PURE;
 
+  /**
+   * Establish a connection ahead of any stream if the pool does not have one yet, subject to the
+   * cluster's circuit breakers. This can be used to avoid paying for connection establishment on
+   * the request path, for example when a host is first added to a cluster.
+   */
+  virtual void prewarm() PURE;
+
   /**
    * Determines whether the connection pool is actively processing any requests.
    * @return true if the connection pool has any pending requests or any active requests.
@@ -39,6 +39,31 @@ public:
 
 typedef std::unique_ptr<RandomGenerator> RandomGeneratorPtr;
 
+/**
+ * A runtime key registered ahead of time, typically when configuration is loaded. Snapshots cache
+ * the result of looking up a handle by its index, so after the first lookup in a snapshot fetching
+ * a value is an array access rather than a hash of the key string. Handles are obtained from
+ * Runtime::KeyRegistry.
+ */
+class KeyHandle {
+public:
+  KeyHandle(const std::string& name, uint32_t index) : name_(name), index_(index) {}
+
+  /**
+   * @return const std::string& the runtime key.
+   */
+  const std::string& name() const { return name_; }
+
+  /**
+   * @return uint32_t the index of the key in each snapshot's resolved key table.
+   */
+  uint32_t index() const { return index_; }
+
+private:
+  const std::string name_;
+  const uint32_t index_;
+};
+
 /**
  * A snapshot of runtime data.
  */
@@ -189,6 +214,35 @@ public:
    */
   virtual uint64_t getInteger(const std::string& key, uint64_t default_value) const PURE;
 
+  /**
+   * Variants of featureEnabled() and getInteger() taking a pre-registered key. These behave exactly
+   * like the string keyed versions, which the defaults below forward to; implementations override
+   * them to skip the key lookup.
+   */
+  virtual bool featureEnabled(const KeyHandle& key, uint64_t default_value) const {
+    return featureEnabled(key.name(), default_value);
+  }
+  virtual bool featureEnabled(const KeyHandle& key, uint64_t default_value,
+                              uint64_t random_value) const {
+    return featureEnabled(key.name(), default_value, random_value);
+  }
+  virtual bool featureEnabled(const KeyHandle& key, uint64_t default_value, uint64_t random_value,
+                              uint64_t num_buckets) const {
+    return featureEnabled(key.name(), default_value, random_value, num_buckets);
+  }
+  virtual bool featureEnabled(const KeyHandle& key,
+                              const envoy::type::FractionalPercent& default_value) const {
+    return featureEnabled(key.name(), default_value);
+  }
+  virtual bool featureEnabled(const KeyHandle& key,
+                              const envoy::type::FractionalPercent& default_value,
+                              uint64_t random_value) const {
+    return featureEnabled(key.name(), default_value, random_value);
+  }
+  virtual uint64_t getInteger(const KeyHandle& key, uint64_t default_value) const {
+    return getInteger(key.name(), default_value);
+  }
+
   /**
    * Fetch the OverrideLayers that provide values in this snapshot. Layers are ordered from bottom
    * to top; for instance, the second layer's entries override the first layer's entries, and so on.
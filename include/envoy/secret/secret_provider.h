@@ -36,6 +36,7 @@ public:
 typedef std::unique_ptr<envoy::api::v2::auth::TlsCertificate> TlsCertificatePtr;
 typedef std::unique_ptr<envoy::api::v2::auth::CertificateValidationContext>
     CertificateValidationContextPtr;
+typedef std::unique_ptr<envoy::api::v2::auth::TlsSessionTicketKeys> TlsSessionTicketKeysPtr;
 
 typedef SecretProvider<envoy::api::v2::auth::TlsCertificate> TlsCertificateConfigProvider;
 typedef std::shared_ptr<TlsCertificateConfigProvider> TlsCertificateConfigProviderSharedPtr;
@@ -45,5 +46,10 @@ typedef SecretProvider<envoy::api::v2::auth::CertificateValidationContext>
 typedef std::shared_ptr<CertificateValidationContextConfigProvider>
     CertificateValidationContextConfigProviderSharedPtr;
 
+typedef SecretProvider<envoy::api::v2::auth::TlsSessionTicketKeys>
+    TlsSessionTicketKeysConfigProvider;
+typedef std::shared_ptr<TlsSessionTicketKeysConfigProvider>
+    TlsSessionTicketKeysConfigProviderSharedPtr;
+
 } // namespace Secret
 } // namespace Envoy
@@ -49,6 +49,22 @@ public:
    * request.
    */
   virtual const Http::HeaderMap& getRequestHeaders() const PURE;
+
+  /**
+   * Callback used to produce a streamed response one chunk at a time.
+   * @param chunk supplies the buffer to append the next chunk of the response to.
+   * @return bool true if there is more to send, false if this was the last chunk.
+   */
+  using StreamingCallback = std::function<bool(Buffer::Instance& chunk)>;
+
+  /**
+   * Streams the rest of the response after the handler returns. The callback is invoked once per
+   * dispatcher iteration, and is paused while the downstream connection is above its high
+   * watermark, so that large responses neither block the main thread nor get buffered in full.
+   * The stream is ended once the callback returns false, regardless of setEndStreamOnComplete().
+   * @param cb supplies the callback producing the remainder of the response.
+   */
+  virtual void streamResponse(StreamingCallback cb) PURE;
 };
 
 /**
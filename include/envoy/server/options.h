@@ -133,6 +133,18 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return uint64_t the maximum number of bytes buffered for each access log file, or 0 for no
+   *         limit.
+   */
+  virtual uint64_t fileBufferLimitBytes() const PURE;
+
+  /**
+   * @return bool whether writes to an access log file whose buffer is full are dropped rather than
+   *         waiting for the buffer to be flushed.
+   */
+  virtual bool dropOnFileBufferLimit() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
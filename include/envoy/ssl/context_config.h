@@ -6,6 +6,7 @@
 
 #include "envoy/common/pure.h"
 #include "envoy/ssl/certificate_validation_context_config.h"
+#include "envoy/ssl/private_key_operations.h"
 #include "envoy/ssl/tls_certificate_config.h"
 
 namespace Envoy {
@@ -57,6 +58,12 @@ public:
    */
   virtual unsigned maxProtocolVersion() const PURE;
 
+  /**
+   * @return true if small TLS records are written at the start of a connection and after it has
+   * been idle, rather than always writing full size records.
+   */
+  virtual bool dynamicRecordSizing() const PURE;
+
   /**
    * @return true if the ContextConfig is able to provide secrets to create SSL context,
    * and false if dynamic secrets are expected but are not downloaded from SDS server yet.
@@ -119,6 +126,12 @@ public:
    * are candidates for decrypting received tickets.
    */
   virtual const std::vector<SessionTicketKey>& sessionTicketKeys() const PURE;
+
+  /**
+   * @return PrivateKeyOperationRunnerSharedPtr the runner that private key operations are offloaded
+   * to, or nullptr if they are performed on the worker thread during the handshake.
+   */
+  virtual PrivateKeyOperationRunnerSharedPtr privateKeyOperationRunner() const PURE;
 };
 
 typedef std::unique_ptr<ServerContextConfig> ServerContextConfigPtr;
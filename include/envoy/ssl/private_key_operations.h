@@ -0,0 +1,31 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * Runs the private key operations (signing, and decryption for RSA key exchange) of TLS handshakes
+ * away from the worker thread that owns the connection, so that a burst of handshakes does not
+ * stall the other connections on that worker.
+ */
+class PrivateKeyOperationRunner {
+public:
+  virtual ~PrivateKeyOperationRunner() {}
+
+  /**
+   * Queues an operation to run on another thread. The operation is responsible for handing its
+   * result back to the connection's dispatcher.
+   * @param operation supplies the operation to run.
+   */
+  virtual void post(std::function<void()> operation) PURE;
+};
+
+typedef std::shared_ptr<PrivateKeyOperationRunner> PrivateKeyOperationRunnerSharedPtr;
+
+} // namespace Ssl
+} // namespace Envoy
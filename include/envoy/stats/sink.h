@@ -31,6 +31,13 @@ public:
    * @param value the value of the sample.
    */
   virtual void onHistogramComplete(const Histogram& histogram, uint64_t value) PURE;
+
+  /**
+   * @return bool whether flush() may be called on a thread other than the main thread. Such a
+   * thread is registered for thread local updates, but the sink must not use objects that are only
+   * safe to use on the main thread, such as the cluster manager's clusters or the main dispatcher.
+   */
+  virtual bool threadSafeFlush() const PURE;
 };
 
 typedef std::unique_ptr<Sink> SinkPtr;
@@ -51,5 +51,7 @@ public:
   virtual void clearCache() PURE;
 };
 
+typedef std::shared_ptr<Source> SourceSharedPtr;
+
 } // namespace Stats
 } // namespace Envoy
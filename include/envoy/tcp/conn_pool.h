@@ -191,6 +191,12 @@ public:
    */
   virtual void drainConnections() PURE;
 
+  /**
+   * Establish a connection ahead of any request if the pool does not have one yet, subject to the
+   * cluster's circuit breakers.
+   */
+  virtual void prewarm() PURE;
+
   /**
    * Create a new connection on the pool.
    * @param cb supplies the callbacks to invoke when the connection is ready or has failed. The
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <set>
 #include <string>
 #include <vector>
@@ -64,6 +65,23 @@ public:
    * selection from the fallback subset fails.
    */
   virtual bool panicModeAny() const PURE;
+
+  /*
+   * @return bool whether subsets should only be materialized when first selected.
+   */
+  virtual bool lazySubsetCreation() const PURE;
+
+  /*
+   * @return std::chrono::milliseconds how long a lazily created subset may go unselected before
+   * it is evicted.
+   */
+  virtual std::chrono::milliseconds lazySubsetIdleTimeout() const PURE;
+
+  /*
+   * @return uint32_t the maximum number of lazily created subsets materialized at once. Zero
+   * means there is no limit.
+   */
+  virtual uint32_t maxLazySubsets() const PURE;
 };
 
 } // namespace Upstream
@@ -461,6 +461,8 @@ public:
   COUNTER  (lb_subsets_selected)                                                                   \
   COUNTER  (lb_subsets_fallback)                                                                   \
   COUNTER  (lb_subsets_fallback_panic)                                                             \
+  COUNTER  (lb_subsets_evicted)                                                                    \
+  HISTOGRAM(lb_subsets_rebuild_ms)                                                                 \
   COUNTER  (original_dst_host_invalid)                                                             \
   COUNTER  (upstream_cx_total)                                                                     \
   GAUGE    (upstream_cx_active)                                                                    \
@@ -488,6 +490,8 @@ public:
   COUNTER  (upstream_cx_max_requests)                                                              \
   COUNTER  (upstream_cx_none_healthy)                                                              \
   COUNTER  (upstream_cx_pool_overflow)                                                             \
+  COUNTER  (upstream_cx_prefetch_total)                                                            \
+  COUNTER  (upstream_rq_prefetch_hit)                                                              \
   COUNTER  (upstream_rq_total)                                                                     \
   GAUGE    (upstream_rq_active)                                                                    \
   COUNTER  (upstream_rq_completed)                                                                 \
@@ -605,6 +609,8 @@ public:
     static const uint64_t USE_DOWNSTREAM_PROTOCOL = 0x2;
     // Whether connections should be immediately closed upon health failure.
     static const uint64_t CLOSE_CONNECTIONS_ON_HOST_HEALTH_FAILURE = 0x4;
+    // Whether HTTP/2 connection pools are shared across workers.
+    static const uint64_t SHARED_HTTP2_CONN_POOL = 0x8;
   };
 
   virtual ~ClusterInfo() {}
@@ -772,6 +778,18 @@ public:
    */
   virtual bool drainConnectionsOnHostRemoval() const PURE;
 
+  /**
+   * @return float the number of connections each connection pool should keep open relative to
+   *         the number of requests it is serving. A value of 1.0 disables prefetching.
+   */
+  virtual float perUpstreamPrefetchRatio() const PURE;
+
+  /**
+   * @return bool whether connection pools should establish a connection to newly added hosts
+   *         ahead of the first request.
+   */
+  virtual bool prewarmNewHosts() const PURE;
+
   /**
    * @return eds cluster service_name of the cluster.
    */
@@ -8,9 +8,11 @@
 #include "common/common/fmt.h"
 #include "common/common/utility.h"
 #include "common/config/metadata.h"
+#include "common/http/headers.h"
 #include "common/http/utility.h"
 #include "common/stream_info/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_split.h"
 #include "fmt/format.h"
 
@@ -76,6 +78,32 @@ AccessLogFormatUtils::protocolToString(const absl::optional<Http::Protocol>& pro
 
 FormatterImpl::FormatterImpl(const std::string& format) {
   providers_ = AccessLogFormatParser::parse(format);
+
+  for (const FormatterProviderPtr& provider : providers_) {
+    Step step;
+    if (const auto* plain = dynamic_cast<const PlainStringFormatter*>(provider.get())) {
+      literal_length_ += plain->str().size();
+      if (!steps_.empty() && steps_.back().type_ == Step::Type::Literal) {
+        steps_.back().literal_ += plain->str();
+        continue;
+      }
+      step.type_ = Step::Type::Literal;
+      step.literal_ = plain->str();
+    } else if (const auto* header = dynamic_cast<const RequestHeaderFormatter*>(provider.get())) {
+      step.type_ = Step::Type::RequestHeader;
+      step.header_ = header;
+    } else if (const auto* header = dynamic_cast<const ResponseHeaderFormatter*>(provider.get())) {
+      step.type_ = Step::Type::ResponseHeader;
+      step.header_ = header;
+    } else if (const auto* header = dynamic_cast<const ResponseTrailerFormatter*>(provider.get())) {
+      step.type_ = Step::Type::ResponseTrailer;
+      step.header_ = header;
+    } else {
+      step.type_ = Step::Type::Provider;
+      step.provider_ = provider.get();
+    }
+    steps_.push_back(std::move(step));
+  }
 }
 
 std::string FormatterImpl::format(const Http::HeaderMap& request_headers,
@@ -83,10 +111,27 @@ std::string FormatterImpl::format(const Http::HeaderMap& request_headers,
                                   const Http::HeaderMap& response_trailers,
                                   const StreamInfo::StreamInfo& stream_info) const {
   std::string log_line;
-  log_line.reserve(256);
-
-  for (const FormatterProviderPtr& provider : providers_) {
-    log_line += provider->format(request_headers, response_headers, response_trailers, stream_info);
+  log_line.reserve(literal_length_ + 256);
+
+  for (const Step& step : steps_) {
+    switch (step.type_) {
+    case Step::Type::Literal:
+      log_line += step.literal_;
+      break;
+    case Step::Type::RequestHeader:
+      step.header_->appendTo(log_line, request_headers);
+      break;
+    case Step::Type::ResponseHeader:
+      step.header_->appendTo(log_line, response_headers);
+      break;
+    case Step::Type::ResponseTrailer:
+      step.header_->appendTo(log_line, response_trailers);
+      break;
+    case Step::Type::Provider:
+      log_line +=
+          step.provider_->format(request_headers, response_headers, response_trailers, stream_info);
+      break;
+    }
   }
 
   return log_line;
@@ -426,27 +471,54 @@ std::string PlainStringFormatter::format(const Http::HeaderMap&, const Http::Hea
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
                                  const std::string& alternative_header,
                                  absl::optional<size_t> max_length)
-    : main_header_(main_header), alternative_header_(alternative_header), max_length_(max_length) {}
+    : main_header_(main_header), alternative_header_(alternative_header), max_length_(max_length),
+      main_header_getter_(inlineHeaderGetter(main_header_)),
+      alternative_header_getter_(inlineHeaderGetter(alternative_header_)) {}
+
+HeaderFormatter::InlineHeaderGetter
+HeaderFormatter::inlineHeaderGetter(const Http::LowerCaseString& header) {
+  static const auto* getters = []() {
+    auto* getters = new absl::flat_hash_map<std::string, InlineHeaderGetter>();
+#define INLINE_HEADER_GETTER(name)                                                                 \
+  getters->emplace(Http::Headers::get().name.get(),                                                \
+                   static_cast<InlineHeaderGetter>(&Http::HeaderMap::name));
+    ALL_INLINE_HEADERS(INLINE_HEADER_GETTER)
+#undef INLINE_HEADER_GETTER
+    return getters;
+  }();
+
+  const auto it = getters->find(header.get());
+  return it == getters->end() ? nullptr : it->second;
+}
 
-std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
-  const Http::HeaderEntry* header = headers.get(main_header_);
+const Http::HeaderEntry* HeaderFormatter::findHeader(const Http::HeaderMap& headers) const {
+  const Http::HeaderEntry* header =
+      main_header_getter_ ? (headers.*main_header_getter_)() : headers.get(main_header_);
 
   if (!header && !alternative_header_.get().empty()) {
-    header = headers.get(alternative_header_);
+    header = alternative_header_getter_ ? (headers.*alternative_header_getter_)()
+                                        : headers.get(alternative_header_);
   }
 
+  return header;
+}
+
+std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
   std::string header_value_string;
-  if (!header) {
-    header_value_string = UnspecifiedValueString;
-  } else {
-    header_value_string = std::string(header->value().getStringView());
-  }
+  appendTo(header_value_string, headers);
+  return header_value_string;
+}
 
-  if (max_length_ && header_value_string.length() > max_length_.value()) {
-    return header_value_string.substr(0, max_length_.value());
+void HeaderFormatter::appendTo(std::string& output, const Http::HeaderMap& headers) const {
+  const Http::HeaderEntry* header = findHeader(headers);
+  absl::string_view value =
+      header ? header->value().getStringView() : absl::string_view(UnspecifiedValueString);
+
+  if (max_length_ && value.length() > max_length_.value()) {
+    value = value.substr(0, max_length_.value());
   }
 
-  return header_value_string;
+  output.append(value.data(), value.size());
 }
 
 ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
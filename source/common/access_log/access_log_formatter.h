@@ -82,8 +82,12 @@ private:
   static const std::string DEFAULT_FORMAT;
 };
 
+class HeaderFormatter;
+
 /**
- * Composite formatter implementation.
+ * Composite formatter implementation. The parsed format is compiled into a flat list of steps:
+ * adjacent literals are merged, and literals and header values are appended to the log line
+ * directly rather than being copied into a string per provider first.
  */
 class FormatterImpl : public Formatter {
 public:
@@ -96,7 +100,19 @@ public:
                      const StreamInfo::StreamInfo& stream_info) const override;
 
 private:
+  struct Step {
+    enum class Type { Literal, RequestHeader, ResponseHeader, ResponseTrailer, Provider };
+
+    Type type_;
+    std::string literal_;
+    const HeaderFormatter* header_{};
+    const FormatterProvider* provider_{};
+  };
+
   std::vector<FormatterProviderPtr> providers_;
+  std::vector<Step> steps_;
+  // Bytes of literal text in each log line, used to size the line up front.
+  size_t literal_length_{};
 };
 
 class JsonFormatterImpl : public Formatter {
@@ -130,10 +146,16 @@ public:
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&, const Http::HeaderMap&,
                      const StreamInfo::StreamInfo&) const override;
 
+  const std::string& str() const { return str_; }
+
 private:
   std::string str_;
 };
 
+/**
+ * Formats a header value. Headers that the header map keeps inline are read through their inline
+ * accessor, which is resolved once at configuration time, rather than looked up by name.
+ */
 class HeaderFormatter {
 public:
   HeaderFormatter(const std::string& main_header, const std::string& alternative_header,
@@ -141,16 +163,31 @@ public:
 
   std::string format(const Http::HeaderMap& headers) const;
 
+  /**
+   * Append the formatted header value to a log line.
+   * @param output supplies the log line.
+   * @param headers supplies the headers to read the value from.
+   */
+  void appendTo(std::string& output, const Http::HeaderMap& headers) const;
+
 private:
+  using InlineHeaderGetter = const Http::HeaderEntry* (Http::HeaderMap::*)() const;
+
+  // Returns the inline accessor for a header, or nullptr if the header is not an inline header.
+  static InlineHeaderGetter inlineHeaderGetter(const Http::LowerCaseString& header);
+  const Http::HeaderEntry* findHeader(const Http::HeaderMap& headers) const;
+
   Http::LowerCaseString main_header_;
   Http::LowerCaseString alternative_header_;
   absl::optional<size_t> max_length_;
+  const InlineHeaderGetter main_header_getter_;
+  const InlineHeaderGetter alternative_header_getter_;
 };
 
 /**
  * Formatter based on request header.
  */
-class RequestHeaderFormatter : public FormatterProvider, HeaderFormatter {
+class RequestHeaderFormatter : public FormatterProvider, public HeaderFormatter {
 public:
   RequestHeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                          absl::optional<size_t> max_length);
@@ -163,7 +200,7 @@ public:
 /**
  * Formatter based on the response header.
  */
-class ResponseHeaderFormatter : public FormatterProvider, HeaderFormatter {
+class ResponseHeaderFormatter : public FormatterProvider, public HeaderFormatter {
 public:
   ResponseHeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                           absl::optional<size_t> max_length);
@@ -176,7 +213,7 @@ public:
 /**
  * Formatter based on the response trailer.
  */
-class ResponseTrailerFormatter : public FormatterProvider, HeaderFormatter {
+class ResponseTrailerFormatter : public FormatterProvider, public HeaderFormatter {
 public:
   ResponseTrailerFormatter(const std::string& main_header, const std::string& alternative_header,
                            absl::optional<size_t> max_length);
@@ -1,5 +1,6 @@
 #include "common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "common/common/assert.h"
@@ -21,23 +22,108 @@ AccessLogFileSharedPtr AccessLogManagerImpl::createAccessLog(const std::string&
     return access_logs_[file_name];
   }
 
+  if (flusher_ == nullptr) {
+    flusher_ =
+        std::make_shared<AccessLogFlusher>(api_.threadFactory(), api_.timeSource(), file_stats_);
+  }
   access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
       api_.fileSystem().createFile(file_name), dispatcher_, lock_, file_stats_,
-      file_flush_interval_msec_, api_.threadFactory());
+      file_flush_interval_msec_, flusher_, file_buffer_limit_bytes_, drop_on_file_buffer_limit_);
   return access_logs_[file_name];
 }
 
+AccessLogFlusher::AccessLogFlusher(Thread::ThreadFactory& thread_factory, TimeSource& time_source,
+                                   AccessLogFileStats& stats)
+    : thread_factory_(thread_factory), time_source_(time_source), stats_(stats) {}
+
+AccessLogFlusher::~AccessLogFlusher() {
+  {
+    Thread::LockGuard lock(lock_);
+    flush_thread_exit_ = true;
+    flush_event_.notifyOne();
+  }
+
+  if (flush_thread_ != nullptr) {
+    flush_thread_->join();
+  }
+}
+
+void AccessLogFlusher::requestFlush(AccessLogFileImpl& file) {
+  // Requests for a file that is already queued are coalesced on the file's own flag, so that writes
+  // to busy files do not all contend on lock_.
+  if (file.flush_queued_.exchange(true)) {
+    return;
+  }
+
+  Thread::LockGuard lock(lock_);
+
+  if (flush_thread_ == nullptr) {
+    flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); });
+  }
+
+  pending_files_.push_back(&file);
+  flush_event_.notifyOne();
+}
+
+void AccessLogFlusher::cancel(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(lock_);
+  pending_files_.erase(std::remove(pending_files_.begin(), pending_files_.end(), &file),
+                       pending_files_.end());
+  while (flushing_file_ == &file) {
+    flush_done_event_.wait(lock_);
+  }
+}
+
+void AccessLogFlusher::flushThreadFunc() {
+  while (true) {
+    AccessLogFileImpl* file;
+
+    {
+      Thread::LockGuard lock(lock_);
+      if (flushing_file_ != nullptr) {
+        flushing_file_ = nullptr;
+        flush_done_event_.notifyAll();
+      }
+
+      while (pending_files_.empty() && !flush_thread_exit_) {
+        flush_event_.wait(lock_);
+      }
+
+      if (flush_thread_exit_) {
+        return;
+      }
+
+      // Files are flushed in the order they asked, so that one busy file cannot starve the others.
+      file = pending_files_.front();
+      pending_files_.pop_front();
+      flushing_file_ = file;
+      // Cleared before flushing, so that data written during the flush queues the file again.
+      file->flush_queued_ = false;
+    }
+
+    const MonotonicTime start = time_source_.monotonicTime();
+    if (file->flushFromThread()) {
+      stats_.last_flush_duration_us_.set(std::chrono::duration_cast<std::chrono::microseconds>(
+                                             time_source_.monotonicTime() - start)
+                                             .count());
+    }
+  }
+}
+
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
+                                     AccessLogFlusherSharedPtr flusher,
+                                     uint64_t buffer_limit_bytes, bool drop_on_buffer_limit)
     : file_(std::move(file)), file_lock_(lock),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
+        flusher_->requestFlush(*this);
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      flusher_(std::move(flusher)), buffer_limit_bytes_(buffer_limit_bytes),
+      drop_on_buffer_limit_(drop_on_buffer_limit), flush_interval_msec_(flush_interval_msec),
+      stats_(stats) {
   open();
 }
 
@@ -52,15 +138,7 @@ void AccessLogFileImpl::open() {
 void AccessLogFileImpl::reopen() { reopen_file_ = true; }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
-  {
-    Thread::LockGuard lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notifyOne();
-  }
-
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  flusher_->cancel(*this);
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
@@ -101,48 +179,47 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   buffer.drain(buffer.length());
 }
 
-void AccessLogFileImpl::flushThreadFunc() {
+bool AccessLogFileImpl::flushFromThread() {
+  std::unique_lock<Thread::BasicLockable> flush_lock;
 
-  while (true) {
-    std::unique_lock<Thread::BasicLockable> flush_lock;
+  {
+    Thread::LockGuard write_lock(write_lock_);
 
-    {
-      Thread::LockGuard write_lock(write_lock_);
+    // The flush can be requested either by a large enough flush_buffer_ or by the timer. In case it
+    // was the timer, or a synchronous flush() got there first, flush_buffer_ can be empty. Writers
+    // may still be waiting for space, so wake them regardless.
+    if (flush_buffer_.length() == 0) {
+      space_event_.notifyAll();
+      return false;
+    }
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_) {
-        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
-      }
+    flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
+    about_to_write_buffer_.move(flush_buffer_);
+    ASSERT(flush_buffer_.length() == 0);
+    space_event_.notifyAll();
+  }
 
-      if (flush_thread_exit_) {
-        return;
-      }
+  // If we failed to open the file before, then simply discard the data.
+  if (!file_->isOpen()) {
+    stats_.write_total_buffered_.sub(about_to_write_buffer_.length());
+    about_to_write_buffer_.drain(about_to_write_buffer_.length());
+    return false;
+  }
 
-      flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      ASSERT(flush_buffer_.length() > 0);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
+  try {
+    if (reopen_file_) {
+      reopen_file_ = false;
+      const Api::IoCallBoolResult result = file_->close();
+      ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                     result.err_->getErrorDetails()));
+      open();
     }
 
-    // if we failed to open file before, then simply ignore
-    if (file_->isOpen()) {
-      try {
-        if (reopen_file_) {
-          reopen_file_ = false;
-          const Api::IoCallBoolResult result = file_->close();
-          ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
-                                         result.err_->getErrorDetails()));
-          open();
-        }
-
-        doWrite(about_to_write_buffer_);
-      } catch (const EnvoyException&) {
-        stats_.reopen_failed_.inc();
-      }
-    }
+    doWrite(about_to_write_buffer_);
+  } catch (const EnvoyException&) {
+    stats_.reopen_failed_.inc();
   }
+  return true;
 }
 
 void AccessLogFileImpl::flush() {
@@ -164,6 +241,7 @@ void AccessLogFileImpl::flush() {
 
     about_to_write_buffer_.move(flush_buffer_);
     ASSERT(flush_buffer_.length() == 0);
+    space_event_.notifyAll();
   }
 
   doWrite(about_to_write_buffer_);
@@ -172,22 +250,36 @@ void AccessLogFileImpl::flush() {
 void AccessLogFileImpl::write(absl::string_view data) {
   Thread::LockGuard lock(write_lock_);
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+  if (!flush_timer_enabled_) {
+    // The first write is flushed straight away, and the timer takes care of the rest.
+    flush_timer_enabled_ = true;
+    flush_timer_->enableTimer(flush_interval_msec_);
+    flusher_->requestFlush(*this);
+  }
+
+  bool blocked = false;
+  while (buffer_limit_bytes_ > 0 && flush_buffer_.length() > 0 &&
+         flush_buffer_.length() + data.size() > buffer_limit_bytes_) {
+    flusher_->requestFlush(*this);
+    if (drop_on_buffer_limit_) {
+      stats_.write_dropped_.inc();
+      return;
+    }
+    if (!blocked) {
+      blocked = true;
+      stats_.write_blocked_.inc();
+    }
+    // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+    space_event_.wait(write_lock_);
   }
 
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
   flush_buffer_.add(data.data(), data.size());
   if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
+    flusher_->requestFlush(*this);
   }
 }
 
-void AccessLogFileImpl::createFlushStructures() {
-  flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); });
-  flush_timer_->enableTimer(flush_interval_msec_);
-}
-
 } // namespace AccessLog
 } // namespace Envoy
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <deque>
 #include <string>
 #include <unordered_map>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
+#include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/filesystem/filesystem.h"
 #include "envoy/stats/stats_macros.h"
@@ -21,7 +23,10 @@ namespace Envoy {
   COUNTER(write_completed)                                                                         \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
-  GAUGE  (write_total_buffered)
+  COUNTER(write_blocked)                                                                           \
+  COUNTER(write_dropped)                                                                           \
+  GAUGE  (write_total_buffered)                                                                    \
+  GAUGE  (last_flush_duration_us)
 // clang-format on
 
 struct AccessLogFileStats {
@@ -30,12 +35,59 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFileImpl;
+
+/**
+ * A single thread that flushes the buffers of every file created by an AccessLogManagerImpl. Files
+ * ask for a flush when their buffer fills up or their flush timer fires, and the flush thread
+ * writes out each pending file in turn. The thread is started on the first request.
+ */
+class AccessLogFlusher {
+public:
+  AccessLogFlusher(Thread::ThreadFactory& thread_factory, TimeSource& time_source,
+                   AccessLogFileStats& stats);
+  ~AccessLogFlusher();
+
+  /**
+   * Queue a file to be flushed by the flush thread. Requests for a file that is already queued are
+   * coalesced without taking the flusher's lock.
+   * @param file supplies the file to flush.
+   */
+  void requestFlush(AccessLogFileImpl& file);
+
+  /**
+   * Remove a file from the queue, waiting for any flush of the file that is in progress. Must be
+   * called before the file is destroyed.
+   * @param file supplies the file to remove.
+   */
+  void cancel(AccessLogFileImpl& file);
+
+private:
+  void flushThreadFunc();
+
+  Thread::ThreadFactory& thread_factory_;
+  TimeSource& time_source_;
+  AccessLogFileStats& stats_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar flush_event_;
+  Thread::CondVar flush_done_event_;
+  Thread::ThreadPtr flush_thread_;
+  std::deque<AccessLogFileImpl*> pending_files_ GUARDED_BY(lock_);
+  AccessLogFileImpl* flushing_file_ GUARDED_BY(lock_){};
+  bool flush_thread_exit_ GUARDED_BY(lock_){};
+};
+
+using AccessLogFlusherSharedPtr = std::shared_ptr<AccessLogFlusher>;
+
 class AccessLogManagerImpl : public AccessLogManager {
 public:
   AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
                        Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
-                       Stats::Store& stats_store)
-      : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
+                       Stats::Store& stats_store, uint64_t file_buffer_limit_bytes,
+                       bool drop_on_file_buffer_limit)
+      : file_flush_interval_msec_(file_flush_interval_msec),
+        file_buffer_limit_bytes_(file_buffer_limit_bytes),
+        drop_on_file_buffer_limit_(drop_on_file_buffer_limit), api_(api), dispatcher_(dispatcher),
         lock_(lock), file_stats_{ACCESS_LOG_FILE_STATS(
                          POOL_COUNTER_PREFIX(stats_store, "access_log_file."),
                          POOL_GAUGE_PREFIX(stats_store, "access_log_file."))} {}
@@ -46,26 +98,31 @@ public:
 
 private:
   const std::chrono::milliseconds file_flush_interval_msec_;
+  const uint64_t file_buffer_limit_bytes_;
+  const bool drop_on_file_buffer_limit_;
   Api::Api& api_;
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
   AccessLogFileStats file_stats_;
+  // Created with the first file, and shared with the files as they may outlive the manager.
+  AccessLogFlusherSharedPtr flusher_;
   std::unordered_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * Writes are buffered and handed to a flush thread that is shared by all the files of the manager.
+ * If a buffer limit is set, writes that would exceed it either wait for the buffer to be flushed
+ * or are dropped.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats_,
                     std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+                    AccessLogFlusherSharedPtr flusher, uint64_t buffer_limit_bytes,
+                    bool drop_on_buffer_limit);
   ~AccessLogFileImpl();
 
   // AccessLog::AccessLogFile
@@ -80,10 +137,12 @@ public:
   void flush() override;
 
 private:
+  friend class AccessLogFlusher;
+
   void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
+  // Called by the flusher's thread. Returns whether any data was written.
+  bool flushFromThread();
   void open();
-  void createFlushStructures();
 
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
@@ -107,10 +166,14 @@ private:
       write_lock_; // The lock is used when filling the flush buffer. It allows
                    // multiple threads to write to the same file at relatively
                    // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  Thread::CondVar flush_event_;
-  std::atomic<bool> flush_thread_exit_{};
+  Thread::CondVar space_event_; // Signalled whenever flush_buffer_ is drained, by either the
+                                // flush thread or flush(), for writes that are waiting for the
+                                // buffer limit.
   std::atomic<bool> reopen_file_{};
+  // Whether the file is in the flusher's queue. Set by AccessLogFlusher::requestFlush() and cleared
+  // by the flush thread when it takes the file off the queue.
+  std::atomic<bool> flush_queued_{};
+  bool flush_timer_enabled_ GUARDED_BY(write_lock_){};
   Buffer::OwnedImpl
       flush_buffer_ GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It gets
                                              // filled and then flushed either when max size is
@@ -124,7 +187,9 @@ private:
                                             // continue to fill. This buffer is then used for the
                                             // final write to disk.
   Event::TimerPtr flush_timer_;
-  Thread::ThreadFactory& thread_factory_;
+  AccessLogFlusherSharedPtr flusher_;
+  const uint64_t buffer_limit_bytes_; // 0 for no limit.
+  const bool drop_on_buffer_limit_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
@@ -13,14 +13,34 @@
 #include "common/http/path_utility.h"
 #include "common/http/utility.h"
 #include "common/network/utility.h"
+#include "common/runtime/runtime_impl.h"
 #include "common/runtime/uuid_util.h"
+#include "common/singleton/const_singleton.h"
 #include "common/tracing/http_tracer_impl.h"
 
 #include "absl/strings/str_join.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Http {
 
+namespace {
+
+// Runtime keys checked on every request.
+class RuntimeKeyValues {
+public:
+  const Runtime::KeyHandle ClientEnabledKey{
+      Runtime::KeyRegistry::get().registerKey("tracing.client_enabled")};
+  const Runtime::KeyHandle RandomSamplingKey{
+      Runtime::KeyRegistry::get().registerKey("tracing.random_sampling")};
+  const Runtime::KeyHandle GlobalEnabledKey{
+      Runtime::KeyRegistry::get().registerKey("tracing.global_enabled")};
+};
+
+using RuntimeKeys = ConstSingleton<RuntimeKeyValues>;
+
+} // namespace
+
 std::string ConnectionManagerUtility::determineNextProtocol(Network::Connection& connection,
                                                             const Buffer::Instance& data) {
   if (!connection.nextProtocol().empty()) {
@@ -210,48 +230,62 @@ Network::Address::InstanceConstSharedPtr ConnectionManagerUtility::mutateRequest
     request_headers.insertRequestId().value(uuid);
   }
 
-  mutateTracingRequestHeader(request_headers, runtime, config);
+  if (config.tracingConfig()) {
+    mutateTracingRequestHeader(request_headers, runtime, *config.tracingConfig());
+  }
   mutateXfccRequestHeader(request_headers, connection, config);
 
   return final_remote_address;
 }
 
-void ConnectionManagerUtility::mutateTracingRequestHeader(HeaderMap& request_headers,
-                                                          Runtime::Loader& runtime,
-                                                          ConnectionManagerConfig& config) {
-  if (!config.tracingConfig() || !request_headers.RequestId()) {
+void ConnectionManagerUtility::mutateTracingRequestHeader(
+    HeaderMap& request_headers, Runtime::Loader& runtime,
+    const TracingConnectionManagerConfig& tracing_config) {
+  if (!request_headers.RequestId()) {
     return;
   }
 
-  // TODO(dnoe): Migrate uuidModBy and others below to take string_view (#6580)
-  std::string x_request_id(request_headers.RequestId()->value().getStringView());
+  HeaderString& x_request_id = request_headers.RequestId()->value();
   uint64_t result;
   // Skip if x-request-id is corrupted.
-  if (!UuidUtils::uuidModBy(x_request_id, result, 10000)) {
+  if (!UuidUtils::uuidModBy(x_request_id.getStringView(), result, 10000)) {
     return;
   }
 
   // Do not apply tracing transformations if we are currently tracing.
-  if (UuidTraceStatus::NoTrace == UuidUtils::isTraceableUuid(x_request_id)) {
+  absl::optional<UuidTraceStatus> trace_status;
+  if (UuidTraceStatus::NoTrace == UuidUtils::isTraceableUuid(x_request_id.getStringView())) {
     if (request_headers.ClientTraceId() &&
-        runtime.snapshot().featureEnabled("tracing.client_enabled",
-                                          config.tracingConfig()->client_sampling_)) {
-      UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::Client);
+        runtime.snapshot().featureEnabled(RuntimeKeys::get().ClientEnabledKey,
+                                          tracing_config.client_sampling_)) {
+      trace_status = UuidTraceStatus::Client;
     } else if (request_headers.EnvoyForceTrace()) {
-      UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::Forced);
-    } else if (runtime.snapshot().featureEnabled("tracing.random_sampling",
-                                                 config.tracingConfig()->random_sampling_, result,
-                                                 10000)) {
-      UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::Sampled);
+      trace_status = UuidTraceStatus::Forced;
+    } else if (runtime.snapshot().featureEnabled(RuntimeKeys::get().RandomSamplingKey,
+                                                 tracing_config.random_sampling_, result, 10000)) {
+      trace_status = UuidTraceStatus::Sampled;
     }
   }
 
-  if (!runtime.snapshot().featureEnabled("tracing.global_enabled",
-                                         config.tracingConfig()->overall_sampling_, result)) {
-    UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::NoTrace);
+  if (!runtime.snapshot().featureEnabled(RuntimeKeys::get().GlobalEnabledKey,
+                                         tracing_config.overall_sampling_, result)) {
+    trace_status = UuidTraceStatus::NoTrace;
   }
 
-  request_headers.RequestId()->value(x_request_id);
+  // Most requests are not sampled, in which case the header is left as is.
+  if (!trace_status) {
+    return;
+  }
+
+  // Only a single character of the uuid changes, so it is updated in place unless the header
+  // references memory it does not own.
+  if (x_request_id.type() == HeaderString::Type::Reference) {
+    std::string new_request_id(x_request_id.getStringView());
+    UuidUtils::setTraceableUuid(new_request_id, trace_status.value());
+    x_request_id.setCopy(new_request_id.data(), new_request_id.size());
+  } else {
+    UuidUtils::setTraceableUuid(x_request_id.buffer(), x_request_id.size(), trace_status.value());
+  }
 }
 
 void ConnectionManagerUtility::mutateXfccRequestHeader(HeaderMap& request_headers,
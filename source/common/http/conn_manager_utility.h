@@ -64,13 +64,14 @@ public:
   // Return false if error happens during the sanitization.
   static bool maybeNormalizePath(HeaderMap& request_headers, const ConnectionManagerConfig& config);
 
-private:
   /**
-   * Mutate request headers if request needs to be traced.
+   * Mutate request headers if request needs to be traced. The sampling decision is encoded in the
+   * x-request-id, which is only modified if the decision changes it.
    */
   static void mutateTracingRequestHeader(HeaderMap& request_headers, Runtime::Loader& runtime,
-                                         ConnectionManagerConfig& config);
+                                         const TracingConnectionManagerConfig& tracing_config);
 
+private:
   static void mutateXfccRequestHeader(HeaderMap& request_headers, Network::Connection& connection,
                                       ConnectionManagerConfig& config);
 };
@@ -1,5 +1,6 @@
 #include "common/http/http1/conn_pool.h"
 
+#include <cmath>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -68,6 +69,7 @@ void ConnPoolImpl::attachRequestToClient(ActiveClient& client, StreamDecoder& re
   ASSERT(!client.stream_wrapper_);
   host_->cluster().stats().upstream_rq_total_.inc();
   host_->stats().rq_total_.inc();
+  client.prefetched_ = false;
   client.stream_wrapper_ = std::make_unique<StreamWrapper>(response_decoder, client);
   callbacks.onPoolReady(*client.stream_wrapper_, client.real_host_description_);
 }
@@ -84,18 +86,51 @@ void ConnPoolImpl::checkForDrained() {
   }
 }
 
-void ConnPoolImpl::createNewConnection() {
-  ENVOY_LOG(debug, "creating a new connection");
+void ConnPoolImpl::createNewConnection(bool prefetched) {
+  ENVOY_LOG(debug, "creating a new {}connection", prefetched ? "prefetched " : "");
   ActiveClientPtr client(new ActiveClient(*this));
+  client->prefetched_ = prefetched;
+  if (prefetched) {
+    host_->cluster().stats().upstream_cx_prefetch_total_.inc();
+  }
+  connecting_clients_++;
   client->moveIntoList(std::move(client), busy_clients_);
 }
 
+// Establishes connections until the pool holds perUpstreamPrefetchRatio() connections for each
+// request it is serving, so that the next requests find a ready connection. Connecting clients
+// count towards the total since they will service pending requests.
+void ConnPoolImpl::maybePrefetch() {
+  const float ratio = host_->cluster().perUpstreamPrefetchRatio();
+  if (ratio <= 1.0) {
+    return;
+  }
+
+  const uint64_t demand = (busy_clients_.size() - connecting_clients_) + pending_requests_.size();
+  const uint64_t target = std::ceil(ratio * demand);
+  while (ready_clients_.size() + busy_clients_.size() < target &&
+         host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    createNewConnection(true);
+  }
+}
+
+void ConnPoolImpl::prewarm() {
+  if (drained_callbacks_.empty() && ready_clients_.empty() && busy_clients_.empty() &&
+      host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    createNewConnection(true);
+  }
+}
+
 ConnectionPool::Cancellable* ConnPoolImpl::newStream(StreamDecoder& response_decoder,
                                                      ConnectionPool::Callbacks& callbacks) {
   if (!ready_clients_.empty()) {
     ready_clients_.front()->moveBetweenLists(ready_clients_, busy_clients_);
     ENVOY_CONN_LOG(debug, "using existing connection", *busy_clients_.front()->codec_client_);
+    if (busy_clients_.front()->prefetched_) {
+      host_->cluster().stats().upstream_rq_prefetch_hit_.inc();
+    }
     attachRequestToClient(*busy_clients_.front(), response_decoder, callbacks);
+    maybePrefetch();
     return nullptr;
   }
 
@@ -111,7 +146,9 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(StreamDecoder& response_dec
       createNewConnection();
     }
 
-    return newPendingRequest(response_decoder, callbacks);
+    ConnectionPool::Cancellable* pending = newPendingRequest(response_decoder, callbacks);
+    maybePrefetch();
+    return pending;
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, absl::string_view(),
@@ -181,6 +218,8 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
   if (client.connect_timer_) {
     client.connect_timer_->disableTimer();
     client.connect_timer_.reset();
+    ASSERT(connecting_clients_ > 0);
+    connecting_clients_--;
   }
 
   // Note that the order in this function is important. Concretely, we must destroy the connect
@@ -43,6 +43,7 @@ public:
   bool hasActiveConnections() const override;
   ConnectionPool::Cancellable* newStream(StreamDecoder& response_decoder,
                                          ConnectionPool::Callbacks& callbacks) override;
+  void prewarm() override;
 
   // ConnPoolImplBase
   void checkForDrained() override;
@@ -101,6 +102,8 @@ protected:
     Event::TimerPtr connect_timer_;
     Stats::TimespanPtr conn_length_;
     uint64_t remaining_requests_;
+    // True if the connection was established ahead of demand and has not served a request yet.
+    bool prefetched_{};
   };
 
   typedef std::unique_ptr<ActiveClient> ActiveClientPtr;
@@ -108,7 +111,8 @@ protected:
   void attachRequestToClient(ActiveClient& client, StreamDecoder& response_decoder,
                              ConnectionPool::Callbacks& callbacks);
   virtual CodecClientPtr createCodecClient(Upstream::Host::CreateConnectionData& data) PURE;
-  void createNewConnection();
+  void createNewConnection(bool prefetched = false);
+  void maybePrefetch();
   void onConnectionEvent(ActiveClient& client, Network::ConnectionEvent event);
   void onDownstreamReset(ActiveClient& client);
   void onResponseComplete(ActiveClient& client);
@@ -123,6 +127,8 @@ protected:
   const Network::ConnectionSocket::OptionsSharedPtr socket_options_;
   Event::TimerPtr upstream_ready_timer_;
   bool upstream_ready_enabled_{false};
+  // Number of clients in busy_clients_ that have not connected yet.
+  uint64_t connecting_clients_{};
 };
 
 /**
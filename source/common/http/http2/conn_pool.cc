@@ -57,6 +57,19 @@ bool ConnPoolImpl::hasActiveConnections() const {
   return !pending_requests_.empty();
 }
 
+void ConnPoolImpl::prewarm() {
+  // HTTP/2 multiplexes all streams over the primary client, so prewarming only needs to make sure
+  // the primary client exists.
+  if (primary_client_ || !drained_callbacks_.empty()) {
+    return;
+  }
+
+  ENVOY_LOG(debug, "creating a new prefetched connection");
+  primary_client_ = std::make_unique<ActiveClient>(*this);
+  primary_client_->prefetched_ = true;
+  host_->cluster().stats().upstream_cx_prefetch_total_.inc();
+}
+
 void ConnPoolImpl::checkForDrained() {
   if (drained_callbacks_.empty()) {
     return;
@@ -123,6 +136,9 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(Http::StreamDecoder& respon
     primary_client_ = std::make_unique<ActiveClient>(*this);
   }
 
+  const bool prefetched = primary_client_->prefetched_;
+  primary_client_->prefetched_ = false;
+
   // If the primary client is not connected yet, queue up the request.
   if (!primary_client_->upstream_ready_) {
     // If we're not allowed to enqueue more requests, fail fast.
@@ -139,6 +155,9 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(Http::StreamDecoder& respon
 
   // We already have an active client that's connected to upstream, so attempt to establish a
   // new stream.
+  if (prefetched) {
+    host_->cluster().stats().upstream_rq_prefetch_hit_.inc();
+  }
   newClientStream(response_decoder, callbacks);
   return nullptr;
 }
@@ -36,6 +36,7 @@ public:
   bool hasActiveConnections() const override;
   ConnectionPool::Cancellable* newStream(Http::StreamDecoder& response_decoder,
                                          ConnectionPool::Callbacks& callbacks) override;
+  void prewarm() override;
 
 protected:
   struct ActiveClient : public Network::ConnectionCallbacks,
@@ -71,6 +72,8 @@ protected:
     bool upstream_ready_{};
     Stats::TimespanPtr conn_length_;
     bool closed_with_active_rq_{};
+    // True if the connection was established ahead of demand and has not served a stream yet.
+    bool prefetched_{};
   };
 
   typedef std::unique_ptr<ActiveClient> ActiveClientPtr;
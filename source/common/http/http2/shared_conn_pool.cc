@@ -0,0 +1,569 @@
+#include "common/http/http2/shared_conn_pool.h"
+
+#include <memory>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+bool DispatcherHandle::post(Event::PostCb callback) {
+  Thread::LockGuard lock(mutex_);
+  if (dispatcher_ == nullptr) {
+    return false;
+  }
+
+  dispatcher_->post(std::move(callback));
+  return true;
+}
+
+void DispatcherHandle::reset() {
+  Thread::LockGuard lock(mutex_);
+  dispatcher_ = nullptr;
+}
+
+ConnectionPool::Instance& SharedConnPool::OwnerPool::pool() {
+  if (pool_ == nullptr) {
+    pool_ = factory_(dispatcher_);
+  }
+
+  return *pool_;
+}
+
+void SharedConnPool::OwnerPool::drainConnections() {
+  if (pool_ != nullptr) {
+    pool_->drainConnections();
+  }
+}
+
+SharedConnPool::SharedConnPool(Event::Dispatcher& dispatcher, OwnerPoolRefSharedPtr owner)
+    : dispatcher_(dispatcher), worker_handle_(std::make_shared<DispatcherHandle>(dispatcher)),
+      owner_(std::move(owner)) {}
+
+SharedConnPool::~SharedConnPool() {
+  // Events from the owner thread may reference streams that are about to be detached.
+  worker_handle_->reset();
+  drained_callbacks_.clear();
+  while (!streams_.empty()) {
+    streams_.front()->onPoolDestroyed();
+  }
+
+  // Make sure all streams are released before we are destroyed.
+  dispatcher_.clearDeferredDeleteList();
+}
+
+void SharedConnPool::addDrainedCallback(DrainedCb cb) {
+  drained_callbacks_.push_back(cb);
+  checkForDrained();
+}
+
+void SharedConnPool::drainConnections() {
+  postToOwnerPool([](OwnerPool& pool) -> void { pool.drainConnections(); });
+}
+
+void SharedConnPool::prewarm() {
+  postToOwnerPool([](OwnerPool& pool) -> void { pool.pool().prewarm(); });
+}
+
+ConnectionPool::Cancellable* SharedConnPool::newStream(StreamDecoder& response_decoder,
+                                                       ConnectionPool::Callbacks& callbacks) {
+  WorkerStreamSharedPtr stream = std::make_shared<WorkerStream>(*this, response_decoder, callbacks);
+  OwnerStreamSharedPtr owner_stream = std::make_shared<OwnerStream>(worker_handle_);
+  stream->owner_ = owner_stream;
+
+  OwnerPool& pool = owner_->pool_;
+  if (!owner_->owner_handle_->post(
+          [&pool, owner_stream, stream]() -> void { owner_stream->start(pool, stream); })) {
+    ENVOY_LOG(debug, "shared connection pool is shut down");
+    callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::ConnectionFailure, "", nullptr);
+    return nullptr;
+  }
+
+  stream->entry_ = streams_.insert(streams_.end(), stream);
+  return stream.get();
+}
+
+void SharedConnPool::postToOwnerPool(std::function<void(OwnerPool&)> cb) {
+  OwnerPool& pool = owner_->pool_;
+  owner_->owner_handle_->post([&pool, cb]() -> void { cb(pool); });
+}
+
+void SharedConnPool::onStreamFinished(WorkerStream& stream) {
+  dispatcher_.deferredDelete(std::make_unique<DeferredRelease>(std::move(*stream.entry_)));
+  streams_.erase(stream.entry_);
+  checkForDrained();
+}
+
+void SharedConnPool::checkForDrained() {
+  if (!drained_callbacks_.empty() && streams_.empty()) {
+    for (const DrainedCb& cb : drained_callbacks_) {
+      cb();
+    }
+  }
+}
+
+void SharedConnPool::OwnerStream::start(OwnerPool& pool, const WorkerStreamSharedPtr& worker) {
+  dispatcher_ = &pool.dispatcher();
+  self_ = shared_from_this();
+  worker_ = worker;
+  // The pool may call back synchronously, in which case this returns nullptr.
+  cancellable_ = pool.pool().newStream(*this, *this);
+}
+
+void SharedConnPool::OwnerStream::postToWorker(std::function<void(WorkerStream&)> cb) {
+  if (worker_ != nullptr) {
+    WorkerStreamSharedPtr worker = worker_;
+    worker_handle_->post([worker, cb]() -> void { cb(*worker); });
+  }
+}
+
+void SharedConnPool::OwnerStream::abandon(StreamResetReason reason) {
+  if (cancellable_ != nullptr) {
+    cancellable_->cancel();
+  } else if (encoder_ != nullptr) {
+    encoder_->getStream().removeCallbacks(*this);
+    encoder_->getStream().resetStream(reason);
+  }
+
+  finish();
+}
+
+void SharedConnPool::OwnerStream::encodeHeaders(const HeaderMap& headers, bool end_stream) {
+  if (encoder_ != nullptr) {
+    encoder_->encodeHeaders(headers, end_stream);
+    if (end_stream) {
+      onLocalComplete();
+    }
+  }
+}
+
+void SharedConnPool::OwnerStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (encoder_ != nullptr) {
+    encoder_->encodeData(data, end_stream);
+    if (end_stream) {
+      onLocalComplete();
+    }
+  }
+}
+
+void SharedConnPool::OwnerStream::encodeTrailers(const HeaderMap& trailers) {
+  if (encoder_ != nullptr) {
+    encoder_->encodeTrailers(trailers);
+    onLocalComplete();
+  }
+}
+
+void SharedConnPool::OwnerStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  if (encoder_ != nullptr) {
+    encoder_->encodeMetadata(metadata_map_vector);
+  }
+}
+
+void SharedConnPool::OwnerStream::readDisable(bool disable) {
+  if (encoder_ != nullptr) {
+    encoder_->getStream().readDisable(disable);
+  }
+}
+
+void SharedConnPool::OwnerStream::onLocalComplete() {
+  local_complete_ = true;
+  if (remote_complete_) {
+    finish();
+  }
+}
+
+void SharedConnPool::OwnerStream::onRemoteComplete() {
+  remote_complete_ = true;
+  if (local_complete_) {
+    finish();
+  }
+}
+
+void SharedConnPool::OwnerStream::finish() {
+  if (self_ == nullptr) {
+    return;
+  }
+
+  worker_.reset();
+  encoder_ = nullptr;
+  cancellable_ = nullptr;
+  dispatcher_->deferredDelete(std::make_unique<DeferredRelease>(std::move(self_)));
+}
+
+void SharedConnPool::OwnerStream::decode100ContinueHeaders(HeaderMapPtr&& headers) {
+  std::shared_ptr<HeaderMapPtr> holder = std::make_shared<HeaderMapPtr>(std::move(headers));
+  postToWorker([holder](WorkerStream& worker) -> void {
+    if (worker.active()) {
+      worker.decoder_->decode100ContinueHeaders(std::move(*holder));
+    }
+  });
+}
+
+void SharedConnPool::OwnerStream::decodeHeaders(HeaderMapPtr&& headers, bool end_stream) {
+  std::shared_ptr<HeaderMapPtr> holder = std::make_shared<HeaderMapPtr>(std::move(headers));
+  postToWorker([holder, end_stream](WorkerStream& worker) -> void {
+    if (worker.active()) {
+      worker.decoder_->decodeHeaders(std::move(*holder), end_stream);
+      if (end_stream) {
+        worker.onRemoteComplete();
+      }
+    }
+  });
+
+  if (end_stream) {
+    onRemoteComplete();
+  }
+}
+
+void SharedConnPool::OwnerStream::decodeData(Buffer::Instance& data, bool end_stream) {
+  std::shared_ptr<Buffer::OwnedImpl> buffer = std::make_shared<Buffer::OwnedImpl>();
+  buffer->move(data);
+  postToWorker([buffer, end_stream](WorkerStream& worker) -> void {
+    if (worker.active()) {
+      worker.decoder_->decodeData(*buffer, end_stream);
+      if (end_stream) {
+        worker.onRemoteComplete();
+      }
+    }
+  });
+
+  if (end_stream) {
+    onRemoteComplete();
+  }
+}
+
+void SharedConnPool::OwnerStream::decodeTrailers(HeaderMapPtr&& trailers) {
+  std::shared_ptr<HeaderMapPtr> holder = std::make_shared<HeaderMapPtr>(std::move(trailers));
+  postToWorker([holder](WorkerStream& worker) -> void {
+    if (worker.active()) {
+      worker.decoder_->decodeTrailers(std::move(*holder));
+      worker.onRemoteComplete();
+    }
+  });
+
+  onRemoteComplete();
+}
+
+void SharedConnPool::OwnerStream::decodeMetadata(MetadataMapPtr&& metadata_map) {
+  std::shared_ptr<MetadataMapPtr> holder = std::make_shared<MetadataMapPtr>(std::move(metadata_map));
+  postToWorker([holder](WorkerStream& worker) -> void {
+    if (worker.active()) {
+      worker.decoder_->decodeMetadata(std::move(*holder));
+    }
+  });
+}
+
+void SharedConnPool::OwnerStream::onResetStream(StreamResetReason reason, absl::string_view) {
+  postToWorker([reason](WorkerStream& worker) -> void { worker.onResetStream(reason); });
+  finish();
+}
+
+void SharedConnPool::OwnerStream::onAboveWriteBufferHighWatermark() {
+  postToWorker([](WorkerStream& worker) -> void {
+    if (worker.active()) {
+      worker.runHighWatermarkCallbacks();
+    }
+  });
+}
+
+void SharedConnPool::OwnerStream::onBelowWriteBufferLowWatermark() {
+  postToWorker([](WorkerStream& worker) -> void {
+    if (worker.active()) {
+      worker.runLowWatermarkCallbacks();
+    }
+  });
+}
+
+void SharedConnPool::OwnerStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                                absl::string_view transport_failure_reason,
+                                                Upstream::HostDescriptionConstSharedPtr host) {
+  const std::string failure_reason(transport_failure_reason);
+  postToWorker([reason, failure_reason, host](WorkerStream& worker) -> void {
+    worker.onPoolFailure(reason, failure_reason, host);
+  });
+  finish();
+}
+
+void SharedConnPool::OwnerStream::onPoolReady(StreamEncoder& encoder,
+                                              Upstream::HostDescriptionConstSharedPtr host) {
+  cancellable_ = nullptr;
+  encoder_ = &encoder;
+  encoder.getStream().addCallbacks(*this);
+
+  const uint32_t buffer_limit = encoder.getStream().bufferLimit();
+  postToWorker([host, buffer_limit](WorkerStream& worker) -> void {
+    worker.onPoolReady(host, buffer_limit);
+  });
+}
+
+void SharedConnPool::WorkerStream::postToOwner(std::function<void(OwnerStream&)> cb) {
+  if (owner_ != nullptr) {
+    OwnerStreamSharedPtr owner = owner_;
+    owner_handle_->post([owner, cb]() -> void { cb(*owner); });
+  }
+}
+
+void SharedConnPool::WorkerStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                                 const std::string& transport_failure_reason,
+                                                 Upstream::HostDescriptionConstSharedPtr host) {
+  if (!active()) {
+    return;
+  }
+
+  ConnectionPool::Callbacks& callbacks = *callbacks_;
+  finish();
+  callbacks.onPoolFailure(reason, transport_failure_reason, host);
+}
+
+void SharedConnPool::WorkerStream::onPoolReady(Upstream::HostDescriptionConstSharedPtr host,
+                                               uint32_t buffer_limit) {
+  if (!active()) {
+    return;
+  }
+
+  ready_ = true;
+  buffer_limit_ = buffer_limit;
+  callbacks_->onPoolReady(*this, host);
+}
+
+void SharedConnPool::WorkerStream::onResetStream(StreamResetReason reason) {
+  if (!active()) {
+    return;
+  }
+
+  finish();
+  runResetCallbacks(reason);
+}
+
+void SharedConnPool::WorkerStream::onRemoteComplete() {
+  // The decoder may have reset the stream while handling the end of the response.
+  remote_complete_ = true;
+  if (active() && local_end_stream_) {
+    finish();
+  }
+}
+
+void SharedConnPool::WorkerStream::onPoolDestroyed() {
+  if (ready_) {
+    detach(StreamResetReason::LocalReset);
+    runResetCallbacks(StreamResetReason::ConnectionTermination);
+  } else {
+    ConnectionPool::Callbacks& callbacks = *callbacks_;
+    detach(StreamResetReason::LocalReset);
+    callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::ConnectionFailure, "", nullptr);
+  }
+}
+
+void SharedConnPool::WorkerStream::detach(StreamResetReason reason) {
+  if (!active()) {
+    return;
+  }
+
+  postToOwner([reason](OwnerStream& owner) -> void { owner.abandon(reason); });
+  finish();
+}
+
+void SharedConnPool::WorkerStream::finish() {
+  ASSERT(active());
+  SharedConnPool& parent = *parent_;
+  parent_ = nullptr;
+  decoder_ = nullptr;
+  callbacks_ = nullptr;
+  owner_.reset();
+  parent.onStreamFinished(*this);
+}
+
+void SharedConnPool::WorkerStream::encode100ContinueHeaders(const HeaderMap&) {
+  // Only a server side response encoder encodes 100-continue headers.
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void SharedConnPool::WorkerStream::encodeHeaders(const HeaderMap& headers, bool end_stream) {
+  ASSERT(active());
+  std::shared_ptr<HeaderMapPtr> holder =
+      std::make_shared<HeaderMapPtr>(std::make_unique<HeaderMapImpl>(headers));
+  postToOwner([holder, end_stream](OwnerStream& owner) -> void {
+    owner.encodeHeaders(**holder, end_stream);
+  });
+
+  if (end_stream) {
+    local_end_stream_ = true;
+    if (remote_complete_) {
+      finish();
+    }
+  }
+}
+
+void SharedConnPool::WorkerStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  ASSERT(active());
+  std::shared_ptr<Buffer::OwnedImpl> buffer = std::make_shared<Buffer::OwnedImpl>();
+  buffer->move(data);
+  postToOwner(
+      [buffer, end_stream](OwnerStream& owner) -> void { owner.encodeData(*buffer, end_stream); });
+
+  if (end_stream) {
+    local_end_stream_ = true;
+    if (remote_complete_) {
+      finish();
+    }
+  }
+}
+
+void SharedConnPool::WorkerStream::encodeTrailers(const HeaderMap& trailers) {
+  ASSERT(active());
+  std::shared_ptr<HeaderMapPtr> holder =
+      std::make_shared<HeaderMapPtr>(std::make_unique<HeaderMapImpl>(trailers));
+  postToOwner([holder](OwnerStream& owner) -> void { owner.encodeTrailers(**holder); });
+
+  local_end_stream_ = true;
+  if (remote_complete_) {
+    finish();
+  }
+}
+
+void SharedConnPool::WorkerStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  ASSERT(active());
+  std::shared_ptr<MetadataMapVector> copy = std::make_shared<MetadataMapVector>();
+  for (const MetadataMapPtr& metadata_map : metadata_map_vector) {
+    copy->push_back(std::make_unique<MetadataMap>(*metadata_map));
+  }
+  postToOwner([copy](OwnerStream& owner) -> void { owner.encodeMetadata(*copy); });
+}
+
+void SharedConnPool::WorkerStream::resetStream(StreamResetReason reason) {
+  if (!active()) {
+    return;
+  }
+
+  detach(reason);
+  runResetCallbacks(reason);
+}
+
+void SharedConnPool::WorkerStream::readDisable(bool disable) {
+  postToOwner([disable](OwnerStream& owner) -> void { owner.readDisable(disable); });
+}
+
+void SharedConnPool::WorkerStream::cancel() { detach(StreamResetReason::LocalReset); }
+
+SharedConnPoolManager::SharedConnPoolManager(Api::Api& api, ThreadLocal::Instance& tls,
+                                             uint32_t num_threads)
+    : tls_(tls) {
+  ASSERT(num_threads > 0);
+  for (uint32_t i = 0; i < num_threads; i++) {
+    auto thread = std::make_unique<OwnerThread>();
+    thread->dispatcher_ = api.allocateDispatcher();
+    thread->handle_ = std::make_shared<DispatcherHandle>(*thread->dispatcher_);
+    tls_.registerThread(*thread->dispatcher_, false);
+    OwnerThread& owner_thread = *thread;
+    thread->thread_ = api.threadFactory().createThread(
+        [this, &owner_thread]() -> void { threadRoutine(owner_thread); });
+    threads_.push_back(std::move(thread));
+  }
+}
+
+SharedConnPoolManager::~SharedConnPoolManager() { shutdown(); }
+
+ConnectionPool::InstancePtr
+SharedConnPoolManager::createPool(Event::Dispatcher& dispatcher,
+                                  const Upstream::HostConstSharedPtr& host,
+                                  Upstream::ResourcePriority priority,
+                                  const std::vector<uint8_t>& hash_key,
+                                  SharedConnPool::OwnerPool::PoolFactory factory) {
+  Thread::LockGuard lock(mutex_);
+  const PoolKey key{host.get(), priority, hash_key};
+  SharedConnPool::OwnerPoolRefSharedPtr owner;
+  auto it = pools_.find(key);
+  if (it != pools_.end()) {
+    owner = it->second.lock();
+  }
+
+  if (owner == nullptr) {
+    // The factory holds a reference to the host, so the host address in the key cannot be reused
+    // while the pool exists.
+    OwnerThread& thread = nextThread();
+    thread.pools_.emplace_back(
+        std::make_unique<SharedConnPool::OwnerPool>(*thread.dispatcher_, std::move(factory)));
+    auto pool = std::prev(thread.pools_.end());
+    owner = std::make_shared<SharedConnPool::OwnerPoolRef>(
+        thread.handle_, **pool,
+        [this, &thread, pool, key]() -> void { releasePool(thread, pool, key); });
+    pools_[key] = owner;
+  }
+
+  return std::make_unique<SharedConnPool>(dispatcher, owner);
+}
+
+void SharedConnPoolManager::shutdown() {
+  {
+    Thread::LockGuard lock(mutex_);
+    if (shutdown_) {
+      return;
+    }
+    shutdown_ = true;
+  }
+
+  for (const auto& thread : threads_) {
+    // Once the handle is reset nothing else can be posted, so this is the last callback the thread
+    // runs.
+    thread->handle_->reset();
+    OwnerThread* owner_thread = thread.get();
+    thread->dispatcher_->post([this, owner_thread]() -> void {
+      std::list<std::unique_ptr<SharedConnPool::OwnerPool>> pools;
+      {
+        Thread::LockGuard lock(mutex_);
+        pools.swap(owner_thread->pools_);
+      }
+      pools.clear();
+      owner_thread->dispatcher_->clearDeferredDeleteList();
+      owner_thread->dispatcher_->exit();
+    });
+  }
+
+  for (const auto& thread : threads_) {
+    thread->thread_->join();
+    thread->thread_.reset();
+  }
+}
+
+void SharedConnPoolManager::threadRoutine(OwnerThread& thread) {
+  ENVOY_LOG(debug, "shared connection pool thread entering dispatch loop");
+  thread.dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  ENVOY_LOG(debug, "shared connection pool thread exited dispatch loop");
+
+  // Stats of the destroyed pools are cached in thread local storage, which must be destroyed on
+  // this thread.
+  tls_.shutdownThread();
+}
+
+SharedConnPoolManager::OwnerThread& SharedConnPoolManager::nextThread() {
+  // Once shut down the handles of all threads are reset, so streams on pools created afterwards
+  // fail immediately.
+  return *threads_[next_thread_++ % threads_.size()];
+}
+
+void SharedConnPoolManager::releasePool(
+    OwnerThread& thread, std::list<std::unique_ptr<SharedConnPool::OwnerPool>>::iterator pool,
+    const PoolKey& key) {
+  std::unique_ptr<SharedConnPool::OwnerPool> released;
+  {
+    Thread::LockGuard lock(mutex_);
+    released = std::move(*pool);
+    thread.pools_.erase(pool);
+    // A new pool may have been created for the same key since the last reference was dropped.
+    auto it = pools_.find(key);
+    if (it != pools_.end() && it->second.expired()) {
+      pools_.erase(it);
+    }
+  }
+
+  // Closing connections may take a while, so do it outside of the lock.
+  released.reset();
+}
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
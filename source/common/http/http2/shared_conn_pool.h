@@ -0,0 +1,318 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/codec.h"
+#include "envoy/http/conn_pool.h"
+#include "envoy/thread/thread.h"
+#include "envoy/thread_local/thread_local.h"
+#include "envoy/upstream/upstream.h"
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+#include "common/http/codec_helper.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+/**
+ * Posts callbacks to a dispatcher that may be torn down by its owner at any time. Once reset(),
+ * posted callbacks are dropped on the posting thread instead of being run.
+ */
+class DispatcherHandle {
+public:
+  explicit DispatcherHandle(Event::Dispatcher& dispatcher) : dispatcher_(&dispatcher) {}
+
+  /**
+   * Post a callback to the dispatcher.
+   * @return bool whether the callback was posted. If false the callback has been dropped.
+   */
+  bool post(Event::PostCb callback);
+
+  /**
+   * Stop accepting callbacks. Callbacks posted before this call will still run.
+   */
+  void reset();
+
+private:
+  Thread::MutexBasicLockable mutex_;
+  Event::Dispatcher* dispatcher_ GUARDED_BY(mutex_);
+};
+
+typedef std::shared_ptr<DispatcherHandle> DispatcherHandleSharedPtr;
+
+class SharedConnPoolManager;
+
+/**
+ * Worker side of a connection pool that is owned by one of the SharedConnPoolManager threads.
+ * Every stream is handed off to the owning thread, and all encoder, decoder and stream events are
+ * marshalled between the worker and owner dispatchers. This allows all workers to multiplex their
+ * streams over the same upstream HTTP/2 connection at the cost of two thread hops per event.
+ */
+class SharedConnPool : public ConnectionPool::Instance, Logger::Loggable<Logger::Id::pool> {
+public:
+  /**
+   * Pool owned by a shared connection thread. All members are only accessed on that thread.
+   */
+  class OwnerPool {
+  public:
+    typedef std::function<ConnectionPool::InstancePtr(Event::Dispatcher& dispatcher)> PoolFactory;
+
+    OwnerPool(Event::Dispatcher& dispatcher, PoolFactory factory)
+        : dispatcher_(dispatcher), factory_(std::move(factory)) {}
+
+    ConnectionPool::Instance& pool();
+    void drainConnections();
+    Event::Dispatcher& dispatcher() { return dispatcher_; }
+
+  private:
+    Event::Dispatcher& dispatcher_;
+    const PoolFactory factory_;
+    ConnectionPool::InstancePtr pool_;
+  };
+
+  /**
+   * Reference held by each worker pool for an OwnerPool. Once the last reference is released the
+   * release callback is posted to the owner thread, which destroys the OwnerPool.
+   */
+  struct OwnerPoolRef {
+    OwnerPoolRef(const DispatcherHandleSharedPtr& owner_handle, OwnerPool& pool,
+                 Event::PostCb release)
+        : owner_handle_(owner_handle), pool_(pool), release_(std::move(release)) {}
+    ~OwnerPoolRef() { owner_handle_->post(release_); }
+
+    const DispatcherHandleSharedPtr owner_handle_;
+    OwnerPool& pool_;
+    const Event::PostCb release_;
+  };
+
+  typedef std::shared_ptr<OwnerPoolRef> OwnerPoolRefSharedPtr;
+
+  SharedConnPool(Event::Dispatcher& dispatcher, OwnerPoolRefSharedPtr owner);
+  ~SharedConnPool();
+
+  // ConnectionPool::Instance
+  Http::Protocol protocol() const override { return Http::Protocol::Http2; }
+  void addDrainedCallback(DrainedCb cb) override;
+  void drainConnections() override;
+  void prewarm() override;
+  bool hasActiveConnections() const override { return !streams_.empty(); }
+  ConnectionPool::Cancellable* newStream(Http::StreamDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks) override;
+
+private:
+  struct WorkerStream;
+  typedef std::shared_ptr<WorkerStream> WorkerStreamSharedPtr;
+
+  /**
+   * Owner thread half of a stream. It is the decoder and pool callbacks for the real pool and
+   * forwards everything it receives to the worker half. All members are only accessed on the
+   * owner thread.
+   */
+  struct OwnerStream : public StreamDecoder,
+                       public StreamCallbacks,
+                       public ConnectionPool::Callbacks,
+                       public std::enable_shared_from_this<OwnerStream> {
+    explicit OwnerStream(const DispatcherHandleSharedPtr& worker_handle)
+        : worker_handle_(worker_handle) {}
+
+    void start(OwnerPool& pool, const WorkerStreamSharedPtr& worker);
+    void postToWorker(std::function<void(WorkerStream&)> cb);
+    // Resets the stream, or cancels it if it is still waiting for a connection, on behalf of the
+    // worker.
+    void abandon(StreamResetReason reason);
+    void encodeHeaders(const HeaderMap& headers, bool end_stream);
+    void encodeData(Buffer::Instance& data, bool end_stream);
+    void encodeTrailers(const HeaderMap& trailers);
+    void encodeMetadata(const MetadataMapVector& metadata_map_vector);
+    void readDisable(bool disable);
+    void onLocalComplete();
+    void onRemoteComplete();
+    void finish();
+
+    // Http::StreamDecoder
+    void decode100ContinueHeaders(HeaderMapPtr&& headers) override;
+    void decodeHeaders(HeaderMapPtr&& headers, bool end_stream) override;
+    void decodeData(Buffer::Instance& data, bool end_stream) override;
+    void decodeTrailers(HeaderMapPtr&& trailers) override;
+    void decodeMetadata(MetadataMapPtr&& metadata_map) override;
+
+    // Http::StreamCallbacks
+    void onResetStream(StreamResetReason reason,
+                       absl::string_view transport_failure_reason) override;
+    void onAboveWriteBufferHighWatermark() override;
+    void onBelowWriteBufferLowWatermark() override;
+
+    // Http::ConnectionPool::Callbacks
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       absl::string_view transport_failure_reason,
+                       Upstream::HostDescriptionConstSharedPtr host) override;
+    void onPoolReady(StreamEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host) override;
+
+    const DispatcherHandleSharedPtr worker_handle_;
+    Event::Dispatcher* dispatcher_{};
+    // Keeps this alive while the real pool or codec may still call back into it.
+    std::shared_ptr<OwnerStream> self_;
+    WorkerStreamSharedPtr worker_;
+    ConnectionPool::Cancellable* cancellable_{};
+    StreamEncoder* encoder_{};
+    bool local_complete_{};
+    bool remote_complete_{};
+  };
+
+  typedef std::shared_ptr<OwnerStream> OwnerStreamSharedPtr;
+
+  /**
+   * Worker thread half of a stream. This is the encoder handed to the caller. All members are only
+   * accessed on the worker thread.
+   */
+  struct WorkerStream : public StreamEncoder,
+                        public Stream,
+                        public StreamCallbackHelper,
+                        public ConnectionPool::Cancellable,
+                        public std::enable_shared_from_this<WorkerStream> {
+    WorkerStream(SharedConnPool& parent, StreamDecoder& decoder,
+                 ConnectionPool::Callbacks& callbacks)
+        : parent_(&parent), decoder_(&decoder), callbacks_(&callbacks),
+          owner_handle_(parent.owner_->owner_handle_) {}
+
+    void postToOwner(std::function<void(OwnerStream&)> cb);
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       const std::string& transport_failure_reason,
+                       Upstream::HostDescriptionConstSharedPtr host);
+    void onPoolReady(Upstream::HostDescriptionConstSharedPtr host, uint32_t buffer_limit);
+    void onResetStream(StreamResetReason reason);
+    void onRemoteComplete();
+    // Notifies the caller that the stream failed because the parent pool is being destroyed.
+    void onPoolDestroyed();
+    // Abandons the stream on the owner thread and finishes it.
+    void detach(StreamResetReason reason);
+    void finish();
+    bool active() const { return parent_ != nullptr; }
+
+    // Http::StreamEncoder
+    void encode100ContinueHeaders(const HeaderMap& headers) override;
+    void encodeHeaders(const HeaderMap& headers, bool end_stream) override;
+    void encodeData(Buffer::Instance& data, bool end_stream) override;
+    void encodeTrailers(const HeaderMap& trailers) override;
+    Stream& getStream() override { return *this; }
+    void encodeMetadata(const MetadataMapVector& metadata_map_vector) override;
+
+    // Http::Stream
+    void addCallbacks(StreamCallbacks& callbacks) override { addCallbacks_(callbacks); }
+    void removeCallbacks(StreamCallbacks& callbacks) override { removeCallbacks_(callbacks); }
+    void resetStream(StreamResetReason reason) override;
+    void readDisable(bool disable) override;
+    uint32_t bufferLimit() override { return buffer_limit_; }
+
+    // Http::ConnectionPool::Cancellable
+    void cancel() override;
+
+    // Cleared once the stream is finished or the parent pool is destroyed.
+    SharedConnPool* parent_;
+    StreamDecoder* decoder_;
+    ConnectionPool::Callbacks* callbacks_;
+    const DispatcherHandleSharedPtr owner_handle_;
+    OwnerStreamSharedPtr owner_;
+    std::list<WorkerStreamSharedPtr>::iterator entry_;
+    uint32_t buffer_limit_{};
+    bool ready_{};
+    bool remote_complete_{};
+  };
+
+  /**
+   * Releases a finished stream half on the next dispatcher iteration, since the codec or the caller
+   * may still reference it in the current call stack.
+   */
+  struct DeferredRelease : public Event::DeferredDeletable {
+    explicit DeferredRelease(std::shared_ptr<void>&& object) : object_(std::move(object)) {}
+
+    std::shared_ptr<void> object_;
+  };
+
+  void postToOwnerPool(std::function<void(OwnerPool&)> cb);
+  void onStreamFinished(WorkerStream& stream);
+  void checkForDrained();
+
+  Event::Dispatcher& dispatcher_;
+  const DispatcherHandleSharedPtr worker_handle_;
+  const OwnerPoolRefSharedPtr owner_;
+  std::list<WorkerStreamSharedPtr> streams_;
+  std::list<DrainedCb> drained_callbacks_;
+};
+
+/**
+ * Owns the threads that upstream connections of shared HTTP/2 connection pools live on, and the
+ * pools themselves. Pools are keyed by host, priority and the same hash key used for worker local
+ * pools, so that all workers asking for the same pool share its connections.
+ *
+ * Like workers, the threads are registered for thread local updates, since the pools they own
+ * record stats. The manager must therefore be created on the main thread before any thread local
+ * slots are set.
+ */
+class SharedConnPoolManager : Logger::Loggable<Logger::Id::pool> {
+public:
+  SharedConnPoolManager(Api::Api& api, ThreadLocal::Instance& tls, uint32_t num_threads);
+  ~SharedConnPoolManager();
+
+  /**
+   * Create a worker local pool that hands its streams off to the shared pool for the given key,
+   * allocating the shared pool with the supplied factory on its owning thread if needed.
+   * @param dispatcher supplies the calling worker's dispatcher.
+   */
+  ConnectionPool::InstancePtr createPool(Event::Dispatcher& dispatcher,
+                                         const Upstream::HostConstSharedPtr& host,
+                                         Upstream::ResourcePriority priority,
+                                         const std::vector<uint8_t>& hash_key,
+                                         SharedConnPool::OwnerPool::PoolFactory factory);
+
+  /**
+   * Stop all threads, closing any connections they own. Must be called on the main thread after
+   * workers have stopped and global threading has been shut down. Pools created afterwards will
+   * fail all of their streams.
+   */
+  void shutdown();
+
+private:
+  struct OwnerThread {
+    Event::DispatcherPtr dispatcher_;
+    DispatcherHandleSharedPtr handle_;
+    Thread::ThreadPtr thread_;
+    // Guarded by the manager's mutex_. Pools are only used and destroyed on the owning thread.
+    std::list<std::unique_ptr<SharedConnPool::OwnerPool>> pools_;
+  };
+
+  typedef std::tuple<const Upstream::Host*, Upstream::ResourcePriority, std::vector<uint8_t>>
+      PoolKey;
+
+  void threadRoutine(OwnerThread& thread);
+  OwnerThread& nextThread() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void releasePool(OwnerThread& thread,
+                   std::list<std::unique_ptr<SharedConnPool::OwnerPool>>::iterator pool,
+                   const PoolKey& key);
+
+  ThreadLocal::Instance& tls_;
+  Thread::MutexBasicLockable mutex_;
+  // Created in the constructor and never changed, only the pools of each thread are guarded.
+  std::vector<std::unique_ptr<OwnerThread>> threads_;
+  uint64_t next_thread_ GUARDED_BY(mutex_){};
+  std::map<PoolKey, std::weak_ptr<SharedConnPool::OwnerPoolRef>> pools_ GUARDED_BY(mutex_);
+  bool shutdown_ GUARDED_BY(mutex_){};
+};
+
+typedef std::unique_ptr<SharedConnPoolManager> SharedConnPoolManagerPtr;
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
@@ -1,5 +1,7 @@
 #include "common/runtime/runtime_impl.h"
 
+#include <sys/stat.h>
+
 #include <cstdint>
 #include <random>
 #include <string>
@@ -9,8 +11,10 @@
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/type/percent.pb.validate.h"
 
+#include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
 #include "common/common/utility.h"
 #include "common/filesystem/directory.h"
 #include "common/protobuf/utility.h"
@@ -156,6 +160,18 @@ std::string RandomGeneratorImpl::uuid() {
   return std::string(uuid, UUID_LENGTH);
 }
 
+KeyRegistry& KeyRegistry::get() {
+  // Intentionally leaked, as handles may be registered by statically constructed objects.
+  static KeyRegistry* registry = new KeyRegistry();
+  return *registry;
+}
+
+KeyHandle KeyRegistry::registerKey(const std::string& key) {
+  Thread::LockGuard lock(mutex_);
+  const uint32_t index = indexes_.emplace(key, indexes_.size()).first->second;
+  return KeyHandle(key, index);
+}
+
 bool SnapshotImpl::deprecatedFeatureEnabled(const std::string& key) const {
   bool allowed = false;
   // If the value is not explicitly set as a runtime boolean, the default value is based on
@@ -187,19 +203,12 @@ bool SnapshotImpl::runtimeFeatureEnabled(absl::string_view key) const {
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value,
                                   uint64_t random_value, uint64_t num_buckets) const {
-  return random_value % num_buckets < std::min(getInteger(key, default_value), num_buckets);
+  return random_value % num_buckets <
+         std::min(entryInteger(findEntry(key), default_value), num_buckets);
 }
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value) const {
-  // Avoid PRNG if we know we don't need it.
-  uint64_t cutoff = std::min(getInteger(key, default_value), static_cast<uint64_t>(100));
-  if (cutoff == 0) {
-    return false;
-  } else if (cutoff == 100) {
-    return true;
-  } else {
-    return generator_.random() % 100 < cutoff;
-  }
+  return entryFeatureEnabled(findEntry(key), default_value);
 }
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value,
@@ -224,22 +233,112 @@ bool SnapshotImpl::featureEnabled(const std::string& key,
 bool SnapshotImpl::featureEnabled(const std::string& key,
                                   const envoy::type::FractionalPercent& default_value,
                                   uint64_t random_value) const {
-  const auto& entry = values_.find(key);
+  return entryFeatureEnabled(findEntry(key), default_value, random_value);
+}
+
+uint64_t SnapshotImpl::getInteger(const std::string& key, uint64_t default_value) const {
+  return entryInteger(findEntry(key), default_value);
+}
+
+bool SnapshotImpl::featureEnabled(const KeyHandle& key, uint64_t default_value) const {
+  return entryFeatureEnabled(findEntry(key), default_value);
+}
+
+bool SnapshotImpl::featureEnabled(const KeyHandle& key, uint64_t default_value,
+                                  uint64_t random_value) const {
+  return featureEnabled(key, default_value, random_value, 100);
+}
+
+bool SnapshotImpl::featureEnabled(const KeyHandle& key, uint64_t default_value,
+                                  uint64_t random_value, uint64_t num_buckets) const {
+  return random_value % num_buckets <
+         std::min(entryInteger(findEntry(key), default_value), num_buckets);
+}
+
+bool SnapshotImpl::featureEnabled(const KeyHandle& key,
+                                  const envoy::type::FractionalPercent& default_value) const {
+  return entryFeatureEnabled(findEntry(key), default_value, generator_.random());
+}
+
+bool SnapshotImpl::featureEnabled(const KeyHandle& key,
+                                  const envoy::type::FractionalPercent& default_value,
+                                  uint64_t random_value) const {
+  return entryFeatureEnabled(findEntry(key), default_value, random_value);
+}
+
+uint64_t SnapshotImpl::getInteger(const KeyHandle& key, uint64_t default_value) const {
+  return entryInteger(findEntry(key), default_value);
+}
+
+const Snapshot::Entry* SnapshotImpl::findEntry(const std::string& key) const {
+  auto entry = values_.find(key);
+  return entry == values_.end() ? nullptr : &entry->second;
+}
+
+const Snapshot::Entry* SnapshotImpl::findEntry(const KeyHandle& key) const {
+  const uint32_t chunk_index = key.index() / KeysPerChunk;
+  if (chunk_index >= MaxChunks) {
+    return findEntry(key.name());
+  }
+
+  ResolvedChunk& resolved = resolvedChunk(chunk_index)[key.index() % KeysPerChunk];
+  const Entry* entry = resolved.load(std::memory_order_acquire);
+  if (entry == nullptr) {
+    entry = findEntry(key.name());
+    if (entry == nullptr) {
+      entry = &unset_entry_;
+    }
+    resolved.store(entry, std::memory_order_release);
+  }
+  return entry == &unset_entry_ ? nullptr : entry;
+}
+
+SnapshotImpl::ResolvedChunk* SnapshotImpl::resolvedChunk(uint32_t index) const {
+  ResolvedChunk* chunk = resolved_keys_[index].load(std::memory_order_acquire);
+  if (chunk != nullptr) {
+    return chunk;
+  }
+
+  // Several threads may race to allocate a chunk, in which case the losers free their allocation
+  // and use the winner's.
+  ResolvedChunk* new_chunk = new ResolvedChunk[KeysPerChunk]();
+  if (resolved_keys_[index].compare_exchange_strong(chunk, new_chunk, std::memory_order_acq_rel)) {
+    return new_chunk;
+  }
+  delete[] new_chunk;
+  return chunk;
+}
+
+bool SnapshotImpl::entryFeatureEnabled(const Entry* entry, uint64_t default_value) const {
+  // Avoid PRNG if we know we don't need it.
+  uint64_t cutoff = std::min(entryInteger(entry, default_value), static_cast<uint64_t>(100));
+  if (cutoff == 0) {
+    return false;
+  } else if (cutoff == 100) {
+    return true;
+  } else {
+    return generator_.random() % 100 < cutoff;
+  }
+}
+
+bool SnapshotImpl::entryFeatureEnabled(const Entry* entry,
+                                       const envoy::type::FractionalPercent& default_value,
+                                       uint64_t random_value) {
   envoy::type::FractionalPercent percent;
-  if (entry != values_.end() && entry->second.fractional_percent_value_.has_value()) {
-    percent = entry->second.fractional_percent_value_.value();
-  } else if (entry != values_.end() && entry->second.uint_value_.has_value()) {
+  if (entry != nullptr && entry->fractional_percent_value_.has_value()) {
+    percent = entry->fractional_percent_value_.value();
+  } else if (entry != nullptr && entry->uint_value_.has_value()) {
     // Check for > 100 because the runtime value is assumed to be specified as
     // an integer, and it also ensures that truncating the uint64_t runtime
     // value into a uint32_t percent numerator later is safe
-    if (entry->second.uint_value_.value() > 100) {
+    if (entry->uint_value_.value() > 100) {
       return true;
     }
 
     // The runtime value was specified as an integer rather than a fractional
     // percent proto. To preserve legacy semantics, we treat it as a percentage
     // (i.e. denominator of 100).
-    percent.set_numerator(entry->second.uint_value_.value());
+    percent.set_numerator(entry->uint_value_.value());
     percent.set_denominator(envoy::type::FractionalPercent::HUNDRED);
   } else {
     percent = default_value;
@@ -248,15 +347,6 @@ bool SnapshotImpl::featureEnabled(const std::string& key,
   return ProtobufPercentHelper::evaluateFractionalPercent(percent, random_value);
 }
 
-uint64_t SnapshotImpl::getInteger(const std::string& key, uint64_t default_value) const {
-  auto entry = values_.find(key);
-  if (entry == values_.end() || !entry->second.uint_value_) {
-    return default_value;
-  } else {
-    return entry->second.uint_value_.value();
-  }
-}
-
 bool SnapshotImpl::getBoolean(absl::string_view key, bool& value) const {
   auto entry = values_.find(key);
   if (entry != values_.end() && entry->second.bool_value_.has_value()) {
@@ -282,6 +372,12 @@ SnapshotImpl::SnapshotImpl(RandomGenerator& generator, RuntimeStats& stats,
   stats.num_keys_.set(values_.size());
 }
 
+SnapshotImpl::~SnapshotImpl() {
+  for (std::atomic<ResolvedChunk*>& chunk : resolved_keys_) {
+    delete[] chunk.load();
+  }
+}
+
 SnapshotImpl::Entry SnapshotImpl::createEntry(const std::string& value) {
   Entry entry;
   entry.raw_string_value_ = value;
@@ -342,13 +438,53 @@ void AdminLayer::mergeValues(const std::unordered_map<std::string, std::string>&
   stats_.admin_overrides_active_.set(values_.empty() ? 0 : 1);
 }
 
-DiskLayer::DiskLayer(const std::string& name, const std::string& path, Api::Api& api)
+DiskLayer::DiskLayer(const std::string& name, const std::string& path, Api::Api& api,
+                     const DiskLayer* previous)
     : OverrideLayerImpl{name} {
-  walkDirectory(path, "", 1, api);
+  struct stat info;
+  if (Api::OsSysCallsSingleton::get().stat(path.c_str(), &info).rc_ == 0 &&
+      S_ISREG(info.st_mode)) {
+    if (api.fileSystem().illegalPath(path)) {
+      throw EnvoyException(fmt::format("Invalid path: {}", path));
+    }
+    packed_file_identity_ = fileIdentity(path);
+    if (previous != nullptr && previous->packed_file_identity_.has_value() &&
+        packed_file_identity_ == previous->packed_file_identity_) {
+      ENVOY_LOG(debug, "reusing unchanged packed file: {}", path);
+      values_ = previous->values_;
+      return;
+    }
+    loadPackedFile(path, api);
+    return;
+  }
+
+  walkDirectory(path, "", 1, api, previous);
+}
+
+namespace {
+
+int64_t timespecToNanoseconds(const struct timespec& ts) {
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+} // namespace
+
+absl::optional<DiskLayer::FileIdentity> DiskLayer::fileIdentity(const std::string& path) {
+  struct stat info;
+  if (Api::OsSysCallsSingleton::get().stat(path.c_str(), &info).rc_ != 0) {
+    return absl::nullopt;
+  }
+#if defined(__APPLE__)
+  const struct timespec& mtime = info.st_mtimespec;
+#else
+  const struct timespec& mtime = info.st_mtim;
+#endif
+  return FileIdentity{static_cast<uint64_t>(info.st_dev), static_cast<uint64_t>(info.st_ino),
+                      static_cast<int64_t>(info.st_size), timespecToNanoseconds(mtime)};
 }
 
 void DiskLayer::walkDirectory(const std::string& path, const std::string& prefix, uint32_t depth,
-                              Api::Api& api) {
+                              Api::Api& api, const DiskLayer* previous) {
   ENVOY_LOG(debug, "walking directory: {}", path);
   if (depth > MaxWalkDepth) {
     throw EnvoyException(fmt::format("Walk recursion depth exceeded {}", MaxWalkDepth));
@@ -370,35 +506,82 @@ void DiskLayer::walkDirectory(const std::string& path, const std::string& prefix
 
     if (entry.type_ == Filesystem::FileType::Directory && entry.name_ != "." &&
         entry.name_ != "..") {
-      walkDirectory(full_path, full_prefix, depth + 1, api);
+      walkDirectory(full_path, full_prefix, depth + 1, api, previous);
     } else if (entry.type_ == Filesystem::FileType::Regular) {
-      // Suck the file into a string. This is not very efficient but it should be good enough
-      // for small files. Also, as noted elsewhere, none of this is non-blocking which could
-      // theoretically lead to issues.
-      ENVOY_LOG(debug, "reading file: {}", full_path);
-      std::string value;
-
-      // Read the file and remove any comments. A comment is a line starting with a '#' character.
-      // Comments are useful for placeholder files with no value.
-      const std::string text_file{api.fileSystem().fileReadToEnd(full_path)};
-      const auto lines = StringUtil::splitToken(text_file, "\n");
-      for (const auto line : lines) {
-        if (!line.empty() && line.front() == '#') {
-          continue;
-        }
-        if (line == lines.back()) {
-          const absl::string_view trimmed = StringUtil::rtrim(line);
-          value.append(trimmed.data(), trimmed.size());
-        } else {
-          value.append(std::string{line} + "\n");
-        }
+      loadFile(full_path, full_prefix, api, previous);
+    }
+  }
+}
+
+void DiskLayer::loadFile(const std::string& path, const std::string& key, Api::Api& api,
+                         const DiskLayer* previous) {
+  const absl::optional<FileIdentity> identity = fileIdentity(path);
+  if (identity.has_value()) {
+    file_identities_.erase(key);
+    file_identities_.emplace(key, identity.value());
+
+    if (previous != nullptr) {
+      const auto previous_identity = previous->file_identities_.find(key);
+      const auto previous_value = previous->values_.find(key);
+      if (previous_identity != previous->file_identities_.end() &&
+          previous_identity->second == identity.value() &&
+          previous_value != previous->values_.end()) {
+        values_.erase(key);
+        values_.insert(*previous_value);
+        return;
       }
-      // Separate erase/insert calls required due to the value type being constant; this prevents
-      // the use of the [] operator. Can leverage insert_or_assign in C++17 in the future.
-      values_.erase(full_prefix);
-      values_.insert({full_prefix, SnapshotImpl::createEntry(value)});
     }
   }
+
+  // Suck the file into a string. This is not very efficient but it should be good enough
+  // for small files. Also, as noted elsewhere, none of this is non-blocking which could
+  // theoretically lead to issues.
+  ENVOY_LOG(debug, "reading file: {}", path);
+  std::string value;
+
+  // Read the file and remove any comments. A comment is a line starting with a '#' character.
+  // Comments are useful for placeholder files with no value.
+  const std::string text_file{api.fileSystem().fileReadToEnd(path)};
+  const auto lines = StringUtil::splitToken(text_file, "\n");
+  for (const auto line : lines) {
+    if (!line.empty() && line.front() == '#') {
+      continue;
+    }
+    if (line == lines.back()) {
+      const absl::string_view trimmed = StringUtil::rtrim(line);
+      value.append(trimmed.data(), trimmed.size());
+    } else {
+      value.append(std::string{line} + "\n");
+    }
+  }
+  // Separate erase/insert calls required due to the value type being constant; this prevents
+  // the use of the [] operator. Can leverage insert_or_assign in C++17 in the future.
+  values_.erase(key);
+  values_.insert({key, SnapshotImpl::createEntry(value)});
+}
+
+void DiskLayer::loadPackedFile(const std::string& path, Api::Api& api) {
+  ENVOY_LOG(debug, "reading packed file: {}", path);
+  // Each line holds a key and its value separated by the first space. As with one file per key,
+  // lines starting with a '#' character are comments, and trailing whitespace is removed.
+  const std::string text_file{api.fileSystem().fileReadToEnd(path)};
+  for (const absl::string_view line : StringUtil::splitToken(text_file, "\n")) {
+    if (line.front() == '#') {
+      continue;
+    }
+    const absl::string_view trimmed = StringUtil::rtrim(line);
+    if (trimmed.empty()) {
+      continue;
+    }
+    const size_t separator = trimmed.find(' ');
+    if (separator == 0 || separator == absl::string_view::npos) {
+      throw EnvoyException(fmt::format("Invalid line in runtime file {}: {}", path, trimmed));
+    }
+    const std::string key{trimmed.substr(0, separator)};
+    values_.erase(key);
+    values_.insert(
+        {key, SnapshotImpl::createEntry(std::string{trimmed.substr(separator + 1)})});
+  }
 }
 
 LoaderImpl::LoaderImpl(RandomGenerator& generator, Stats::Store& store,
@@ -419,7 +602,8 @@ std::unique_ptr<SnapshotImpl> LoaderImpl::createNewSnapshot() {
 }
 
 void LoaderImpl::loadNewSnapshot() {
-  ThreadLocal::ThreadLocalObjectSharedPtr ptr = createNewSnapshot();
+  std::shared_ptr<SnapshotImpl> ptr = createNewSnapshot();
+  snapshot_ = ptr;
   tls_->set([ptr = std::move(ptr)](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return ptr;
   });
@@ -457,9 +641,12 @@ RuntimeStats LoaderImpl::generateStats(Stats::Store& store) {
 std::unique_ptr<SnapshotImpl> DiskBackedLoaderImpl::createNewSnapshot() {
   std::vector<Snapshot::OverrideLayerConstPtr> layers;
   try {
-    layers.push_back(std::make_unique<DiskLayer>("root", root_path_, api_));
-    if (api_.fileSystem().directoryExists(override_path_)) {
-      layers.push_back(std::make_unique<DiskLayer>("override", override_path_, api_));
+    layers.push_back(
+        std::make_unique<DiskLayer>("root", root_path_, api_, previousDiskLayer("root")));
+    if (api_.fileSystem().directoryExists(override_path_) ||
+        api_.fileSystem().fileExists(override_path_)) {
+      layers.push_back(std::make_unique<DiskLayer>("override", override_path_, api_,
+                                                   previousDiskLayer("override")));
       stats_.override_dir_exists_.inc();
     } else {
       stats_.override_dir_not_exists_.inc();
@@ -473,5 +660,17 @@ std::unique_ptr<SnapshotImpl> DiskBackedLoaderImpl::createNewSnapshot() {
   return std::make_unique<SnapshotImpl>(generator_, stats_, std::move(layers));
 }
 
+const DiskLayer* DiskBackedLoaderImpl::previousDiskLayer(const std::string& name) const {
+  if (snapshot_ == nullptr) {
+    return nullptr;
+  }
+  for (const auto& layer : snapshot_->getLayers()) {
+    if (layer->name() == name) {
+      return dynamic_cast<const DiskLayer*>(layer.get());
+    }
+  }
+  return nullptr;
+}
+
 } // namespace Runtime
 } // namespace Envoy
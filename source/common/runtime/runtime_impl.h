@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -17,6 +19,7 @@
 #include "common/common/empty_string.h"
 #include "common/common/logger.h"
 #include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
 #include "common/singleton/threadsafe_singleton.h"
 
 #include "spdlog/spdlog.h"
@@ -41,6 +44,33 @@ public:
   static const size_t UUID_LENGTH;
 };
 
+/**
+ * Process wide registry of runtime keys that are looked up on hot paths. Registering a key assigns
+ * it a stable index, which each SnapshotImpl uses to cache where the key's value lives. Keys are
+ * never removed, so registering the same keys on each configuration reload does not grow the
+ * registry.
+ */
+class KeyRegistry {
+public:
+  /**
+   * @return KeyRegistry& the process wide registry.
+   */
+  static KeyRegistry& get();
+
+  /**
+   * Registers a key, returning a handle with the existing index if the key is already registered.
+   * @param key supplies the runtime key.
+   * @return KeyHandle a handle usable with any snapshot.
+   */
+  KeyHandle registerKey(const std::string& key);
+
+private:
+  KeyRegistry() = default;
+
+  Thread::MutexBasicLockable mutex_;
+  absl::flat_hash_map<std::string, uint32_t> indexes_ GUARDED_BY(mutex_);
+};
+
 /**
  * All runtime stats. @see stats_macros.h
  */
@@ -71,6 +101,7 @@ class SnapshotImpl : public Snapshot,
 public:
   SnapshotImpl(RandomGenerator& generator, RuntimeStats& stats,
                std::vector<OverrideLayerConstPtr>&& layers);
+  ~SnapshotImpl();
 
   // Runtime::Snapshot
   bool deprecatedFeatureEnabled(const std::string& key) const override;
@@ -86,6 +117,16 @@ public:
                       uint64_t random_value) const override;
   const std::string& get(const std::string& key) const override;
   uint64_t getInteger(const std::string& key, uint64_t default_value) const override;
+  bool featureEnabled(const KeyHandle& key, uint64_t default_value) const override;
+  bool featureEnabled(const KeyHandle& key, uint64_t default_value,
+                      uint64_t random_value) const override;
+  bool featureEnabled(const KeyHandle& key, uint64_t default_value, uint64_t random_value,
+                      uint64_t num_buckets) const override;
+  bool featureEnabled(const KeyHandle& key,
+                      const envoy::type::FractionalPercent& default_value) const override;
+  bool featureEnabled(const KeyHandle& key, const envoy::type::FractionalPercent& default_value,
+                      uint64_t random_value) const override;
+  uint64_t getInteger(const KeyHandle& key, uint64_t default_value) const override;
   const std::vector<OverrideLayerConstPtr>& getLayers() const override;
 
   static Entry createEntry(const std::string& value);
@@ -105,12 +146,36 @@ private:
     parseEntryFractionalPercentValue(entry);
   }
 
+  const Entry* findEntry(const std::string& key) const;
+  const Entry* findEntry(const KeyHandle& key) const;
+  bool entryFeatureEnabled(const Entry* entry, uint64_t default_value) const;
+  static bool entryFeatureEnabled(const Entry* entry,
+                                  const envoy::type::FractionalPercent& default_value,
+                                  uint64_t random_value);
+  static uint64_t entryInteger(const Entry* entry, uint64_t default_value) {
+    return entry != nullptr && entry->uint_value_ ? entry->uint_value_.value() : default_value;
+  }
+
   static bool parseEntryBooleanValue(Entry& entry);
   static bool parseEntryUintValue(Entry& entry);
   static void parseEntryFractionalPercentValue(Entry& entry);
 
+  static constexpr uint32_t KeysPerChunk = 256;
+  static constexpr uint32_t MaxChunks = 64;
+
+  // An entry of values_, &unset_entry_ if the key has no value or nullptr if the key has not been
+  // looked up yet. values_ is not modified after construction, so the pointers stay valid.
+  using ResolvedChunk = std::atomic<const Entry*>;
+
+  ResolvedChunk* resolvedChunk(uint32_t index) const;
+
   const std::vector<OverrideLayerConstPtr> layers_;
   EntryMap values_;
+  const Entry unset_entry_{};
+  // Results of looking up KeyHandles, indexed by KeyHandle::index(). The snapshot is shared by all
+  // threads, so chunks are allocated and filled in on first use with atomic stores; racing threads
+  // always store the same result. Keys with an index beyond the table are looked up by name.
+  mutable std::array<std::atomic<ResolvedChunk*>, MaxChunks> resolved_keys_{};
   RandomGenerator& generator_;
   RuntimeStats& stats_;
 };
@@ -155,17 +220,49 @@ private:
 };
 
 /**
- * Extension of OverrideLayerImpl that loads values from the file system upon construction.
+ * Extension of OverrideLayerImpl that loads values from the file system upon construction. The path
+ * is either a directory tree with one file per key, or a packed file with one "key value" pair per
+ * line.
  */
 class DiskLayer : public OverrideLayerImpl, Logger::Loggable<Logger::Id::runtime> {
 public:
-  DiskLayer(const std::string& name, const std::string& path, Api::Api& api);
+  /**
+   * @param previous supplies the layer loaded from the same location by the previous reload, if
+   *        any. Values of files that are unchanged since then are copied from it rather than read
+   *        and parsed again.
+   */
+  DiskLayer(const std::string& name, const std::string& path, Api::Api& api,
+            const DiskLayer* previous = nullptr);
 
 private:
+  // Identifies a version of a file. A file with the same identity as in the previous load is assumed
+  // to have the same contents, which holds for runtime trees deployed as hard linked copies. The
+  // status change time is not part of the identity, as link() updates it on every inode it links.
+  struct FileIdentity {
+    bool operator==(const FileIdentity& rhs) const {
+      return device_ == rhs.device_ && inode_ == rhs.inode_ && size_ == rhs.size_ &&
+             mtime_ == rhs.mtime_;
+    }
+
+    uint64_t device_;
+    uint64_t inode_;
+    int64_t size_;
+    // Nanoseconds since the epoch, so that rewrites within the same second are still noticed.
+    int64_t mtime_;
+  };
+
+  static absl::optional<FileIdentity> fileIdentity(const std::string& path);
   void walkDirectory(const std::string& path, const std::string& prefix, uint32_t depth,
-                     Api::Api& api);
+                     Api::Api& api, const DiskLayer* previous);
+  void loadFile(const std::string& path, const std::string& key, Api::Api& api,
+                const DiskLayer* previous);
+  void loadPackedFile(const std::string& path, Api::Api& api);
 
   const std::string path_;
+  // Identities of the files values_ was read from, by key.
+  absl::flat_hash_map<std::string, FileIdentity> file_identities_;
+  // Identity of the packed file values_ was read from, if any.
+  absl::optional<FileIdentity> packed_file_identity_;
   // Maximum recursion depth for walkDirectory().
   const uint32_t MaxWalkDepth = 16;
 };
@@ -200,6 +297,8 @@ protected:
   RandomGenerator& generator_;
   RuntimeStats stats_;
   AdminLayer admin_layer_;
+  // The most recently loaded snapshot, from which subclasses may reuse values.
+  std::shared_ptr<const SnapshotImpl> snapshot_;
 
 private:
   RuntimeStats generateStats(Stats::Store& store);
@@ -220,6 +319,7 @@ public:
 
 private:
   std::unique_ptr<SnapshotImpl> createNewSnapshot() override;
+  const DiskLayer* previousDiskLayer(const std::string& name) const;
 
   const Filesystem::WatcherPtr watcher_;
   const std::string root_path_;
@@ -3,18 +3,30 @@
 #include <cstdint>
 #include <string>
 
-#include "common/common/utility.h"
 #include "common/runtime/runtime_impl.h"
 
 namespace Envoy {
-bool UuidUtils::uuidModBy(const std::string& uuid, uint64_t& out, uint64_t mod) {
+bool UuidUtils::uuidModBy(absl::string_view uuid, uint64_t& out, uint64_t mod) {
   if (uuid.length() < 8) {
     return false;
   }
 
-  uint64_t value;
-  if (!StringUtil::atoull(uuid.substr(0, 8).c_str(), value, 16)) {
-    return false;
+  // This runs for every request with tracing enabled, so the leading 32 bits are decoded by hand
+  // rather than by copying them into a string for strtoull().
+  uint64_t value = 0;
+  for (size_t i = 0; i < 8; i++) {
+    const char c = uuid[i];
+    uint64_t digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    value = (value << 4) | digit;
   }
 
   out = value % mod;
@@ -39,7 +51,11 @@ UuidTraceStatus UuidUtils::isTraceableUuid(absl::string_view uuid) {
 }
 
 bool UuidUtils::setTraceableUuid(std::string& uuid, UuidTraceStatus trace_status) {
-  if (uuid.length() != Runtime::RandomGeneratorImpl::UUID_LENGTH) {
+  return setTraceableUuid(&uuid[0], uuid.length(), trace_status);
+}
+
+bool UuidUtils::setTraceableUuid(char* uuid, size_t length, UuidTraceStatus trace_status) {
+  if (length != Runtime::RandomGeneratorImpl::UUID_LENGTH) {
     return false;
   }
 
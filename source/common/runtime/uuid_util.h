@@ -19,7 +19,7 @@ public:
    * @param out will contain the result of the operation.
    * @param mod modulo used in the operation.
    */
-  static bool uuidModBy(const std::string& uuid, uint64_t& out, uint64_t mod);
+  static bool uuidModBy(absl::string_view uuid, uint64_t& out, uint64_t mod);
 
   /**
    * Modify uuid in a way it can be detected if uuid is traceable or not.
@@ -29,6 +29,15 @@ public:
    */
   static bool setTraceableUuid(std::string& uuid, UuidTraceStatus trace_status);
 
+  /**
+   * Modify uuid in place in a caller owned buffer, as done by setTraceableUuid() above.
+   * @param uuid supplies the buffer holding a uuid4.
+   * @param length supplies the length of the uuid.
+   * @param trace_status is to specify why we modify uuid.
+   * @return true on success, false on failure.
+   */
+  static bool setTraceableUuid(char* uuid, size_t length, UuidTraceStatus trace_status);
+
   /**
    * @return status of the uuid, to differentiate reason for tracing, etc.
    */
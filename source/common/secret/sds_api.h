@@ -13,11 +13,13 @@
 #include "envoy/secret/secret_callbacks.h"
 #include "envoy/secret/secret_provider.h"
 #include "envoy/server/transport_socket_config.h"
+#include "envoy/ssl/context_config.h"
 #include "envoy/stats/stats.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/callback_impl.h"
 #include "common/common/cleanup.h"
+#include "common/config/datasource.h"
 #include "common/init/target_impl.h"
 #include "common/ssl/certificate_validation_context_config_impl.h"
 #include "common/ssl/tls_certificate_config_impl.h"
@@ -53,6 +55,7 @@ protected:
   // Creates new secrets.
   virtual void setSecret(const envoy::api::v2::auth::Secret&) PURE;
   virtual void validateConfig(const envoy::api::v2::auth::Secret&) PURE;
+  Api::Api& api() { return api_; }
   Common::CallbackManager<> update_callback_manager_;
 
 private:
@@ -75,9 +78,11 @@ private:
 
 class TlsCertificateSdsApi;
 class CertificateValidationContextSdsApi;
+class TlsSessionTicketKeysSdsApi;
 typedef std::shared_ptr<TlsCertificateSdsApi> TlsCertificateSdsApiSharedPtr;
 typedef std::shared_ptr<CertificateValidationContextSdsApi>
     CertificateValidationContextSdsApiSharedPtr;
+typedef std::shared_ptr<TlsSessionTicketKeysSdsApi> TlsSessionTicketKeysSdsApiSharedPtr;
 
 /**
  * TlsCertificateSdsApi implementation maintains and updates dynamic TLS certificate secrets.
@@ -181,5 +186,67 @@ private:
       validation_callback_manager_;
 };
 
+/**
+ * TlsSessionTicketKeysSdsApi implementation maintains and updates dynamic session ticket keys, so
+ * that keys can be rotated without restarting or reconfiguring listeners.
+ */
+class TlsSessionTicketKeysSdsApi : public SdsApi, public TlsSessionTicketKeysConfigProvider {
+public:
+  static TlsSessionTicketKeysSdsApiSharedPtr
+  create(Server::Configuration::TransportSocketFactoryContext& secret_provider_context,
+         const envoy::api::v2::core::ConfigSource& sds_config, const std::string& sds_config_name,
+         std::function<void()> destructor_cb) {
+    return std::make_shared<TlsSessionTicketKeysSdsApi>(
+        secret_provider_context.localInfo(), secret_provider_context.dispatcher(),
+        secret_provider_context.random(), secret_provider_context.stats(),
+        secret_provider_context.clusterManager(), *secret_provider_context.initManager(),
+        sds_config, sds_config_name, destructor_cb, secret_provider_context.api());
+  }
+
+  TlsSessionTicketKeysSdsApi(const LocalInfo::LocalInfo& local_info, Event::Dispatcher& dispatcher,
+                             Runtime::RandomGenerator& random, Stats::Store& stats,
+                             Upstream::ClusterManager& cluster_manager,
+                             Init::Manager& init_manager,
+                             const envoy::api::v2::core::ConfigSource& sds_config,
+                             const std::string& sds_config_name,
+                             std::function<void()> destructor_cb, Api::Api& api)
+      : SdsApi(local_info, dispatcher, random, stats, cluster_manager, init_manager, sds_config,
+               sds_config_name, destructor_cb, api) {}
+
+  // SecretProvider
+  const envoy::api::v2::auth::TlsSessionTicketKeys* secret() const override {
+    return session_ticket_keys_.get();
+  }
+  Common::CallbackHandle* addUpdateCallback(std::function<void()> callback) override {
+    return update_callback_manager_.add(callback);
+  }
+
+protected:
+  void setSecret(const envoy::api::v2::auth::Secret& secret) override {
+    session_ticket_keys_ =
+        std::make_unique<envoy::api::v2::auth::TlsSessionTicketKeys>(secret.session_ticket_keys());
+  }
+  void validateConfig(const envoy::api::v2::auth::Secret& secret) override {
+    if (secret.type_case() != envoy::api::v2::auth::Secret::TypeCase::kSessionTicketKeys) {
+      throw EnvoyException(
+          fmt::format("SDS secret {} does not contain session ticket keys", secret.name()));
+    }
+    // Reject the whole update before setSecret() so that a bad key never replaces the current
+    // keys; the update callbacks would otherwise throw while rebuilding the server contexts.
+    for (const auto& key : secret.session_ticket_keys().keys()) {
+      const std::string key_data = Config::DataSource::read(key, false, api());
+      if (key_data.size() != sizeof(Ssl::ServerContextConfig::SessionTicketKey)) {
+        throw EnvoyException(fmt::format("Incorrect TLS session ticket key length in SDS secret "
+                                         "{}. Length {}, expected length {}.",
+                                         secret.name(), key_data.size(),
+                                         sizeof(Ssl::ServerContextConfig::SessionTicketKey)));
+      }
+    }
+  }
+
+private:
+  TlsSessionTicketKeysPtr session_ticket_keys_;
+};
+
 } // namespace Secret
 } // namespace Envoy
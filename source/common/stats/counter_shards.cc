@@ -0,0 +1,144 @@
+#include "common/stats/counter_shards.h"
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Stats {
+
+thread_local CounterShards::LocalSlab CounterShards::local_slab_;
+
+CounterShards& CounterShards::get() {
+  // Intentionally leaked so that thread exit during process teardown can still release slabs.
+  static CounterShards* shards = new CounterShards();
+  return *shards;
+}
+
+uint32_t CounterShards::allocSlot() {
+  Thread::LockGuard lock(mutex_);
+  if (!free_slots_.empty()) {
+    const uint32_t slot = free_slots_.back();
+    free_slots_.pop_back();
+    return slot;
+  }
+  if (next_slot_ == SlotsPerChunk * MaxChunks) {
+    return NoSlot;
+  }
+  return next_slot_++;
+}
+
+void CounterShards::freeSlot(uint32_t slot) {
+  ASSERT(slot != NoSlot);
+  Thread::LockGuard lock(mutex_);
+  const uint32_t num_slabs = num_slabs_.load(std::memory_order_acquire);
+  for (uint32_t i = 0; i < num_slabs; i++) {
+    slabs_[i].load(std::memory_order_acquire)->clear(slot);
+  }
+  overflow_slab_.clear(slot);
+  free_slots_.push_back(slot);
+}
+
+void CounterShards::add(uint32_t slot, uint64_t amount) {
+  ASSERT(slot != NoSlot);
+  localSlab().add(slot, amount);
+}
+
+uint64_t CounterShards::sum(uint32_t slot) const {
+  ASSERT(slot != NoSlot);
+  uint64_t total = overflow_slab_.value(slot);
+  const uint32_t num_slabs = num_slabs_.load(std::memory_order_acquire);
+  for (uint32_t i = 0; i < num_slabs; i++) {
+    total += slabs_[i].load(std::memory_order_acquire)->value(slot);
+  }
+  return total;
+}
+
+CounterShards::Slab& CounterShards::localSlab() {
+  if (local_slab_.slab_ == nullptr) {
+    local_slab_.slab_ = acquireSlab();
+  }
+  return *local_slab_.slab_;
+}
+
+CounterShards::Slab* CounterShards::acquireSlab() {
+  Thread::LockGuard lock(mutex_);
+  if (!free_slabs_.empty()) {
+    Slab* slab = free_slabs_.back();
+    free_slabs_.pop_back();
+    return slab;
+  }
+
+  const uint32_t num_slabs = num_slabs_.load(std::memory_order_relaxed);
+  if (num_slabs == MaxSlabs) {
+    return &overflow_slab_;
+  }
+  owned_slabs_.emplace_back(new Slab(false));
+  slabs_[num_slabs].store(owned_slabs_.back().get(), std::memory_order_release);
+  num_slabs_.store(num_slabs + 1, std::memory_order_release);
+  return owned_slabs_.back().get();
+}
+
+void CounterShards::releaseSlab(Slab* slab) {
+  if (slab == &overflow_slab_) {
+    return;
+  }
+  Thread::LockGuard lock(mutex_);
+  free_slabs_.push_back(slab);
+}
+
+CounterShards::LocalSlab::~LocalSlab() {
+  if (slab_ != nullptr) {
+    CounterShards::get().releaseSlab(slab_);
+  }
+}
+
+CounterShards::Slab::~Slab() {
+  for (std::atomic<Chunk*>& chunk : chunks_) {
+    delete[] chunk.load();
+  }
+}
+
+void CounterShards::Slab::add(uint32_t slot, uint64_t amount) {
+  Chunk& value = chunk(slot / SlotsPerChunk)[slot % SlotsPerChunk];
+  if (shared_) {
+    value.fetch_add(amount, std::memory_order_relaxed);
+  } else {
+    // This thread is the only writer, so a plain load and store is enough. Readers may see the
+    // old value, which only delays the increment until their next read.
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+}
+
+uint64_t CounterShards::Slab::value(uint32_t slot) const {
+  const Chunk* values = chunks_[slot / SlotsPerChunk].load(std::memory_order_acquire);
+  if (values == nullptr) {
+    return 0;
+  }
+  return values[slot % SlotsPerChunk].load(std::memory_order_relaxed);
+}
+
+void CounterShards::Slab::clear(uint32_t slot) {
+  Chunk* values = chunks_[slot / SlotsPerChunk].load(std::memory_order_acquire);
+  if (values != nullptr) {
+    values[slot % SlotsPerChunk].store(0, std::memory_order_relaxed);
+  }
+}
+
+CounterShards::Chunk* CounterShards::Slab::chunk(uint32_t index) {
+  Chunk* values = chunks_[index].load(std::memory_order_acquire);
+  if (values != nullptr) {
+    return values;
+  }
+
+  // Chunks are allocated on first write. Only the shared slab can race here, in which case the
+  // loser frees its allocation and uses the winner's.
+  Chunk* new_values = new Chunk[SlotsPerChunk]();
+  if (chunks_[index].compare_exchange_strong(values, new_values, std::memory_order_acq_rel)) {
+    return new_values;
+  }
+  delete[] new_values;
+  return values;
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Process wide storage for sharded counter values. A counter is assigned a slot, and each thread
+ * that adds to a counter writes to that slot in its own slab, so increments from different threads
+ * never write to the same cache line and need no atomic read-modify-write. Reading a counter sums
+ * its slot across all slabs.
+ *
+ * Slabs are owned by this class rather than by threads. When a thread exits its slab is released
+ * with its values intact and is adopted by the next thread that needs one, so counter values are
+ * never lost and the number of slabs is bounded by the peak number of concurrent threads.
+ */
+class CounterShards {
+public:
+  static constexpr uint32_t NoSlot = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @return CounterShards& the process wide instance.
+   */
+  static CounterShards& get();
+
+  /**
+   * Allocates a slot with a value of zero.
+   * @return uint32_t the slot, or NoSlot if all slots are in use.
+   */
+  uint32_t allocSlot();
+
+  /**
+   * Returns a slot for reuse. The slot must no longer be written to.
+   * @param slot supplies a slot returned by allocSlot().
+   */
+  void freeSlot(uint32_t slot);
+
+  /**
+   * Adds to a slot from the calling thread.
+   * @param slot supplies the slot.
+   * @param amount supplies the amount to add.
+   */
+  void add(uint32_t slot, uint64_t amount);
+
+  /**
+   * @param slot supplies the slot.
+   * @return uint64_t the sum of everything added to the slot since it was allocated.
+   */
+  uint64_t sum(uint32_t slot) const;
+
+private:
+  static constexpr uint32_t SlotsPerChunk = 1024;
+  static constexpr uint32_t MaxChunks = 4096;
+  static constexpr uint32_t MaxSlabs = 256;
+
+  using Chunk = std::atomic<uint64_t>;
+
+  class Slab {
+  public:
+    // A shared slab may be written by several threads at once and uses atomic adds, while an
+    // owned slab only ever has a single writer.
+    explicit Slab(bool shared) : shared_(shared) {}
+    ~Slab();
+
+    void add(uint32_t slot, uint64_t amount);
+    uint64_t value(uint32_t slot) const;
+    void clear(uint32_t slot);
+
+  private:
+    Chunk* chunk(uint32_t index);
+
+    const bool shared_;
+    std::array<std::atomic<Chunk*>, MaxChunks> chunks_{};
+  };
+
+  // Returns the calling thread's slab to the free list when the thread exits.
+  struct LocalSlab {
+    ~LocalSlab();
+    Slab* slab_{};
+  };
+
+  CounterShards() = default;
+
+  Slab& localSlab();
+  Slab* acquireSlab();
+  void releaseSlab(Slab* slab);
+
+  static thread_local LocalSlab local_slab_;
+
+  mutable Thread::MutexBasicLockable mutex_;
+  std::vector<std::unique_ptr<Slab>> owned_slabs_ GUARDED_BY(mutex_);
+  std::vector<Slab*> free_slabs_ GUARDED_BY(mutex_);
+  std::vector<uint32_t> free_slots_ GUARDED_BY(mutex_);
+  uint32_t next_slot_ GUARDED_BY(mutex_){};
+  // Readers walk the slabs without taking the lock. Entries are only ever appended.
+  std::array<std::atomic<Slab*>, MaxSlabs> slabs_{};
+  std::atomic<uint32_t> num_slabs_{};
+  // Used by threads that arrive once MaxSlabs slabs are in use.
+  Slab overflow_slab_{true};
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -32,6 +32,21 @@ HeapStatData* HeapStatDataAllocator::alloc(absl::string_view name) {
   return existing_data;
 }
 
+CounterSharedPtr HeapStatDataAllocator::makeCounter(absl::string_view name,
+                                                    std::string&& tag_extracted_name,
+                                                    std::vector<Tag>&& tags) {
+  HeapStatData* data = alloc(name);
+  {
+    // The slot is shared by every counter object for this name, so only assign it once.
+    Thread::LockGuard lock(mutex_);
+    if (data->counter_slot_ == CounterShards::NoSlot) {
+      data->counter_slot_ = CounterShards::get().allocSlot();
+    }
+  }
+  return std::make_shared<ShardedCounterImpl>(*data, *this, std::move(tag_extracted_name),
+                                              std::move(tags));
+}
+
 void HeapStatDataAllocator::free(HeapStatData& data) {
   ASSERT(data.ref_count_ > 0);
   if (--data.ref_count_ > 0) {
@@ -44,6 +59,9 @@ void HeapStatDataAllocator::free(HeapStatData& data) {
     ASSERT(key_removed == 1);
   }
 
+  if (data.counter_slot_ != CounterShards::NoSlot) {
+    CounterShards::get().freeSlot(data.counter_slot_);
+  }
   data.free();
 }
 
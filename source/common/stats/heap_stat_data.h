@@ -9,6 +9,8 @@
 #include "common/common/hash.h"
 #include "common/common/thread.h"
 #include "common/common/thread_annotations.h"
+#include "common/stats/counter_shards.h"
+#include "common/stats/metric_impl.h"
 #include "common/stats/stat_data_allocator_impl.h"
 
 #include "absl/container/flat_hash_set.h"
@@ -17,8 +19,11 @@ namespace Envoy {
 namespace Stats {
 
 /**
- * This structure is an alternate backing store for both CounterImpl and GaugeImpl. It is designed
- * so that it can be allocated efficiently from the heap on demand.
+ * This structure is an alternate backing store for both ShardedCounterImpl and GaugeImpl. It is
+ * designed so that it can be allocated efficiently from the heap on demand.
+ *
+ * When backing a counter whose value lives in CounterShards, counter_slot_ is its slot, value_ is
+ * the slot sum at the last reset() and pending_increment_ is the slot sum at the last latch().
  */
 struct HeapStatData {
   /**
@@ -38,6 +43,7 @@ struct HeapStatData {
   std::atomic<uint64_t> pending_increment_{0};
   std::atomic<uint16_t> flags_{0};
   std::atomic<uint16_t> ref_count_{1};
+  uint32_t counter_slot_{CounterShards::NoSlot};
   char name_[];
 
 private:
@@ -49,9 +55,69 @@ private:
   ~HeapStatData() {}
 };
 
+/**
+ * Counter implementation that wraps a HeapStatData and keeps its value in CounterShards, so that
+ * hot counters incremented from every worker do not bounce a shared cache line between cores.
+ * Reads aggregate across threads. If no shard slot could be allocated the counter falls back to
+ * the atomics in the HeapStatData, like CounterImpl.
+ */
+class ShardedCounterImpl : public Counter, public MetricImpl {
+public:
+  ShardedCounterImpl(HeapStatData& data, StatDataAllocatorImpl<HeapStatData>& alloc,
+                     std::string&& tag_extracted_name, std::vector<Tag>&& tags)
+      : MetricImpl(std::move(tag_extracted_name), std::move(tags)), data_(data), alloc_(alloc) {}
+  ~ShardedCounterImpl() { alloc_.free(data_); }
+
+  // Stats::Metric
+  std::string name() const override { return std::string(data_.name()); }
+  const char* nameCStr() const override { return data_.name(); }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    if (data_.counter_slot_ == CounterShards::NoSlot) {
+      data_.value_ += amount;
+      data_.pending_increment_ += amount;
+    } else {
+      CounterShards::get().add(data_.counter_slot_, amount);
+    }
+    // Only write the flag once, so that steady state increments never write shared memory.
+    if (!(data_.flags_.load(std::memory_order_relaxed) & Flags::Used)) {
+      data_.flags_ |= Flags::Used;
+    }
+  }
+
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    if (data_.counter_slot_ == CounterShards::NoSlot) {
+      return data_.pending_increment_.exchange(0);
+    }
+    const uint64_t total = CounterShards::get().sum(data_.counter_slot_);
+    return total - data_.pending_increment_.exchange(total);
+  }
+  void reset() override {
+    data_.value_ = data_.counter_slot_ == CounterShards::NoSlot
+                       ? 0
+                       : CounterShards::get().sum(data_.counter_slot_);
+  }
+  bool used() const override { return data_.flags_ & Flags::Used; }
+  uint64_t value() const override {
+    if (data_.counter_slot_ == CounterShards::NoSlot) {
+      return data_.value_;
+    }
+    // Load the reset point first so that the sum can never be older than it.
+    const uint64_t reset_value = data_.value_;
+    return CounterShards::get().sum(data_.counter_slot_) - reset_value;
+  }
+
+private:
+  HeapStatData& data_;
+  StatDataAllocatorImpl<HeapStatData>& alloc_;
+};
+
 /**
  * Implementation of StatDataAllocator using a pure heap-based strategy, so that
  * Envoy implementations that do not require hot-restart can use less memory.
+ * Counters are sharded per thread; see ShardedCounterImpl.
  */
 class HeapStatDataAllocator : public StatDataAllocatorImpl<HeapStatData> {
 public:
@@ -63,6 +129,8 @@ public:
   void free(HeapStatData& data) override;
 
   // StatDataAllocator
+  CounterSharedPtr makeCounter(absl::string_view name, std::string&& tag_extracted_name,
+                               std::vector<Tag>&& tags) override;
   bool requiresBoundedStatNameSize() const override { return false; }
 
 private:
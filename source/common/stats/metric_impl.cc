@@ -0,0 +1,31 @@
+#include "common/stats/metric_impl.h"
+
+#include <algorithm>
+
+#include "common/common/hash.h"
+
+namespace Envoy {
+namespace Stats {
+
+size_t TagVectorHash::operator()(const std::vector<Tag>& tags) const {
+  uint64_t hash = tags.size();
+  for (const Tag& tag : tags) {
+    hash = HashUtil::xxHash64(tag.name_, hash);
+    hash = HashUtil::xxHash64(tag.value_, hash);
+  }
+  return hash;
+}
+
+bool TagVectorEqual::operator()(const std::vector<Tag>& a, const std::vector<Tag>& b) const {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Tag& x, const Tag& y) {
+    return x.name_ == y.name_ && x.value_ == y.value_;
+  });
+}
+
+MetricImpl::~MetricImpl() {
+  TagExtractedNamePool::get().release(tag_extracted_name_);
+  TagVectorPool::get().release(tags_);
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -1,16 +1,111 @@
 #pragma once
 
+#include <array>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "envoy/stats/stats.h"
 #include "envoy/stats/tag.h"
 
 #include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
 
 namespace Envoy {
 namespace Stats {
 
+/**
+ * Process wide pool of reference counted values. Stats keep a pointer into the pool rather than
+ * their own copy of their tag-extracted name and tags, as these are heavily duplicated: every
+ * cluster has the same set of tag-extracted names, and all the stats in a cluster have the same
+ * tags.
+ *
+ * Every stat construction and destruction goes through the pool, so it is sharded by the hash of
+ * the value to keep threads that create stats concurrently from serializing on one lock.
+ */
+template <class Value, class Hash, class Equal> class InternPool {
+public:
+  /**
+   * @return InternPool& the process wide pool for this type.
+   */
+  static InternPool& get() {
+    // Intentionally leaked, as stats may be destroyed during static destruction.
+    static InternPool* pool = new InternPool();
+    return *pool;
+  }
+
+  /**
+   * Takes a reference on a value, adding it to the pool if needed.
+   * @param value supplies the value.
+   * @return const Value* the pooled value, which is valid until release() is called on it.
+   */
+  const Value* intern(Value&& value) {
+    Shard& shard = shardFor(value);
+    Thread::LockGuard lock(shard.mutex_);
+    auto it = shard.values_.find(value);
+    if (it == shard.values_.end()) {
+      it = shard.values_.emplace(std::move(value), 0).first;
+    }
+    ++it->second;
+    return &it->first;
+  }
+
+  /**
+   * Drops a reference taken by intern(), removing the value once it is unused.
+   * @param value supplies a value returned by intern().
+   */
+  void release(const Value* value) {
+    Shard& shard = shardFor(*value);
+    Thread::LockGuard lock(shard.mutex_);
+    auto it = shard.values_.find(*value);
+    ASSERT(it != shard.values_.end() && &it->first == value);
+    if (--it->second == 0) {
+      shard.values_.erase(it);
+    }
+  }
+
+  /**
+   * @return uint64_t the number of distinct values in the pool.
+   */
+  uint64_t size() const {
+    uint64_t size = 0;
+    for (const Shard& shard : shards_) {
+      Thread::LockGuard lock(shard.mutex_);
+      size += shard.values_.size();
+    }
+    return size;
+  }
+
+private:
+  struct Shard {
+    mutable Thread::MutexBasicLockable mutex_;
+    // Node based, so that pointers to keys remain valid across inserts and erases.
+    std::unordered_map<Value, uint64_t, Hash, Equal> values_ GUARDED_BY(mutex_);
+  };
+
+  static constexpr size_t NumShards = 32;
+
+  InternPool() = default;
+
+  Shard& shardFor(const Value& value) { return shards_[Hash()(value) % NumShards]; }
+
+  std::array<Shard, NumShards> shards_;
+};
+
+struct TagVectorHash {
+  size_t operator()(const std::vector<Tag>& tags) const;
+};
+
+struct TagVectorEqual {
+  bool operator()(const std::vector<Tag>& a, const std::vector<Tag>& b) const;
+};
+
+using TagExtractedNamePool =
+    InternPool<std::string, std::hash<std::string>, std::equal_to<std::string>>;
+using TagVectorPool = InternPool<std::vector<Tag>, TagVectorHash, TagVectorEqual>;
+
 /**
  * Implementation of the Metric interface. Virtual inheritance is used because the interfaces that
  * will inherit from Metric will have other base classes that will also inherit from Metric.
@@ -21,10 +116,12 @@ namespace Stats {
 class MetricImpl : public virtual Metric {
 public:
   MetricImpl(std::string&& tag_extracted_name, std::vector<Tag>&& tags)
-      : tag_extracted_name_(std::move(tag_extracted_name)), tags_(std::move(tags)) {}
+      : tag_extracted_name_(TagExtractedNamePool::get().intern(std::move(tag_extracted_name))),
+        tags_(TagVectorPool::get().intern(std::move(tags))) {}
+  ~MetricImpl();
 
-  const std::string& tagExtractedName() const override { return tag_extracted_name_; }
-  const std::vector<Tag>& tags() const override { return tags_; }
+  const std::string& tagExtractedName() const override { return *tag_extracted_name_; }
+  const std::vector<Tag>& tags() const override { return *tags_; }
 
 protected:
   /**
@@ -35,8 +132,8 @@ protected:
   };
 
 private:
-  const std::string tag_extracted_name_;
-  const std::vector<Tag> tags_;
+  const std::string* const tag_extracted_name_;
+  const std::vector<Tag>* const tags_;
 };
 
 } // namespace Stats
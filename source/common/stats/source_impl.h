@@ -26,5 +26,27 @@ private:
   absl::optional<std::vector<ParentHistogramSharedPtr>> histograms_;
 };
 
+/**
+ * Source holding the metrics that were in a store when it was constructed. It never goes back to
+ * the store, so sinks on different threads can share it while stats are added to and removed from
+ * the store, and each sees the same set of metrics. Metric values are still read when flushed.
+ */
+class SnapshotSourceImpl : public Source {
+public:
+  SnapshotSourceImpl(Store& store)
+      : counters_(store.counters()), gauges_(store.gauges()), histograms_(store.histograms()) {}
+
+  // Stats::Source
+  const std::vector<CounterSharedPtr>& cachedCounters() override { return counters_; }
+  const std::vector<GaugeSharedPtr>& cachedGauges() override { return gauges_; }
+  const std::vector<ParentHistogramSharedPtr>& cachedHistograms() override { return histograms_; }
+  void clearCache() override {}
+
+private:
+  const std::vector<CounterSharedPtr> counters_;
+  const std::vector<GaugeSharedPtr> gauges_;
+  const std::vector<ParentHistogramSharedPtr> histograms_;
+};
+
 } // namespace Stats
 } // namespace Envoy
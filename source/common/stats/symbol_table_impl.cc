@@ -123,9 +123,16 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
   symbols.reserve(tokens.size());
 
   // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
+  // ref-counts in this. Most names are built from tokens that are already in
+  // the table, which only needs the lock shared; the exclusive lock is taken
+  // only when a new symbol must be allocated.
+  bool found;
   {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
+    found = findExistingSymbols(tokens, symbols);
+  }
+  if (!found) {
+    absl::MutexLock lock(&lock_);
     for (auto& token : tokens) {
       symbols.push_back(toSymbol(token));
     }
@@ -137,8 +144,29 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
   }
 }
 
+bool SymbolTableImpl::findExistingSymbols(const std::vector<absl::string_view>& tokens,
+                                          SymbolVec& symbols) {
+  std::vector<SharedSymbol*> shared_symbols;
+  shared_symbols.reserve(tokens.size());
+  for (absl::string_view token : tokens) {
+    auto encode_find = encode_map_.find(token);
+    if (encode_find == encode_map_.end()) {
+      return false;
+    }
+    shared_symbols.push_back(&encode_find->second);
+  }
+
+  // Entries can only be erased with the lock held exclusively, so references
+  // may safely be taken here with the lock held shared.
+  for (SharedSymbol* shared_symbol : shared_symbols) {
+    shared_symbol->ref_count_.fetch_add(1, std::memory_order_relaxed);
+    symbols.push_back(shared_symbol->symbol_);
+  }
+  return true;
+}
+
 uint64_t SymbolTableImpl::numSymbols() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   ASSERT(encode_map_.size() == decode_map_.size());
   return encode_map_.size();
 }
@@ -157,7 +185,7 @@ std::string SymbolTableImpl::decodeSymbolVec(const SymbolVec& symbols) const {
   name_tokens.reserve(symbols.size());
   {
     // Hold the lock only while decoding symbols.
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     for (Symbol symbol : symbols) {
       name_tokens.push_back(fromSymbol(symbol));
     }
@@ -169,7 +197,7 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   for (Symbol symbol : symbols) {
     auto decode_search = decode_map_.find(symbol);
     ASSERT(decode_search != decode_map_.end());
@@ -177,7 +205,7 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
     auto encode_search = encode_map_.find(*decode_search->second);
     ASSERT(encode_search != encode_map_.end());
 
-    ++encode_search->second.ref_count_;
+    encode_search->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
@@ -185,7 +213,7 @@ void SymbolTableImpl::free(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
+  absl::MutexLock lock(&lock_);
   for (Symbol symbol : symbols) {
     auto decode_search = decode_map_.find(symbol);
     ASSERT(decode_search != decode_map_.end());
@@ -227,13 +255,13 @@ Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
     // If the insertion didn't take place, return the actual value at that location and up the
     // refcount at that location
     result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
+    encode_find->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
   return result;
 }
 
 absl::string_view SymbolTableImpl::fromSymbol(const Symbol symbol) const
-    EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    SHARED_LOCKS_REQUIRED(lock_) {
   auto search = decode_map_.find(symbol);
   RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
   return {*search->second};
@@ -260,7 +288,7 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
 
   // Calling fromSymbol requires holding the lock, as it needs read-access to
   // the maps that are written when adding new symbols.
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   for (uint64_t i = 0, n = std::min(av.size(), bv.size()); i < n; ++i) {
     if (av[i] != bv[i]) {
       bool ret = fromSymbol(av[i]) < fromSymbol(bv[i]);
@@ -272,7 +300,7 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTableImpl::debugPrint() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   std::vector<Symbol> symbols;
   for (const auto& p : decode_map_) {
     symbols.push_back(p.first);
@@ -281,7 +309,7 @@ void SymbolTableImpl::debugPrint() const {
   for (Symbol symbol : symbols) {
     std::string& token = *decode_map_.find(symbol)->second;
     const SharedSymbol& shared_symbol = encode_map_.find(token)->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token, shared_symbol.ref_count_);
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token, shared_symbol.ref_count_.load());
   }
 }
 #endif
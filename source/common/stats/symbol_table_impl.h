@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <stack>
@@ -22,6 +23,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -166,12 +168,22 @@ private:
   struct SharedSymbol {
     SharedSymbol(Symbol symbol) : symbol_(symbol), ref_count_(1) {}
 
+    // Only called by the hash map while lock_ is held exclusively.
+    SharedSymbol(SharedSymbol&& src)
+        : symbol_(src.symbol_), ref_count_(src.ref_count_.load(std::memory_order_relaxed)) {}
+
     Symbol symbol_;
-    uint32_t ref_count_;
+
+    // Incremented with lock_ held shared, so that encoding names made of
+    // existing symbols does not serialize on the table. Decrements happen
+    // with lock_ held exclusively, which is when an entry may be erased.
+    std::atomic<uint32_t> ref_count_;
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // This must be held during both encode() and free(). Encoding names whose
+  // tokens are all present in the table, incRefCount(), and decoding only
+  // need it shared.
+  mutable absl::Mutex lock_;
 
   /**
    * Decodes a vector of symbols back into its period-delimited stat name. If
@@ -198,12 +210,12 @@ private:
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const SHARED_LOCKS_REQUIRED(lock_);
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
    */
-  void newSymbol();
+  void newSymbol() EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   /**
    * Tokenizes name, finds or allocates symbols for each token, and adds them
@@ -214,8 +226,20 @@ private:
    */
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
+  /**
+   * Looks up the symbols for tokens, taking a reference on each, without
+   * adding anything to the table. Either every token is found, or no
+   * references are taken.
+   *
+   * @param tokens the tokens to look up.
+   * @param symbols receives the symbols for tokens, in order, on success.
+   * @return bool true if every token already had a symbol.
+   */
+  bool findExistingSymbols(const std::vector<absl::string_view>& tokens, SymbolVec& symbols)
+      SHARED_LOCKS_REQUIRED(lock_);
+
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::MutexLock lock(&lock_);
     return monotonic_counter_;
   }
 
@@ -224,7 +248,7 @@ private:
   Symbol next_symbol_ GUARDED_BY(lock_);
 
   // If the free pool is exhausted, we monotonically increase this counter.
-  Symbol monotonic_counter_;
+  Symbol monotonic_counter_ GUARDED_BY(lock_);
 
   // Bitmap implementation.
   // The encode map stores both the symbol and the ref count of that symbol.
@@ -33,7 +33,12 @@ public:
                            std::vector<Tag>&& tags);
   ~ThreadLocalHistogramImpl();
 
-  void merge(histogram_t* target);
+  /**
+   * Merges the values recorded before the last beginMerge() into target.
+   * @param target supplies the histogram to merge into.
+   * @return bool whether any values were recorded before the last beginMerge().
+   */
+  bool merge(histogram_t* target);
 
   /**
    * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
@@ -57,6 +62,10 @@ private:
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_;
   histogram_t* histograms_[2];
+  // Whether each histogram has values, so that merge can skip histograms that have not been
+  // recorded to. Each entry is only written by the thread that owns it at the time: the
+  // recording thread for the active histogram, and the merging thread for the other one.
+  bool recorded_[2];
   std::atomic<uint16_t> flags_;
   std::thread::id created_thread_id_;
   const std::string name_;
@@ -110,6 +119,9 @@ private:
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ GUARDED_BY(merge_lock_);
   bool merged_;
+  // Whether nothing was recorded in the last interval, in which case the interval statistics are
+  // already those of an empty histogram.
+  bool interval_empty_;
   const std::string name_;
 };
 
@@ -1,5 +1,6 @@
 #include "common/tcp/conn_pool.h"
 
+#include <cmath>
 #include <memory>
 
 #include "envoy/event/dispatcher.h"
@@ -57,6 +58,7 @@ void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
 
 void ConnPoolImpl::assignConnection(ActiveConn& conn, ConnectionPool::Callbacks& callbacks) {
   ASSERT(conn.wrapper_ == nullptr);
+  conn.prefetched_ = false;
   conn.wrapper_ = std::make_shared<ConnectionWrapper>(conn);
 
   callbacks.onPoolReady(std::make_unique<ConnectionDataImpl>(conn.wrapper_),
@@ -76,17 +78,48 @@ void ConnPoolImpl::checkForDrained() {
   }
 }
 
-void ConnPoolImpl::createNewConnection() {
-  ENVOY_LOG(debug, "creating a new connection");
+void ConnPoolImpl::createNewConnection(bool prefetched) {
+  ENVOY_LOG(debug, "creating a new {}connection", prefetched ? "prefetched " : "");
   ActiveConnPtr conn(new ActiveConn(*this));
+  conn->prefetched_ = prefetched;
+  if (prefetched) {
+    host_->cluster().stats().upstream_cx_prefetch_total_.inc();
+  }
   conn->moveIntoList(std::move(conn), pending_conns_);
 }
 
+// Establishes connections until the pool holds perUpstreamPrefetchRatio() connections for each
+// assigned or pending request, so that the next requests find a ready connection.
+void ConnPoolImpl::maybePrefetch() {
+  const float ratio = host_->cluster().perUpstreamPrefetchRatio();
+  if (ratio <= 1.0) {
+    return;
+  }
+
+  const uint64_t target = std::ceil(ratio * (busy_conns_.size() + pending_requests_.size()));
+  while (ready_conns_.size() + busy_conns_.size() + pending_conns_.size() < target &&
+         host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    createNewConnection(true);
+  }
+}
+
+void ConnPoolImpl::prewarm() {
+  if (drained_callbacks_.empty() && ready_conns_.empty() && busy_conns_.empty() &&
+      pending_conns_.empty() &&
+      host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    createNewConnection(true);
+  }
+}
+
 ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbacks& callbacks) {
   if (!ready_conns_.empty()) {
     ready_conns_.front()->moveBetweenLists(ready_conns_, busy_conns_);
     ENVOY_CONN_LOG(debug, "using existing connection", *busy_conns_.front()->conn_);
+    if (busy_conns_.front()->prefetched_) {
+      host_->cluster().stats().upstream_rq_prefetch_hit_.inc();
+    }
     assignConnection(*busy_conns_.front(), callbacks);
+    maybePrefetch();
     return nullptr;
   }
 
@@ -106,6 +139,7 @@ ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbac
     ENVOY_LOG(debug, "queueing request due to no available connections");
     PendingRequestPtr pending_request(new PendingRequest(*this, callbacks));
     pending_request->moveIntoList(std::move(pending_request), pending_requests_);
+    maybePrefetch();
     return pending_requests_.front().get();
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
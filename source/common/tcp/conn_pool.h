@@ -31,6 +31,7 @@ public:
   void addDrainedCallback(DrainedCb cb) override;
   void drainConnections() override;
   ConnectionPool::Cancellable* newConnection(ConnectionPool::Callbacks& callbacks) override;
+  void prewarm() override;
 
 protected:
   struct ActiveConn;
@@ -116,6 +117,8 @@ protected:
     Stats::TimespanPtr conn_length_;
     uint64_t remaining_requests_;
     bool timed_out_;
+    // True if the connection was established ahead of demand and has not been assigned yet.
+    bool prefetched_{};
   };
 
   typedef std::unique_ptr<ActiveConn> ActiveConnPtr;
@@ -136,7 +139,8 @@ protected:
   typedef std::unique_ptr<PendingRequest> PendingRequestPtr;
 
   void assignConnection(ActiveConn& conn, ConnectionPool::Callbacks& callbacks);
-  void createNewConnection();
+  void createNewConnection(bool prefetched = false);
+  void maybePrefetch();
   void onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent event);
   void onPendingRequestCancel(PendingRequest& request, ConnectionPool::CancelPolicy cancel_policy);
   virtual void onConnReleased(ActiveConn& conn);
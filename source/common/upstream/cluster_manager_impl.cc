@@ -173,7 +173,8 @@ ClusterManagerImpl::ClusterManagerImpl(
     Stats::Store& stats, ThreadLocal::Instance& tls, Runtime::Loader& runtime,
     Runtime::RandomGenerator& random, const LocalInfo::LocalInfo& local_info,
     AccessLog::AccessLogManager& log_manager, Event::Dispatcher& main_thread_dispatcher,
-    Server::Admin& admin, Api::Api& api, Http::Context& http_context)
+    Server::Admin& admin, Api::Api& api, Http::Context& http_context,
+    Http::Http2::SharedConnPoolManager* shared_http2_conn_pools)
     : factory_(factory), runtime_(runtime), stats_(stats), tls_(tls.allocateSlot()),
       random_(random), bind_config_(bootstrap.cluster_manager().upstream_bind_config()),
       local_info_(local_info), cm_stats_(generateStats(stats)),
@@ -181,7 +182,7 @@ ClusterManagerImpl::ClusterManagerImpl(
       config_tracker_entry_(
           admin.getConfigTracker().add("clusters", [this] { return dumpClusterConfigs(); })),
       time_source_(main_thread_dispatcher.timeSource()), dispatcher_(main_thread_dispatcher),
-      http_context_(http_context) {
+      http_context_(http_context), shared_http2_conn_pools_(shared_http2_conn_pools) {
   async_client_manager_ =
       std::make_unique<Grpc::AsyncClientManagerImpl>(*this, tls, time_source_, api);
   const auto& cm_config = bootstrap.cluster_manager();
@@ -580,6 +581,14 @@ void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster,
     }
   }
 
+  if ((new_cluster->info()->features() & ClusterInfo::Features::SHARED_HTTP2_CONN_POOL) &&
+      shared_http2_conn_pools_ == nullptr) {
+    ENVOY_LOG(warn,
+              "cluster manager: cluster '{}' enables the shared HTTP/2 connection pool but no "
+              "shared connection pool threads are running, using a pool per worker",
+              new_cluster->info()->name());
+  }
+
   Cluster& cluster_reference = *new_cluster;
   if (new_cluster->healthChecker() != nullptr) {
     new_cluster->healthChecker()->addHostCheckCompleteCb(
@@ -987,6 +996,12 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
     ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", name);
     cluster_entry->lb_ = cluster_entry->lb_factory_->create();
   }
+
+  if (cluster_entry->cluster_info_->prewarmNewHosts() && !hosts_added.empty()) {
+    ENVOY_LOG(debug, "prewarming connection pools for {} hosts in TLS cluster {}",
+              hosts_added.size(), name);
+    cluster_entry->prewarmHosts(hosts_added);
+  }
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::onHostHealthFailure(
@@ -1070,7 +1085,7 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
         cluster->lbType(), priority_set_, parent_.local_priority_set_, cluster->stats(),
         cluster->statsScope(), parent.parent_.runtime_, parent.parent_.random_,
         cluster->lbSubsetInfo(), cluster->lbRingHashConfig(), cluster->lbLeastRequestConfig(),
-        cluster->lbConfig());
+        cluster->lbConfig(), parent.thread_local_dispatcher_.timeSource());
   } else {
     switch (cluster->lbType()) {
     case LoadBalancerType::LeastRequest: {
@@ -1157,9 +1172,9 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
   // function. Otherwise, we'd need to capture a few of these variables by value.
   ConnPoolsContainer::ConnPools::OptPoolRef pool =
       container.pools_->getPool(priority, hash_key, [&]() {
-        return parent_.parent_.factory_.allocateConnPool(
-            parent_.thread_local_dispatcher_, host, priority, protocol,
-            have_options ? context->downstreamConnection()->socketOptions() : nullptr);
+        return allocateConnPool(
+            host, priority, protocol,
+            have_options ? context->downstreamConnection()->socketOptions() : nullptr, hash_key);
       });
 
   if (pool.has_value()) {
@@ -1169,6 +1184,55 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
   }
 }
 
+Http::ConnectionPool::InstancePtr
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::allocateConnPool(
+    const HostConstSharedPtr& host, ResourcePriority priority, Http::Protocol protocol,
+    const Network::ConnectionSocket::OptionsSharedPtr& options,
+    const std::vector<uint8_t>& hash_key) {
+  ClusterManagerFactory& factory = parent_.parent_.factory_;
+  if (protocol == Http::Protocol::Http2 &&
+      (cluster_info_->features() & ClusterInfo::Features::SHARED_HTTP2_CONN_POOL) &&
+      parent_.parent_.shared_http2_conn_pools_ != nullptr) {
+    // The shared pool is allocated on one of the shared connection threads. Workers asking for the
+    // same host, priority and hash key get a handle to the same pool.
+    return parent_.parent_.shared_http2_conn_pools_->createPool(
+        parent_.thread_local_dispatcher_, host, priority, hash_key,
+        [&factory, host, priority, options](Event::Dispatcher& dispatcher) {
+          return factory.allocateConnPool(dispatcher, host, priority, Http::Protocol::Http2,
+                                          options);
+        });
+  }
+
+  return factory.allocateConnPool(parent_.thread_local_dispatcher_, host, priority, protocol,
+                                  options);
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::prewarmHosts(
+    const HostVector& hosts) {
+  // Without a request we cannot know the downstream protocol, so clusters that use the downstream
+  // protocol are prewarmed with HTTP/1.1.
+  const Http::Protocol protocol = (cluster_info_->features() & ClusterInfo::Features::HTTP2)
+                                      ? Http::Protocol::Http2
+                                      : Http::Protocol::Http11;
+  // This must match the hash key computed by connPool() for requests without socket options.
+  const std::vector<uint8_t> hash_key = {uint8_t(protocol)};
+
+  for (const HostSharedPtr& host : hosts) {
+    if (host->health() == Host::Health::Unhealthy) {
+      continue;
+    }
+
+    ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
+    ConnPoolsContainer::ConnPools::OptPoolRef pool =
+        container.pools_->getPool(ResourcePriority::Default, hash_key, [&]() {
+          return allocateConnPool(host, ResourcePriority::Default, protocol, nullptr, hash_key);
+        });
+    if (pool.has_value()) {
+      pool.value().get().prewarm();
+    }
+  }
+}
+
 Tcp::ConnectionPool::Instance*
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConnPool(
     ResourcePriority priority, LoadBalancerContext* context,
@@ -1217,7 +1281,8 @@ ClusterManagerPtr ProdClusterManagerFactory::clusterManagerFromProto(
     const envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
   return ClusterManagerPtr{
       new ClusterManagerImpl(bootstrap, *this, stats_, tls_, runtime_, random_, local_info_,
-                             log_manager_, main_thread_dispatcher_, admin_, api_, http_context_)};
+                             log_manager_, main_thread_dispatcher_, admin_, api_, http_context_,
+                             shared_http2_conn_pools_)};
 }
 
 Http::ConnectionPool::InstancePtr ProdClusterManagerFactory::allocateConnPool(
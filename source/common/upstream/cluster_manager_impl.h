@@ -22,6 +22,7 @@
 
 #include "common/config/grpc_mux_impl.h"
 #include "common/http/async_client_impl.h"
+#include "common/http/http2/shared_conn_pool.h"
 #include "common/upstream/load_stats_reporter.h"
 #include "common/upstream/priority_conn_pool_map.h"
 #include "common/upstream/upstream_impl.h"
@@ -42,12 +43,13 @@ public:
                             const LocalInfo::LocalInfo& local_info,
                             Secret::SecretManager& secret_manager, Api::Api& api,
                             Http::Context& http_context, AccessLog::AccessLogManager& log_manager,
-                            Singleton::Manager& singleton_manager)
+                            Singleton::Manager& singleton_manager,
+                            Http::Http2::SharedConnPoolManager* shared_http2_conn_pools = nullptr)
       : main_thread_dispatcher_(main_thread_dispatcher), api_(api), http_context_(http_context),
         admin_(admin), runtime_(runtime), stats_(stats), tls_(tls), random_(random),
         dns_resolver_(dns_resolver), ssl_context_manager_(ssl_context_manager),
         local_info_(local_info), secret_manager_(secret_manager), log_manager_(log_manager),
-        singleton_manager_(singleton_manager) {}
+        singleton_manager_(singleton_manager), shared_http2_conn_pools_(shared_http2_conn_pools) {}
 
   // Upstream::ClusterManagerFactory
   ClusterManagerPtr
@@ -83,6 +85,7 @@ protected:
   Secret::SecretManager& secret_manager_;
   AccessLog::AccessLogManager& log_manager_;
   Singleton::Manager& singleton_manager_;
+  Http::Http2::SharedConnPoolManager* shared_http2_conn_pools_;
 };
 
 /**
@@ -170,7 +173,8 @@ public:
                      Runtime::RandomGenerator& random, const LocalInfo::LocalInfo& local_info,
                      AccessLog::AccessLogManager& log_manager,
                      Event::Dispatcher& main_thread_dispatcher, Server::Admin& admin, Api::Api& api,
-                     Http::Context& http_context);
+                     Http::Context& http_context,
+                     Http::Http2::SharedConnPoolManager* shared_http2_conn_pools = nullptr);
 
   // Upstream::ClusterManager
   bool addOrUpdateCluster(const envoy::api::v2::Cluster& cluster, const std::string& version_info,
@@ -209,6 +213,10 @@ public:
     active_clusters_.clear();
     warming_clusters_.clear();
     updateGauges();
+    // Workers have stopped by now, so no new streams can be handed off to the shared pools.
+    if (shared_http2_conn_pools_ != nullptr) {
+      shared_http2_conn_pools_->shutdown();
+    }
   }
 
   const envoy::api::v2::core::BindConfig& bindConfig() const override { return bind_config_; }
@@ -296,6 +304,16 @@ private:
       tcpConnPool(ResourcePriority priority, LoadBalancerContext* context,
                   Network::TransportSocketOptionsSharedPtr transport_socket_options);
 
+      // Establishes a connection to each of the given hosts in the default priority HTTP
+      // connection pool for the cluster's upstream protocol.
+      void prewarmHosts(const HostVector& hosts);
+
+      Http::ConnectionPool::InstancePtr
+      allocateConnPool(const HostConstSharedPtr& host, ResourcePriority priority,
+                       Http::Protocol protocol,
+                       const Network::ConnectionSocket::OptionsSharedPtr& options,
+                       const std::vector<uint8_t>& hash_key);
+
       // Upstream::ThreadLocalCluster
       const PrioritySet& prioritySet() override { return priority_set_; }
       ClusterInfoConstSharedPtr info() override { return cluster_info_; }
@@ -465,6 +483,9 @@ private:
   ClusterUpdatesMap updates_map_;
   Event::Dispatcher& dispatcher_;
   Http::Context& http_context_;
+  // Owned by the server. If not set, clusters with a shared HTTP/2 connection pool use worker
+  // local pools instead.
+  Http::Http2::SharedConnPoolManager* shared_http2_conn_pools_;
 };
 
 } // namespace Upstream
@@ -31,7 +31,8 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
       unhealthy_edge_interval_(
           PROTOBUF_GET_MS_OR_DEFAULT(config, unhealthy_edge_interval, unhealthy_interval_.count())),
       healthy_edge_interval_(
-          PROTOBUF_GET_MS_OR_DEFAULT(config, healthy_edge_interval, interval_.count())) {
+          PROTOBUF_GET_MS_OR_DEFAULT(config, healthy_edge_interval, interval_.count())),
+      spread_initial_checks_(config.spread_initial_checks()) {
   cluster_.prioritySet().addMemberUpdateCb(
       [this](const HostVector& hosts_added, const HostVector& hosts_removed) -> void {
         onClusterMemberUpdate(hosts_added, hosts_removed);
@@ -53,7 +54,8 @@ void HealthCheckerImplBase::decDegraded() {
 HealthCheckerStats HealthCheckerImplBase::generateStats(Stats::Scope& scope) {
   std::string prefix("health_check.");
   return {ALL_HEALTH_CHECKER_STATS(POOL_COUNTER_PREFIX(scope, prefix),
-                                   POOL_GAUGE_PREFIX(scope, prefix))};
+                                   POOL_GAUGE_PREFIX(scope, prefix),
+                                   POOL_HISTOGRAM_PREFIX(scope, prefix))};
 }
 
 void HealthCheckerImplBase::incHealthy() {
@@ -119,13 +121,24 @@ std::chrono::milliseconds HealthCheckerImplBase::interval(HealthState state,
   return std::chrono::milliseconds(final_ms);
 }
 
+std::chrono::milliseconds HealthCheckerImplBase::initialDelay(uint64_t index,
+                                                              uint64_t count) const {
+  // Give each host in the batch its own evenly spaced slot within the interval so that the checks
+  // for a large batch of hosts do not all fire (and then keep firing) at the same time.
+  if (!spread_initial_checks_ || count <= 1) {
+    return std::chrono::milliseconds(0);
+  }
+  return std::chrono::milliseconds(interval_.count() * index / count);
+}
+
 void HealthCheckerImplBase::addHosts(const HostVector& hosts) {
-  for (const HostSharedPtr& host : hosts) {
+  for (uint64_t i = 0; i < hosts.size(); i++) {
+    const HostSharedPtr& host = hosts[i];
     active_sessions_[host] = makeSession(host);
     host->setActiveHealthFailureType(Host::ActiveHealthFailureType::UNKNOWN);
     host->setHealthChecker(
         HealthCheckHostMonitorPtr{new HealthCheckHostMonitorImpl(shared_from_this(), host)});
-    active_sessions_[host]->start();
+    active_sessions_[host]->start(initialDelay(i, hosts.size()));
   }
 }
 
@@ -264,6 +277,7 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degrade
   }
 
   parent_.stats_.success_.inc();
+  recordLatency();
   first_check_ = false;
   parent_.runCallbacks(host_, changed_state);
 
@@ -310,14 +324,42 @@ HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
     envoy::data::core::v2alpha::HealthCheckFailureType type) {
   HealthTransition changed_state = setUnhealthy(type);
+  recordLatency();
   timeout_timer_->disableTimer();
   interval_timer_->enableTimer(parent_.interval(HealthState::Unhealthy, changed_state));
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::start(
+    std::chrono::milliseconds initial_delay) {
+  if (initial_delay.count() == 0) {
+    onIntervalBase();
+  } else {
+    interval_timer_->enableTimer(initial_delay);
+  }
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::onIntervalBase() {
+  TimeSource& time_source = parent_.dispatcher_.timeSource();
+  const MonotonicTime now = time_source.monotonicTime();
+  check_start_ = now;
   onInterval();
   timeout_timer_->enableTimer(parent_.timeout_);
   parent_.stats_.attempt_.inc();
+  parent_.stats_.dispatch_us_.recordValue(
+      std::chrono::duration_cast<std::chrono::microseconds>(time_source.monotonicTime() - now)
+          .count());
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::recordLatency() {
+  // Only the first result reported for an outstanding check is timed.
+  if (!check_start_.has_value()) {
+    return;
+  }
+  parent_.stats_.latency_ms_.recordValue(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          parent_.dispatcher_.timeSource().monotonicTime() - check_start_.value())
+          .count());
+  check_start_.reset();
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::onTimeoutBase() {
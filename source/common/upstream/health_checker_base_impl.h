@@ -2,6 +2,7 @@
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/v2/core/health_check.pb.h"
+#include "envoy/common/time.h"
 #include "envoy/event/timer.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
@@ -9,6 +10,8 @@
 
 #include "common/common/logger.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -16,7 +19,7 @@ namespace Upstream {
  * All health checker stats. @see stats_macros.h
  */
 // clang-format off
-#define ALL_HEALTH_CHECKER_STATS(COUNTER, GAUGE)                                                   \
+#define ALL_HEALTH_CHECKER_STATS(COUNTER, GAUGE, HISTOGRAM)                                        \
   COUNTER(attempt)                                                                                 \
   COUNTER(success)                                                                                 \
   COUNTER(failure)                                                                                 \
@@ -24,14 +27,17 @@ namespace Upstream {
   COUNTER(network_failure)                                                                         \
   COUNTER(verify_cluster)                                                                          \
   GAUGE  (healthy)                                                                                 \
-  GAUGE  (degraded)
+  GAUGE  (degraded)                                                                                \
+  HISTOGRAM(latency_ms)                                                                            \
+  HISTOGRAM(dispatch_us)
 // clang-format on
 
 /**
  * Definition of all health checker stats. @see stats_macros.h
  */
 struct HealthCheckerStats {
-  ALL_HEALTH_CHECKER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_HEALTH_CHECKER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                           GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -50,7 +56,11 @@ protected:
   public:
     virtual ~ActiveHealthCheckSession();
     HealthTransition setUnhealthy(envoy::data::core::v2alpha::HealthCheckFailureType type);
-    void start() { onIntervalBase(); }
+    /**
+     * Start health checking the host. The first check runs immediately when initial_delay is zero,
+     * otherwise it is deferred by initial_delay.
+     */
+    void start(std::chrono::milliseconds initial_delay);
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -66,6 +76,7 @@ protected:
     void onIntervalBase();
     virtual void onTimeout() PURE;
     void onTimeoutBase();
+    void recordLatency();
 
     HealthCheckerImplBase& parent_;
     Event::TimerPtr interval_timer_;
@@ -73,6 +84,7 @@ protected:
     uint32_t num_unhealthy_{};
     uint32_t num_healthy_{};
     bool first_check_{true};
+    absl::optional<MonotonicTime> check_start_;
   };
 
   typedef std::unique_ptr<ActiveHealthCheckSession> ActiveHealthCheckSessionPtr;
@@ -116,6 +128,7 @@ private:
   void incHealthy();
   void incDegraded();
   std::chrono::milliseconds interval(HealthState state, HealthTransition changed_state) const;
+  std::chrono::milliseconds initialDelay(uint64_t index, uint64_t count) const;
   void onClusterMemberUpdate(const HostVector& hosts_added, const HostVector& hosts_removed);
   void refreshHealthyStat();
   void runCallbacks(HostSharedPtr host, HealthTransition changed_state);
@@ -131,6 +144,7 @@ private:
   const std::chrono::milliseconds unhealthy_interval_;
   const std::chrono::milliseconds unhealthy_edge_interval_;
   const std::chrono::milliseconds healthy_edge_interval_;
+  const bool spread_initial_checks_;
   std::unordered_map<HostSharedPtr, ActiveHealthCheckSessionPtr> active_sessions_;
   uint64_t local_process_healthy_{};
   uint64_t local_process_degraded_{};
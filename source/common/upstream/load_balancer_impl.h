@@ -483,7 +483,11 @@ public:
         default_subset_(subset_config.default_subset()),
         locality_weight_aware_(subset_config.locality_weight_aware()),
         scale_locality_weight_(subset_config.scale_locality_weight()),
-        panic_mode_any_(subset_config.panic_mode_any()) {
+        panic_mode_any_(subset_config.panic_mode_any()),
+        lazy_subset_creation_(subset_config.lazy_subset_creation()),
+        lazy_subset_idle_timeout_(
+            PROTOBUF_GET_MS_OR_DEFAULT(subset_config, lazy_subset_idle_timeout, 60000)),
+        max_lazy_subsets_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(subset_config, max_lazy_subsets, 0)) {
     for (const auto& subset : subset_config.subset_selectors()) {
       if (!subset.keys().empty()) {
         subset_keys_.emplace_back(
@@ -502,6 +506,11 @@ public:
   bool localityWeightAware() const override { return locality_weight_aware_; }
   bool scaleLocalityWeight() const override { return scale_locality_weight_; }
   bool panicModeAny() const override { return panic_mode_any_; }
+  bool lazySubsetCreation() const override { return lazy_subset_creation_; }
+  std::chrono::milliseconds lazySubsetIdleTimeout() const override {
+    return lazy_subset_idle_timeout_;
+  }
+  uint32_t maxLazySubsets() const override { return max_lazy_subsets_; }
 
 private:
   const bool enabled_;
@@ -511,6 +520,9 @@ private:
   const bool locality_weight_aware_;
   const bool scale_locality_weight_;
   const bool panic_mode_any_;
+  const bool lazy_subset_creation_;
+  const std::chrono::milliseconds lazy_subset_idle_timeout_;
+  const uint32_t max_lazy_subsets_;
 };
 
 } // namespace Upstream
@@ -16,11 +16,35 @@
 #include "common/common/utility.h"
 #include "common/http/codes.h"
 #include "common/protobuf/utility.h"
+#include "common/runtime/runtime_impl.h"
+#include "common/singleton/const_singleton.h"
 
 namespace Envoy {
 namespace Upstream {
 namespace Outlier {
 
+namespace {
+
+// Runtime keys checked on every request.
+class RuntimeKeyValues {
+public:
+  const Runtime::KeyHandle ConsecutiveGatewayFailureKey{
+      Runtime::KeyRegistry::get().registerKey("outlier_detection.consecutive_gateway_failure")};
+  const Runtime::KeyHandle Consecutive5xxKey{
+      Runtime::KeyRegistry::get().registerKey("outlier_detection.consecutive_5xx")};
+  const Runtime::KeyHandle EnforcingConsecutive5xxKey{
+      Runtime::KeyRegistry::get().registerKey("outlier_detection.enforcing_consecutive_5xx")};
+  const Runtime::KeyHandle EnforcingConsecutiveGatewayFailureKey{
+      Runtime::KeyRegistry::get().registerKey(
+          "outlier_detection.enforcing_consecutive_gateway_failure")};
+  const Runtime::KeyHandle EnforcingSuccessRateKey{
+      Runtime::KeyRegistry::get().registerKey("outlier_detection.enforcing_success_rate")};
+};
+
+using RuntimeKeys = ConstSingleton<RuntimeKeyValues>;
+
+} // namespace
+
 DetectorSharedPtr DetectorImplFactory::createForCluster(
     Cluster& cluster, const envoy::api::v2::Cluster& cluster_config, Event::Dispatcher& dispatcher,
     Runtime::Loader& runtime, EventLoggerSharedPtr event_logger) {
@@ -58,7 +82,7 @@ void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
     }
     if (Http::CodeUtility::isGatewayError(response_code)) {
       if (++consecutive_gateway_failure_ == detector->runtime().snapshot().getInteger(
-                                                "outlier_detection.consecutive_gateway_failure",
+                                                RuntimeKeys::get().ConsecutiveGatewayFailureKey,
                                                 detector->config().consecutiveGatewayFailure())) {
         detector->onConsecutiveGatewayFailure(host_.lock());
       }
@@ -67,7 +91,7 @@ void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
     }
 
     if (++consecutive_5xx_ ==
-        detector->runtime().snapshot().getInteger("outlier_detection.consecutive_5xx",
+        detector->runtime().snapshot().getInteger(RuntimeKeys::get().Consecutive5xxKey,
                                                   detector->config().consecutive5xx())) {
       detector->onConsecutive5xx(host_.lock());
     }
@@ -140,11 +164,10 @@ DetectorImpl::DetectorImpl(const Cluster& cluster,
 }
 
 DetectorImpl::~DetectorImpl() {
-  for (auto host : host_monitors_) {
-    if (host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
-      ASSERT(stats_.ejections_active_.value() > 0);
-      stats_.ejections_active_.dec();
-    }
+  for (const HostSharedPtr& host : ejected_hosts_) {
+    ASSERT(host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+    ASSERT(stats_.ejections_active_.value() > 0);
+    stats_.ejections_active_.dec();
   }
 }
 
@@ -173,7 +196,8 @@ void DetectorImpl::initialize(const Cluster& cluster) {
 
         for (const HostSharedPtr& host : hosts_removed) {
           ASSERT(host_monitors_.count(host) == 1);
-          if (host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
+          if (ejected_hosts_.erase(host) > 0) {
+            ASSERT(host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
             ASSERT(stats_.ejections_active_.value() > 0);
             stats_.ejections_active_.dec();
           }
@@ -197,43 +221,44 @@ void DetectorImpl::armIntervalTimer() {
       runtime_.snapshot().getInteger("outlier_detection.interval_ms", config_.intervalMs())));
 }
 
-void DetectorImpl::checkHostForUneject(HostSharedPtr host, DetectorHostMonitorImpl* monitor,
+bool DetectorImpl::checkHostForUneject(HostSharedPtr host, DetectorHostMonitorImpl* monitor,
                                        MonotonicTime now) {
-  if (!host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
-    return;
-  }
+  ASSERT(host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
 
   std::chrono::milliseconds base_eject_time =
       std::chrono::milliseconds(runtime_.snapshot().getInteger(
           "outlier_detection.base_ejection_time_ms", config_.baseEjectionTimeMs()));
   ASSERT(monitor->numEjections() > 0);
-  if ((base_eject_time * monitor->numEjections()) <= (now - monitor->lastEjectionTime().value())) {
-    stats_.ejections_active_.dec();
-    host->healthFlagClear(Host::HealthFlag::FAILED_OUTLIER_CHECK);
-    // Reset the consecutive failure counters to avoid re-ejection on very few new errors due
-    // to the non-triggering counter being close to its trigger value.
-    host_monitors_[host]->resetConsecutive5xx();
-    host_monitors_[host]->resetConsecutiveGatewayFailure();
-    monitor->uneject(now);
-    runCallbacks(host);
+  if ((base_eject_time * monitor->numEjections()) > (now - monitor->lastEjectionTime().value())) {
+    return false;
+  }
 
-    if (event_logger_) {
-      event_logger_->logUneject(host);
-    }
+  stats_.ejections_active_.dec();
+  host->healthFlagClear(Host::HealthFlag::FAILED_OUTLIER_CHECK);
+  // Reset the consecutive failure counters to avoid re-ejection on very few new errors due
+  // to the non-triggering counter being close to its trigger value.
+  monitor->resetConsecutive5xx();
+  monitor->resetConsecutiveGatewayFailure();
+  monitor->uneject(now);
+  runCallbacks(host);
+
+  if (event_logger_) {
+    event_logger_->logUneject(host);
   }
+  return true;
 }
 
 bool DetectorImpl::enforceEjection(envoy::data::cluster::v2alpha::OutlierEjectionType type) {
   switch (type) {
   case envoy::data::cluster::v2alpha::OutlierEjectionType::CONSECUTIVE_5XX:
-    return runtime_.snapshot().featureEnabled("outlier_detection.enforcing_consecutive_5xx",
+    return runtime_.snapshot().featureEnabled(RuntimeKeys::get().EnforcingConsecutive5xxKey,
                                               config_.enforcingConsecutive5xx());
   case envoy::data::cluster::v2alpha::OutlierEjectionType::CONSECUTIVE_GATEWAY_FAILURE:
     return runtime_.snapshot().featureEnabled(
-        "outlier_detection.enforcing_consecutive_gateway_failure",
+        RuntimeKeys::get().EnforcingConsecutiveGatewayFailureKey,
         config_.enforcingConsecutiveGatewayFailure());
   case envoy::data::cluster::v2alpha::OutlierEjectionType::SUCCESS_RATE:
-    return runtime_.snapshot().featureEnabled("outlier_detection.enforcing_success_rate",
+    return runtime_.snapshot().featureEnabled(RuntimeKeys::get().EnforcingSuccessRateKey,
                                               config_.enforcingSuccessRate());
   default:
     // Checked by schema.
@@ -280,6 +305,7 @@ void DetectorImpl::ejectHost(HostSharedPtr host,
       stats_.ejections_active_.inc();
       updateEnforcedEjectionStats(type);
       host_monitors_[host]->eject(time_source_.monotonicTime());
+      ejected_hosts_.insert(host);
       runCallbacks(host);
       if (event_logger_) {
         event_logger_->logEject(host, *this, type, true);
@@ -388,81 +414,96 @@ Utility::EjectionPair Utility::successRateEjectionThreshold(
                   variance += std::pow(v.success_rate_ - mean, 2);
                 });
   variance /= valid_success_rate_hosts.size();
-  double stdev = std::sqrt(variance);
 
-  return {mean, (mean - (success_rate_stdev_factor * stdev))};
+  return successRateEjectionThreshold(mean, variance, success_rate_stdev_factor);
 }
 
-void DetectorImpl::processSuccessRateEjections() {
-  uint64_t success_rate_minimum_hosts = runtime_.snapshot().getInteger(
-      "outlier_detection.success_rate_minimum_hosts", config_.successRateMinimumHosts());
-  uint64_t success_rate_request_volume = runtime_.snapshot().getInteger(
-      "outlier_detection.success_rate_request_volume", config_.successRateRequestVolume());
-  std::vector<HostSuccessRatePair> valid_success_rate_hosts;
-  double success_rate_sum = 0;
-
-  // Reset the Detector's success rate mean and stdev.
-  success_rate_average_ = -1;
-  success_rate_ejection_threshold_ = -1;
+Utility::EjectionPair Utility::successRateEjectionThreshold(double success_rate_mean,
+                                                           double success_rate_variance,
+                                                           double success_rate_stdev_factor) {
+  const double stdev = std::sqrt(success_rate_variance);
+  return {success_rate_mean, (success_rate_mean - (success_rate_stdev_factor * stdev))};
+}
 
-  // Exit early if there are not enough hosts.
-  if (host_monitors_.size() < success_rate_minimum_hosts) {
-    return;
+void DetectorImpl::processSuccessRateEjections(
+    const std::vector<HostSuccessRatePair>& valid_success_rate_hosts, double success_rate_mean,
+    double success_rate_variance) {
+  double success_rate_stdev_factor =
+      runtime_.snapshot().getInteger("outlier_detection.success_rate_stdev_factor",
+                                     config_.successRateStdevFactor()) /
+      1000.0;
+  Utility::EjectionPair ejection_pair = Utility::successRateEjectionThreshold(
+      success_rate_mean, success_rate_variance, success_rate_stdev_factor);
+  success_rate_average_ = ejection_pair.success_rate_average_;
+  success_rate_ejection_threshold_ = ejection_pair.ejection_threshold_;
+  for (const auto& host_success_rate_pair : valid_success_rate_hosts) {
+    if (host_success_rate_pair.success_rate_ < success_rate_ejection_threshold_) {
+      stats_.ejections_success_rate_.inc(); // Deprecated.
+      stats_.ejections_detected_success_rate_.inc();
+      ejectHost(host_success_rate_pair.host_,
+                envoy::data::cluster::v2alpha::OutlierEjectionType::SUCCESS_RATE);
+    }
   }
+}
 
-  // reserve upper bound of vector size to avoid reallocation.
-  valid_success_rate_hosts.reserve(host_monitors_.size());
+void DetectorImpl::onIntervalTimer() {
+  MonotonicTime now = time_source_.monotonicTime();
 
-  for (const auto& host : host_monitors_) {
-    // Don't do work if the host is already ejected.
-    if (!host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
-      absl::optional<double> host_success_rate =
-          host.second->successRateAccumulator().getSuccessRate(success_rate_request_volume);
-
-      if (host_success_rate) {
-        valid_success_rate_hosts.emplace_back(
-            HostSuccessRatePair(host.first, host_success_rate.value()));
-        success_rate_sum += host_success_rate.value();
-        host.second->successRate(host_success_rate.value());
-      }
+  // Only hosts that are currently ejected can be unejected, so avoid walking the whole cluster.
+  for (auto it = ejected_hosts_.begin(); it != ejected_hosts_.end();) {
+    if (checkHostForUneject(*it, host_monitors_[*it], now)) {
+      it = ejected_hosts_.erase(it);
+    } else {
+      ++it;
     }
   }
 
-  if (!valid_success_rate_hosts.empty() &&
-      valid_success_rate_hosts.size() >= success_rate_minimum_hosts) {
-    double success_rate_stdev_factor =
-        runtime_.snapshot().getInteger("outlier_detection.success_rate_stdev_factor",
-                                       config_.successRateStdevFactor()) /
-        1000.0;
-    Utility::EjectionPair ejection_pair = Utility::successRateEjectionThreshold(
-        success_rate_sum, valid_success_rate_hosts, success_rate_stdev_factor);
-    success_rate_average_ = ejection_pair.success_rate_average_;
-    success_rate_ejection_threshold_ = ejection_pair.ejection_threshold_;
-    for (const auto& host_success_rate_pair : valid_success_rate_hosts) {
-      if (host_success_rate_pair.success_rate_ < success_rate_ejection_threshold_) {
-        stats_.ejections_success_rate_.inc(); // Deprecated.
-        stats_.ejections_detected_success_rate_.inc();
-        ejectHost(host_success_rate_pair.host_,
-                  envoy::data::cluster::v2alpha::OutlierEjectionType::SUCCESS_RATE);
-      }
-    }
+  const uint64_t success_rate_minimum_hosts = runtime_.snapshot().getInteger(
+      "outlier_detection.success_rate_minimum_hosts", config_.successRateMinimumHosts());
+  const uint64_t success_rate_request_volume = runtime_.snapshot().getInteger(
+      "outlier_detection.success_rate_request_volume", config_.successRateRequestVolume());
+  // There is no point in computing success rates if there are not enough hosts.
+  const bool compute_success_rate = host_monitors_.size() >= success_rate_minimum_hosts;
+  std::vector<HostSuccessRatePair> valid_success_rate_hosts;
+  Utility::SuccessRateStats success_rate_stats;
+  if (compute_success_rate) {
+    // reserve upper bound of vector size to avoid reallocation.
+    valid_success_rate_hosts.reserve(host_monitors_.size());
   }
-}
 
-void DetectorImpl::onIntervalTimer() {
-  MonotonicTime now = time_source_.monotonicTime();
-
-  for (auto host : host_monitors_) {
-    checkHostForUneject(host.first, host.second, now);
+  // Reset the Detector's success rate mean and stdev.
+  success_rate_average_ = -1;
+  success_rate_ejection_threshold_ = -1;
 
+  // Swapping the buckets and collecting the success rates are done in the same walk over the
+  // hosts, with the mean and variance computed as we go.
+  for (const auto& host : host_monitors_) {
     // Need to update the writer bucket to keep the data valid.
     host.second->updateCurrentSuccessRateBucket();
     // Refresh host success rate stat for the /clusters endpoint. If there is a new valid value, it
-    // will get updated in processSuccessRateEjections().
+    // will get updated below.
     host.second->successRate(-1);
+
+    // Don't do work if the host is already ejected.
+    if (!compute_success_rate ||
+        host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
+      continue;
+    }
+
+    absl::optional<double> host_success_rate =
+        host.second->successRateAccumulator().getSuccessRate(success_rate_request_volume);
+    if (host_success_rate) {
+      valid_success_rate_hosts.emplace_back(host.first, host_success_rate.value());
+      success_rate_stats.add(host_success_rate.value());
+      host.second->successRate(host_success_rate.value());
+    }
   }
 
-  processSuccessRateEjections();
+  if (compute_success_rate && !valid_success_rate_hosts.empty() &&
+      valid_success_rate_hosts.size() >= success_rate_minimum_hosts) {
+    processSuccessRateEjections(valid_success_rate_hosts, success_rate_stats.mean(),
+                                success_rate_stats.variance());
+  }
 
   armIntervalTimer();
 }
@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "envoy/access_log/access_log.h"
@@ -234,7 +235,7 @@ private:
 
   void addHostMonitor(HostSharedPtr host);
   void armIntervalTimer();
-  void checkHostForUneject(HostSharedPtr host, DetectorHostMonitorImpl* monitor, MonotonicTime now);
+  bool checkHostForUneject(HostSharedPtr host, DetectorHostMonitorImpl* monitor, MonotonicTime now);
   void ejectHost(HostSharedPtr host, envoy::data::cluster::v2alpha::OutlierEjectionType type);
   static DetectionStats generateStats(Stats::Scope& scope);
   void initialize(const Cluster& cluster);
@@ -246,7 +247,8 @@ private:
   void runCallbacks(HostSharedPtr host);
   bool enforceEjection(envoy::data::cluster::v2alpha::OutlierEjectionType type);
   void updateEnforcedEjectionStats(envoy::data::cluster::v2alpha::OutlierEjectionType type);
-  void processSuccessRateEjections();
+  void processSuccessRateEjections(const std::vector<HostSuccessRatePair>& valid_success_rate_hosts,
+                                   double success_rate_mean, double success_rate_variance);
 
   DetectorConfig config_;
   Event::Dispatcher& dispatcher_;
@@ -256,6 +258,8 @@ private:
   Event::TimerPtr interval_timer_;
   std::list<ChangeStateCb> callbacks_;
   std::unordered_map<HostSharedPtr, DetectorHostMonitorImpl*> host_monitors_;
+  // Hosts currently ejected by this detector. Only these need to be checked for unejection.
+  std::unordered_set<HostSharedPtr> ejected_hosts_;
   EventLoggerSharedPtr event_logger_;
   double success_rate_average_;
   double success_rate_ejection_threshold_;
@@ -292,6 +296,42 @@ public:
     double ejection_threshold_;
   };
 
+  /**
+   * Single pass mean and variance of a stream of success rates, using Welford's algorithm so that
+   * the detector does not need a second walk over the hosts to compute the variance.
+   */
+  class SuccessRateStats {
+  public:
+    void add(double success_rate) {
+      count_++;
+      const double delta = success_rate - mean_;
+      mean_ += delta / count_;
+      sum_squared_deltas_ += delta * (success_rate - mean_);
+    }
+
+    uint64_t count() const { return count_; }
+    double mean() const { return mean_; }
+    double variance() const { return count_ > 0 ? sum_squared_deltas_ / count_ : 0; }
+
+  private:
+    uint64_t count_{};
+    double mean_{};
+    double sum_squared_deltas_{};
+  };
+
+  /**
+   * This function returns an EjectionPair for success rate outlier detection given the mean and
+   * variance of the success rate of all valid hosts in the cluster.
+   * @param success_rate_mean is the mean success rate of the valid hosts.
+   * @param success_rate_variance is the population variance of the valid hosts' success rates.
+   * @param success_rate_stdev_factor is the number of standard deviations below the mean at which
+   *        a host becomes an outlier.
+   * @return EjectionPair.
+   */
+  static EjectionPair successRateEjectionThreshold(double success_rate_mean,
+                                                   double success_rate_variance,
+                                                   double success_rate_stdev_factor);
+
   /**
    * This function returns an EjectionPair for success rate outlier detection. The pair contains
    * the average success rate of all valid hosts in the cluster and the ejection threshold.
@@ -5,6 +5,7 @@
 
 #include "envoy/api/v2/cds.pb.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/stats/timespan.h"
 
 #include "common/common/assert.h"
 #include "common/config/metadata.h"
@@ -23,16 +24,20 @@ SubsetLoadBalancer::SubsetLoadBalancer(
     Runtime::RandomGenerator& random, const LoadBalancerSubsetInfo& subsets,
     const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>& lb_ring_hash_config,
     const absl::optional<envoy::api::v2::Cluster::LeastRequestLbConfig>& least_request_config,
-    const envoy::api::v2::Cluster::CommonLbConfig& common_config)
+    const envoy::api::v2::Cluster::CommonLbConfig& common_config, TimeSource& time_source)
     : lb_type_(lb_type), lb_ring_hash_config_(lb_ring_hash_config),
       least_request_config_(least_request_config), common_config_(common_config), stats_(stats),
-      scope_(scope), runtime_(runtime), random_(random), fallback_policy_(subsets.fallbackPolicy()),
+      scope_(scope), runtime_(runtime), random_(random), time_source_(time_source),
+      fallback_policy_(subsets.fallbackPolicy()),
       default_subset_metadata_(subsets.defaultSubset().fields().begin(),
                                subsets.defaultSubset().fields().end()),
       subset_keys_(subsets.subsetKeys()), original_priority_set_(priority_set),
       original_local_priority_set_(local_priority_set),
       locality_weight_aware_(subsets.localityWeightAware()),
-      scale_locality_weight_(subsets.scaleLocalityWeight()) {
+      scale_locality_weight_(subsets.scaleLocalityWeight()),
+      lazy_subset_creation_(subsets.lazySubsetCreation()),
+      lazy_subset_idle_timeout_(subsets.lazySubsetIdleTimeout()),
+      max_lazy_subsets_(subsets.maxLazySubsets()) {
   ASSERT(subsets.isEnabled());
 
   if (fallback_policy_ != envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK) {
@@ -155,6 +160,15 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
 
   // Route has metadata match criteria defined, see if we have a matching subset.
   LbSubsetEntryPtr entry = findSubset(match_criteria->metadataMatchCriteria());
+  if (entry != nullptr && lazy_subset_creation_) {
+    if (!entry->initialized()) {
+      materializeSubset(entry);
+    }
+    if (entry->initialized()) {
+      markSubsetSelected(entry);
+    }
+  }
+
   if (entry == nullptr || !entry->active()) {
     // No matching subset or subset not active: use fallback policy.
     return nullptr;
@@ -204,6 +218,64 @@ SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
   return nullptr;
 }
 
+// Builds the host subset and load balancer for an entry that was discovered during a host update
+// but not yet materialized. Entries whose key-values never matched a complete subset selector have
+// no metadata and are left uninitialized.
+void SubsetLoadBalancer::materializeSubset(const LbSubsetEntryPtr& entry) {
+  ASSERT(lazy_subset_creation_ && !entry->initialized());
+  if (entry->metadata_.empty()) {
+    return;
+  }
+
+  ENVOY_LOG(debug, "subset lb: lazily creating load balancer for {}",
+            describeMetadata(entry->metadata_));
+
+  const SubsetMetadata& kvs = entry->metadata_;
+  HostPredicate predicate = [this, kvs](const Host& host) -> bool {
+    return hostMatches(kvs, host);
+  };
+
+  entry->priority_subset_ = std::make_shared<PrioritySubsetImpl>(
+      *this, predicate, locality_weight_aware_, scale_locality_weight_);
+  if (entry->active()) {
+    stats_.lb_subsets_active_.inc();
+    stats_.lb_subsets_created_.inc();
+  }
+
+  entry->lru_it_ = lazy_subsets_lru_.insert(lazy_subsets_lru_.begin(), entry);
+  if (max_lazy_subsets_ > 0 && lazy_subsets_lru_.size() > max_lazy_subsets_) {
+    // Copy the pointer since evictSubset() erases it from the list.
+    LbSubsetEntryPtr lru_entry = lazy_subsets_lru_.back();
+    evictSubset(lru_entry);
+  }
+}
+
+void SubsetLoadBalancer::markSubsetSelected(const LbSubsetEntryPtr& entry) {
+  entry->last_selected_ = time_source_.monotonicTime();
+  lazy_subsets_lru_.splice(lazy_subsets_lru_.begin(), lazy_subsets_lru_, entry->lru_it_);
+}
+
+// Drops the host subset and load balancer of a lazily created subset. The entry remains in the
+// subset hierarchy and will be materialized again the next time it is selected.
+void SubsetLoadBalancer::evictSubset(const LbSubsetEntryPtr& entry) {
+  ASSERT(lazy_subset_creation_ && entry->initialized());
+  ENVOY_LOG(debug, "subset lb: evicting load balancer for {}",
+            describeMetadata(entry->metadata_));
+
+  if (entry->active()) {
+    stats_.lb_subsets_active_.dec();
+  }
+  stats_.lb_subsets_evicted_.inc();
+
+  lazy_subsets_lru_.erase(entry->lru_it_);
+  entry->lru_it_ = lazy_subsets_lru_.end();
+  entry->priority_subset_.reset();
+}
+
+bool SubsetLoadBalancer::subsetIdle(const LbSubsetEntry& entry) const {
+  return time_source_.monotonicTime() - entry.last_selected_ > lazy_subset_idle_timeout_;
+}
+
 void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
                                               const HostVector& hosts_removed) {
   if (fallback_subset_ == nullptr) {
@@ -279,11 +351,18 @@ void SubsetLoadBalancer::processSubsets(
 // new subsets as necessary.
 void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added,
                                 const HostVector& hosts_removed) {
+  Stats::Timespan rebuild_timer(stats_.lb_subsets_rebuild_ms_, time_source_);
   updateFallbackSubset(priority, hosts_added, hosts_removed);
 
   processSubsets(
       hosts_added, hosts_removed,
       [&](LbSubsetEntryPtr entry) {
+        if (lazy_subset_creation_ && subsetIdle(*entry)) {
+          // Rather than rebuilding an idle subset, drop it and rebuild it on demand.
+          evictSubset(entry);
+          return;
+        }
+
         const bool active_before = entry->active();
         entry->priority_subset_->update(priority, hosts_added, hosts_removed);
 
@@ -298,6 +377,14 @@ void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added
       [&](LbSubsetEntryPtr entry, HostPredicate predicate, const SubsetMetadata& kvs,
           bool adding_host) {
         UNREFERENCED_PARAMETER(kvs);
+        if (lazy_subset_creation_) {
+          // Remember the key-values so the subset can be materialized when first selected.
+          if (adding_host && entry->metadata_.empty()) {
+            entry->metadata_ = kvs;
+          }
+          return;
+        }
+
         if (adding_host) {
           ENVOY_LOG(debug, "subset lb: creating load balancer for {}", describeMetadata(kvs));
 
@@ -310,6 +397,8 @@ void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added
           stats_.lb_subsets_created_.inc();
         }
       });
+
+  rebuild_timer.complete();
 }
 
 bool SubsetLoadBalancer::hostMatches(const SubsetMetadata& kvs, const Host& host) {
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
+#include "envoy/common/time.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
 #include "envoy/upstream/load_balancer.h"
@@ -28,7 +30,7 @@ public:
       Runtime::RandomGenerator& random, const LoadBalancerSubsetInfo& subsets,
       const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>& lb_ring_hash_config,
       const absl::optional<envoy::api::v2::Cluster::LeastRequestLbConfig>& least_request_config,
-      const envoy::api::v2::Cluster::CommonLbConfig& common_config);
+      const envoy::api::v2::Cluster::CommonLbConfig& common_config, TimeSource& time_source);
   ~SubsetLoadBalancer();
 
   // Upstream::LoadBalancer
@@ -114,6 +116,7 @@ private:
   typedef std::shared_ptr<LbSubsetEntry> LbSubsetEntryPtr;
   typedef std::unordered_map<HashedValue, LbSubsetEntryPtr> ValueSubsetMap;
   typedef std::unordered_map<std::string, ValueSubsetMap> LbSubsetMap;
+  typedef std::list<LbSubsetEntryPtr> LbSubsetEntryList;
 
   // Entry in the subset hierarchy.
   class LbSubsetEntry {
@@ -127,6 +130,13 @@ private:
 
     // Only initialized if a match exists at this level.
     PrioritySubsetImplPtr priority_subset_;
+
+    // The following are only used with lazy subset creation. The metadata is only set if some
+    // host matched this entry's key-values, in which case the subset may be materialized on
+    // demand.
+    SubsetMetadata metadata_;
+    MonotonicTime last_selected_;
+    LbSubsetEntryList::iterator lru_it_;
   };
 
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
@@ -145,6 +155,12 @@ private:
 
   HostConstSharedPtr tryChooseHostFromContext(LoadBalancerContext* context, bool& host_chosen);
 
+  // Lazy subset creation.
+  void materializeSubset(const LbSubsetEntryPtr& entry);
+  void markSubsetSelected(const LbSubsetEntryPtr& entry);
+  void evictSubset(const LbSubsetEntryPtr& entry);
+  bool subsetIdle(const LbSubsetEntry& entry) const;
+
   bool hostMatches(const SubsetMetadata& kvs, const Host& host);
 
   LbSubsetEntryPtr
@@ -165,6 +181,7 @@ private:
   Stats::Scope& scope_;
   Runtime::Loader& runtime_;
   Runtime::RandomGenerator& random_;
+  TimeSource& time_source_;
 
   const envoy::api::v2::Cluster::LbSubsetConfig::LbSubsetFallbackPolicy fallback_policy_;
   const SubsetMetadata default_subset_metadata_;
@@ -183,6 +200,12 @@ private:
   const bool locality_weight_aware_;
   const bool scale_locality_weight_;
 
+  const bool lazy_subset_creation_;
+  const std::chrono::milliseconds lazy_subset_idle_timeout_;
+  const uint32_t max_lazy_subsets_;
+  // Materialized lazy subsets, most recently selected first.
+  LbSubsetEntryList lazy_subsets_lru_;
+
   friend class SubsetLoadBalancerDescribeMetadataTester;
 };
 
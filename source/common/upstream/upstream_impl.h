@@ -549,6 +549,10 @@ public:
 
   bool drainConnectionsOnHostRemoval() const override { return drain_connections_on_host_removal_; }
 
+  float perUpstreamPrefetchRatio() const override { return per_upstream_prefetch_ratio_; }
+
+  bool prewarmNewHosts() const override { return prewarm_new_hosts_; }
+
   absl::optional<std::string> eds_service_name() const override { return eds_service_name_; }
 
 private:
@@ -593,6 +597,8 @@ private:
   const envoy::api::v2::Cluster::CommonLbConfig common_lb_config_;
   const Network::ConnectionSocket::OptionsSharedPtr cluster_socket_options_;
   const bool drain_connections_on_host_removal_;
+  const float per_upstream_prefetch_ratio_;
+  const bool prewarm_new_hosts_;
   absl::optional<std::string> eds_service_name_;
 };
 
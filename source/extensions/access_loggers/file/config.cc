@@ -39,9 +39,12 @@ FileAccessLogFactory::createAccessLogInstance(const Protobuf::Message& config,
              envoy::config::accesslog::v2::FileAccessLog::kJsonFormat) {
     auto json_format_map = this->convertJsonFormatToMap(fal_config.json_format());
     formatter = std::make_unique<AccessLog::JsonFormatterImpl>(json_format_map);
+  } else if (fal_config.access_log_format_case() ==
+             envoy::config::accesslog::v2::FileAccessLog::kBinaryFormat) {
+    formatter = std::make_unique<BinaryFormatter>(fal_config.binary_format());
   } else {
-    throw EnvoyException(
-        "Invalid access_log format provided. Only 'format' and 'json_format' are supported.");
+    throw EnvoyException("Invalid access_log format provided. Only 'format', 'json_format' and "
+                         "'binary_format' are supported.");
   }
 
   return std::make_shared<FileAccessLog>(fal_config.path(), std::move(filter), std::move(formatter),
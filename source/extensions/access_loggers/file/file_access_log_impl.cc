@@ -1,6 +1,7 @@
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
 #include "common/http/header_map_impl.h"
+#include "common/protobuf/protobuf.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -39,6 +40,30 @@ void FileAccessLog::log(const Http::HeaderMap* request_headers,
       formatter_->format(*request_headers, *response_headers, *response_trailers, stream_info));
 }
 
+BinaryFormatter::BinaryFormatter(
+    const envoy::config::accesslog::v2::FileAccessLog::BinaryFormat& config)
+    : entry_builder_(config.additional_request_headers_to_log(),
+                     config.additional_response_headers_to_log(),
+                     config.additional_response_trailers_to_log()) {}
+
+std::string BinaryFormatter::format(const Http::HeaderMap& request_headers,
+                                    const Http::HeaderMap& response_headers,
+                                    const Http::HeaderMap& response_trailers,
+                                    const StreamInfo::StreamInfo& stream_info) const {
+  envoy::data::accesslog::v2::HTTPAccessLogEntry log_entry;
+  entry_builder_.build(request_headers, response_headers, response_trailers, stream_info,
+                       log_entry);
+
+  std::string output;
+  {
+    Protobuf::io::StringOutputStream stream(&output);
+    Protobuf::io::CodedOutputStream coded_stream(&stream);
+    coded_stream.WriteVarint32(log_entry.ByteSize());
+    log_entry.SerializeWithCachedSizes(&coded_stream);
+  }
+  return output;
+}
+
 } // namespace File
 } // namespace AccessLoggers
 } // namespace Extensions
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "envoy/access_log/access_log.h"
+#include "envoy/config/accesslog/v2/file.pb.h"
+
+#include "extensions/access_loggers/common/http_log_entry.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -26,6 +29,24 @@ private:
   AccessLog::FormatterPtr formatter_;
 };
 
+/**
+ * Formatter that writes each log entry as a binary HTTPAccessLogEntry prefixed by its length as a
+ * varint, so that the log can be read back with the standard delimited protobuf parsers.
+ */
+class BinaryFormatter : public AccessLog::Formatter {
+public:
+  BinaryFormatter(const envoy::config::accesslog::v2::FileAccessLog::BinaryFormat& config);
+
+  // AccessLog::Formatter
+  std::string format(const Http::HeaderMap& request_headers,
+                     const Http::HeaderMap& response_headers,
+                     const Http::HeaderMap& response_trailers,
+                     const StreamInfo::StreamInfo& stream_info) const override;
+
+private:
+  const Common::HttpLogEntryBuilder entry_builder_;
+};
+
 } // namespace File
 } // namespace AccessLoggers
 } // namespace Extensions
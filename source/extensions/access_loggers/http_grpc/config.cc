@@ -37,7 +37,7 @@ HttpGrpcAccessLogFactory::createAccessLogInstance(const Protobuf::Message& confi
           });
 
   return std::make_shared<HttpGrpcAccessLog>(std::move(filter), proto_config,
-                                             grpc_access_log_streamer);
+                                             context.threadLocal(), grpc_access_log_streamer);
 }
 
 ProtobufTypes::MessagePtr HttpGrpcAccessLogFactory::createEmptyConfigProto() {
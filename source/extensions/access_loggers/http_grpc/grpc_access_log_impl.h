@@ -1,7 +1,6 @@
 #pragma once
 
 #include <unordered_map>
-#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/config/accesslog/v2/als.pb.h"
@@ -13,6 +12,8 @@
 #include "envoy/singleton/instance.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "extensions/access_loggers/common/http_log_entry.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace AccessLoggers {
@@ -109,30 +110,52 @@ private:
 };
 
 /**
- * Access log Instance that streams HTTP logs over gRPC.
+ * Access log Instance that streams HTTP logs over gRPC. If buffer_size_bytes is set, each thread
+ * batches log entries into a single message that is sent once it reaches the buffer size or the
+ * flush interval elapses.
  */
 class HttpGrpcAccessLog : public AccessLog::Instance {
 public:
   HttpGrpcAccessLog(AccessLog::FilterPtr&& filter,
                     const envoy::config::accesslog::v2::HttpGrpcAccessLogConfig& config,
+                    ThreadLocal::SlotAllocator& tls,
                     GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer);
 
-  static void responseFlagsToAccessLogResponseFlags(
-      envoy::data::accesslog::v2::AccessLogCommon& common_access_log,
-      const StreamInfo::StreamInfo& stream_info);
-
   // AccessLog::Instance
   void log(const Http::HeaderMap* request_headers, const Http::HeaderMap* response_headers,
            const Http::HeaderMap* response_trailers,
            const StreamInfo::StreamInfo& stream_info) override;
 
 private:
+  /**
+   * Per-thread batch of log entries. This does not reference the access log, as it may be
+   * destroyed on the worker after the access log is gone.
+   */
+  struct ThreadLocalLogger : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalLogger(GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer,
+                      const std::string& log_name, uint64_t buffer_size_bytes,
+                      std::chrono::milliseconds buffer_flush_interval,
+                      Event::Dispatcher& dispatcher);
+    // Sends any buffered entries. The slot destroys this on the owning thread, so the entries go
+    // out on that thread's stream instead of being dropped when the access log is removed.
+    ~ThreadLocalLogger();
+
+    void log(envoy::data::accesslog::v2::HTTPAccessLogEntry&& entry);
+    void flush();
+
+    const GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer_;
+    const std::string log_name_;
+    const uint64_t buffer_size_bytes_;
+    const std::chrono::milliseconds buffer_flush_interval_;
+    envoy::service::accesslog::v2::StreamAccessLogsMessage message_;
+    uint64_t approximate_message_size_bytes_{};
+    Event::TimerPtr flush_timer_;
+  };
+
   AccessLog::FilterPtr filter_;
   const envoy::config::accesslog::v2::HttpGrpcAccessLogConfig config_;
-  GrpcAccessLogStreamerSharedPtr grpc_access_log_streamer_;
-  std::vector<Http::LowerCaseString> request_headers_to_log_;
-  std::vector<Http::LowerCaseString> response_headers_to_log_;
-  std::vector<Http::LowerCaseString> response_trailers_to_log_;
+  const Common::HttpLogEntryBuilder entry_builder_;
+  ThreadLocal::SlotPtr tls_slot_;
 };
 
 } // namespace HttpGrpc
@@ -16,6 +16,7 @@
 #include "common/buffer/watermark_buffer.h"
 #include "common/common/token_bucket_impl.h"
 #include "common/http/header_utility.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "extensions/filters/common/fault/fault_config.h"
 
@@ -195,12 +196,18 @@ public:
 private:
   class RuntimeKeyValues {
   public:
-    const std::string DelayPercentKey = "fault.http.delay.fixed_delay_percent";
-    const std::string AbortPercentKey = "fault.http.abort.abort_percent";
-    const std::string DelayDurationKey = "fault.http.delay.fixed_duration_ms";
-    const std::string AbortHttpStatusKey = "fault.http.abort.http_status";
-    const std::string MaxActiveFaultsKey = "fault.http.max_active_faults";
-    const std::string ResponseRateLimitPercentKey = "fault.http.rate_limit.response_percent";
+    const Runtime::KeyHandle DelayPercentKey{
+        Runtime::KeyRegistry::get().registerKey("fault.http.delay.fixed_delay_percent")};
+    const Runtime::KeyHandle AbortPercentKey{
+        Runtime::KeyRegistry::get().registerKey("fault.http.abort.abort_percent")};
+    const Runtime::KeyHandle DelayDurationKey{
+        Runtime::KeyRegistry::get().registerKey("fault.http.delay.fixed_duration_ms")};
+    const Runtime::KeyHandle AbortHttpStatusKey{
+        Runtime::KeyRegistry::get().registerKey("fault.http.abort.http_status")};
+    const Runtime::KeyHandle MaxActiveFaultsKey{
+        Runtime::KeyRegistry::get().registerKey("fault.http.max_active_faults")};
+    const Runtime::KeyHandle ResponseRateLimitPercentKey{
+        Runtime::KeyRegistry::get().registerKey("fault.http.rate_limit.response_percent")};
   };
 
   using RuntimeKeys = ConstSingleton<RuntimeKeyValues>;
@@ -2,7 +2,9 @@
 
 #include <arpa/inet.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -61,11 +63,10 @@ bssl::UniquePtr<SSL> Config::newSsl() { return bssl::UniquePtr<SSL>{SSL_new(ssl_
 
 thread_local uint8_t Filter::buf_[Config::TLS_MAX_CLIENT_HELLO];
 
-Filter::Filter(const ConfigSharedPtr config) : config_(config), ssl_(config_->newSsl()) {
-  RELEASE_ASSERT(sizeof(buf_) >= config_->maxClientHelloSize(), "");
+constexpr size_t Filter::MAX_EXTENSIONS;
 
-  SSL_set_app_data(ssl_.get(), this);
-  SSL_set_accept_state(ssl_.get());
+Filter::Filter(const ConfigSharedPtr config) : config_(config) {
+  RELEASE_ASSERT(sizeof(buf_) >= config_->maxClientHelloSize(), "");
 }
 
 Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
@@ -152,12 +153,204 @@ void Filter::onRead() {
   // skip over what we've already processed.
   if (static_cast<uint64_t>(result.rc_) > read_) {
     const uint8_t* data = buf_ + read_;
-    const size_t len = result.rc_ - read_;
+    size_t len = result.rc_ - read_;
     read_ = result.rc_;
+
+    if (ssl_ == nullptr) {
+      // The peeked data always starts at the beginning of the connection, so the ClientHello is
+      // parsed in place from the whole buffer on each read.
+      switch (parseClientHelloRecord(buf_, read_)) {
+      case ParseState::Continue:
+        onClientHelloIncomplete();
+        return;
+      case ParseState::Done:
+        onClientHelloComplete();
+        return;
+      case ParseState::Fallback:
+        ENVOY_LOG(trace, "tls inspector: falling back to BoringSSL to parse ClientHello");
+        ssl_ = config_->newSsl();
+        SSL_set_app_data(ssl_.get(), this);
+        SSL_set_accept_state(ssl_.get());
+        data = buf_;
+        len = read_;
+        break;
+      }
+    }
     parseClientHello(data, len);
   }
 }
 
+Filter::ParseState Filter::parseClientHelloRecord(const uint8_t* data, size_t len) {
+  ASSERT(len > 0);
+  const uint8_t content_type = data[0];
+  if (content_type != SSL3_RT_HANDSHAKE) {
+    // Let BoringSSL decide what to do with other record types and with what could be an SSLv2
+    // compatible ClientHello. Anything else, such as plaintext HTTP, is not TLS.
+    if ((content_type >= SSL3_RT_CHANGE_CIPHER_SPEC && content_type <= SSL3_RT_APPLICATION_DATA) ||
+        (content_type & 0x80) != 0) {
+      return ParseState::Fallback;
+    }
+    return ParseState::Done;
+  }
+
+  CBS cbs;
+  CBS_init(&cbs, data, len);
+  uint16_t record_version;
+  uint16_t record_len;
+  if (!CBS_skip(&cbs, 1) || !CBS_get_u16(&cbs, &record_version) ||
+      !CBS_get_u16(&cbs, &record_len)) {
+    return ParseState::Continue;
+  }
+  if ((record_version >> 8) != SSL3_VERSION_MAJOR || record_len > SSL3_RT_MAX_PLAIN_LENGTH ||
+      record_len < SSL3_HM_HEADER_LENGTH) {
+    return ParseState::Fallback;
+  }
+
+  uint8_t msg_type;
+  uint32_t msg_len;
+  if (!CBS_get_u8(&cbs, &msg_type) || !CBS_get_u24(&cbs, &msg_len)) {
+    return ParseState::Continue;
+  }
+  if (msg_type != SSL3_MT_CLIENT_HELLO || SSL3_HM_HEADER_LENGTH + msg_len > record_len) {
+    // The ClientHello continues in another record.
+    return ParseState::Fallback;
+  }
+  CBS client_hello;
+  if (!CBS_get_bytes(&cbs, &client_hello, msg_len)) {
+    return ParseState::Continue;
+  }
+
+  // The fixed fields and the server_name, ALPN and supported_versions extensions are checked the way
+  // BoringSSL checks them, and anything unusual in them is left to BoringSSL. The contents of other
+  // extensions are not validated, so unlike BoringSSL a ClientHello with, e.g., a malformed
+  // key_share is still reported as TLS, and is then rejected by the TLS transport socket.
+  uint16_t legacy_version;
+  CBS session_id, cipher_suites, compression_methods;
+  if (!CBS_get_u16(&client_hello, &legacy_version) || legacy_version < TLS1_VERSION ||
+      !CBS_skip(&client_hello, SSL3_RANDOM_SIZE) ||
+      !CBS_get_u8_length_prefixed(&client_hello, &session_id) ||
+      CBS_len(&session_id) > SSL_MAX_SSL_SESSION_ID_LENGTH ||
+      !CBS_get_u16_length_prefixed(&client_hello, &cipher_suites) ||
+      CBS_len(&cipher_suites) < 2 || CBS_len(&cipher_suites) % 2 != 0 ||
+      !CBS_get_u8_length_prefixed(&client_hello, &compression_methods) ||
+      CBS_len(&compression_methods) != 1 || CBS_data(&compression_methods)[0] != 0) {
+    return ParseState::Fallback;
+  }
+
+  CBS extensions;
+  CBS_init(&extensions, nullptr, 0);
+  if (CBS_len(&client_hello) != 0 &&
+      (!CBS_get_u16_length_prefixed(&client_hello, &extensions) || CBS_len(&client_hello) != 0)) {
+    return ParseState::Fallback;
+  }
+
+  uint16_t seen[MAX_EXTENSIONS];
+  size_t num_seen = 0;
+  absl::string_view server_name;
+  CBS alpn;
+  bool has_alpn = false;
+  uint16_t max_version = legacy_version;
+  while (CBS_len(&extensions) != 0) {
+    uint16_t type;
+    CBS extension;
+    if (!CBS_get_u16(&extensions, &type) ||
+        !CBS_get_u16_length_prefixed(&extensions, &extension) || num_seen == MAX_EXTENSIONS ||
+        std::find(seen, seen + num_seen, type) != seen + num_seen) {
+      return ParseState::Fallback;
+    }
+    seen[num_seen++] = type;
+
+    switch (type) {
+    case TLSEXT_TYPE_server_name: {
+      CBS server_name_list, host_name;
+      uint8_t name_type;
+      if (!CBS_get_u16_length_prefixed(&extension, &server_name_list) ||
+          !CBS_get_u8(&server_name_list, &name_type) ||
+          !CBS_get_u16_length_prefixed(&server_name_list, &host_name) ||
+          CBS_len(&server_name_list) != 0 || CBS_len(&extension) != 0 ||
+          name_type != TLSEXT_NAMETYPE_host_name || CBS_len(&host_name) == 0 ||
+          CBS_len(&host_name) > TLSEXT_MAXLEN_host_name || CBS_contains_zero_byte(&host_name)) {
+        return ParseState::Fallback;
+      }
+      server_name = absl::string_view(reinterpret_cast<const char*>(CBS_data(&host_name)),
+                                      CBS_len(&host_name));
+      break;
+    }
+    case TLSEXT_TYPE_application_layer_protocol_negotiation: {
+      // Checked the way BoringSSL checks it; a malformed list is left to BoringSSL.
+      alpn = extension;
+      has_alpn = true;
+      CBS protocol_name_list, protocol_name;
+      if (!CBS_get_u16_length_prefixed(&extension, &protocol_name_list) ||
+          CBS_len(&extension) != 0 || CBS_len(&protocol_name_list) < 2) {
+        return ParseState::Fallback;
+      }
+      while (CBS_len(&protocol_name_list) != 0) {
+        if (!CBS_get_u8_length_prefixed(&protocol_name_list, &protocol_name) ||
+            CBS_len(&protocol_name) == 0) {
+          return ParseState::Fallback;
+        }
+      }
+      break;
+    }
+    case TLSEXT_TYPE_supported_versions: {
+      CBS versions;
+      if (!CBS_get_u8_length_prefixed(&extension, &versions) || CBS_len(&extension) != 0 ||
+          CBS_len(&versions) == 0 || CBS_len(&versions) % 2 != 0) {
+        return ParseState::Fallback;
+      }
+      max_version = 0;
+      while (CBS_len(&versions) != 0) {
+        uint16_t version;
+        CBS_get_u16(&versions, &version);
+        // Skip GREASE and other versions that can't be negotiated.
+        if (version >= TLS1_VERSION && version <= TLS1_3_VERSION) {
+          max_version = std::max(max_version, version);
+        }
+      }
+      if (max_version == 0) {
+        return ParseState::Fallback;
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  ENVOY_LOG(trace, "tls inspector: parsed ClientHello, version: {:#x}, sni: {}", max_version,
+            server_name);
+  if (has_alpn) {
+    onALPN(CBS_data(&alpn), CBS_len(&alpn));
+  }
+  onServername(server_name);
+  return ParseState::Done;
+}
+
+void Filter::onClientHelloIncomplete() {
+  if (read_ == config_->maxClientHelloSize()) {
+    // We've hit the specified size limit. This is an unreasonably large ClientHello;
+    // indicate failure.
+    config_->stats().client_hello_too_large_.inc();
+    done(false);
+  }
+}
+
+void Filter::onClientHelloComplete() {
+  if (clienthello_success_) {
+    config_->stats().tls_found_.inc();
+    if (alpn_found_) {
+      config_->stats().alpn_found_.inc();
+    } else {
+      config_->stats().alpn_not_found_.inc();
+    }
+    cb_->socket().setDetectedTransportProtocol(TransportSockets::TransportSocketNames::get().Tls);
+  } else {
+    config_->stats().tls_not_found_.inc();
+  }
+  done(true);
+}
+
 void Filter::done(bool success) {
   ENVOY_LOG(trace, "tls inspector: done: {}", success);
   file_event_.reset();
@@ -181,26 +374,10 @@ void Filter::parseClientHello(const void* data, size_t len) {
   ASSERT(ret <= 0);
   switch (SSL_get_error(ssl_.get(), ret)) {
   case SSL_ERROR_WANT_READ:
-    if (read_ == config_->maxClientHelloSize()) {
-      // We've hit the specified size limit. This is an unreasonably large ClientHello;
-      // indicate failure.
-      config_->stats().client_hello_too_large_.inc();
-      done(false);
-    }
+    onClientHelloIncomplete();
     break;
   case SSL_ERROR_SSL:
-    if (clienthello_success_) {
-      config_->stats().tls_found_.inc();
-      if (alpn_found_) {
-        config_->stats().alpn_found_.inc();
-      } else {
-        config_->stats().alpn_not_found_.inc();
-      }
-      cb_->socket().setDetectedTransportProtocol(TransportSockets::TransportSocketNames::get().Tls);
-    } else {
-      config_->stats().tls_not_found_.inc();
-    }
-    done(true);
+    onClientHelloComplete();
     break;
   default:
     done(false);
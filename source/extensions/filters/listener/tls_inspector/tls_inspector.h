@@ -68,8 +68,21 @@ public:
   Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
 
 private:
+  enum class ParseState {
+    // More data is needed before the ClientHello can be parsed.
+    Continue,
+    // The ClientHello has been parsed, or the data was found not to be TLS.
+    Done,
+    // The data could not be handled without the full TLS stack, e.g. a malformed ClientHello or
+    // one split across multiple records.
+    Fallback,
+  };
+
+  ParseState parseClientHelloRecord(const uint8_t* data, size_t len);
   void parseClientHello(const void* data, size_t len);
   void onRead();
+  void onClientHelloIncomplete();
+  void onClientHelloComplete();
   void done(bool success);
   void onALPN(const unsigned char* data, unsigned int len);
   void onServername(absl::string_view name);
@@ -78,6 +91,7 @@ private:
   Network::ListenerFilterCallbacks* cb_;
   Event::FileEventPtr file_event_;
 
+  // Only created when the ClientHello cannot be parsed by parseClientHelloRecord().
   bssl::UniquePtr<SSL> ssl_;
   uint64_t read_{0};
   bool alpn_found_{false};
@@ -85,6 +99,9 @@ private:
 
   static thread_local uint8_t buf_[Config::TLS_MAX_CLIENT_HELLO];
 
+  // The most extensions parseClientHelloRecord() checks for duplicates before falling back.
+  static constexpr size_t MAX_EXTENSIONS = 64;
+
   // Allows callbacks on the SSL_CTX to set fields in this class.
   friend class Config;
 };
@@ -14,6 +14,8 @@
 #include "common/common/utility.h"
 #include "common/config/utility.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace StatSinks {
@@ -38,32 +40,117 @@ void Writer::write(const std::string& message) {
   ::send(io_handle_->fd(), message.c_str(), message.size(), MSG_DONTWAIT);
 }
 
+StatCache::Entry& StatCache::get(std::shared_ptr<const Stats::Metric> metric) {
+  const Stats::Metric* key = metric.get();
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    it = entries_.emplace(key, CachedStat{std::move(metric), generation_, {}}).first;
+  }
+  it->second.generation_ = generation_;
+  return it->second.entry_;
+}
+
+void StatCache::endFlush() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.generation_ != generation_) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
-                             const std::string& prefix)
+                             const std::string& prefix, uint64_t max_bytes_per_datagram,
+                             bool changed_stats_only)
     : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag),
-      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix) {
+      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      max_bytes_per_datagram_(max_bytes_per_datagram), changed_stats_only_(changed_stats_only) {
   tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<Writer>(this->server_address_);
   });
 }
 
+void UdpStatsdSink::Batch::add(const std::string& line) {
+  if (max_bytes_ == 0) {
+    writer_.write(line);
+    return;
+  }
+
+  // Lines are newline separated within a datagram. A line that doesn't fit in a datagram on its
+  // own is still sent, by itself.
+  if (!buffer_.empty() && buffer_.size() + 1 + line.size() > max_bytes_) {
+    send();
+  }
+  if (!buffer_.empty()) {
+    buffer_.push_back('\n');
+  }
+  buffer_.append(line);
+}
+
+void UdpStatsdSink::Batch::send() {
+  if (!buffer_.empty()) {
+    writer_.write(buffer_);
+    buffer_.clear();
+  }
+}
+
 void UdpStatsdSink::flush(Stats::Source& source) {
-  Writer& writer = tls_->getTyped<Writer>();
+  Batch batch(tls_->getTyped<Writer>(), max_bytes_per_datagram_);
+  if (changed_stats_only_) {
+    stat_cache_.beginFlush();
+  }
+
   for (const Stats::CounterSharedPtr& counter : source.cachedCounters()) {
     if (counter->used()) {
-      uint64_t delta = counter->latch();
-      writer.write(fmt::format("{}.{}:{}|c{}", prefix_, getName(*counter), delta,
-                               buildTagStr(counter->tags())));
+      const uint64_t delta = counter->latch();
+      if (!changed_stats_only_) {
+        flushStat(batch, *counter, nullptr, delta, 'c');
+        continue;
+      }
+      // Looked up even when unchanged, so that the stat stays cached.
+      StatCache::Entry& entry = stat_cache_.get(counter);
+      if (delta != 0) {
+        flushStat(batch, *counter, &entry, delta, 'c');
+      }
     }
   }
 
   for (const Stats::GaugeSharedPtr& gauge : source.cachedGauges()) {
     if (gauge->used()) {
-      writer.write(fmt::format("{}.{}:{}|g{}", prefix_, getName(*gauge), gauge->value(),
-                               buildTagStr(gauge->tags())));
+      const uint64_t value = gauge->value();
+      if (!changed_stats_only_) {
+        flushStat(batch, *gauge, nullptr, value, 'g');
+        continue;
+      }
+      StatCache::Entry& entry = stat_cache_.get(gauge);
+      if (entry.last_value_ != value) {
+        entry.last_value_ = value;
+        flushStat(batch, *gauge, &entry, value, 'g');
+      }
     }
   }
+
+  batch.send();
+  if (changed_stats_only_) {
+    stat_cache_.endFlush();
+  }
+}
+
+void UdpStatsdSink::flushStat(Batch& batch, const Stats::Metric& metric, StatCache::Entry* entry,
+                              uint64_t value, char stat_type) {
+  if (entry == nullptr) {
+    batch.add(fmt::format("{}.{}:{}|{}{}", prefix_, getName(metric), value, stat_type,
+                          buildTagStr(metric.tags())));
+    return;
+  }
+
+  if (entry->name_.empty()) {
+    entry->name_ = absl::StrCat(prefix_, ".", getName(metric), ":");
+    entry->tags_ = buildTagStr(metric.tags());
+  }
+  batch.add(absl::StrCat(entry->name_, value, "|", absl::string_view(&stat_type, 1), entry->tags_));
 }
 
 void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) {
@@ -98,8 +185,9 @@ const std::string UdpStatsdSink::buildTagStr(const std::vector<Stats::Tag>& tags
 TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
                              const std::string& cluster_name, ThreadLocal::SlotAllocator& tls,
                              Upstream::ClusterManager& cluster_manager, Stats::Scope& scope,
-                             const std::string& prefix)
-    : prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix), tls_(tls.allocateSlot()),
+                             const std::string& prefix, bool changed_stats_only)
+    : prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      changed_stats_only_(changed_stats_only), tls_(tls.allocateSlot()),
       cluster_manager_(cluster_manager), cx_overflow_stat_(scope.counter("statsd.cx_overflow")) {
 
   Config::Utility::checkClusterAndLocalInfo("tcp statsd", cluster_name, cluster_manager,
@@ -113,18 +201,52 @@ TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
 void TcpStatsdSink::flush(Stats::Source& source) {
   TlsSink& tls_sink = tls_->getTyped<TlsSink>();
   tls_sink.beginFlush(true);
+  if (changed_stats_only_) {
+    stat_cache_.beginFlush();
+  }
+
   for (const Stats::CounterSharedPtr& counter : source.cachedCounters()) {
     if (counter->used()) {
-      tls_sink.flushCounter(counter->name(), counter->latch());
+      const uint64_t delta = counter->latch();
+      if (!changed_stats_only_) {
+        tls_sink.flushCounter(counter->name(), delta);
+        continue;
+      }
+      // Looked up even when unchanged, so that the stat stays cached.
+      StatCache::Entry& entry = stat_cache_.get(counter);
+      if (delta != 0) {
+        tls_sink.flushCounter(cachedName(entry, *counter), delta);
+      }
     }
   }
 
   for (const Stats::GaugeSharedPtr& gauge : source.cachedGauges()) {
     if (gauge->used()) {
-      tls_sink.flushGauge(gauge->name(), gauge->value());
+      const uint64_t value = gauge->value();
+      if (!changed_stats_only_) {
+        tls_sink.flushGauge(gauge->name(), value);
+        continue;
+      }
+      StatCache::Entry& entry = stat_cache_.get(gauge);
+      if (entry.last_value_ != value) {
+        entry.last_value_ = value;
+        tls_sink.flushGauge(cachedName(entry, *gauge), value);
+      }
     }
   }
+
   tls_sink.endFlush(true);
+  if (changed_stats_only_) {
+    stat_cache_.endFlush();
+  }
+}
+
+const std::string& TcpStatsdSink::cachedName(StatCache::Entry& entry,
+                                             const Stats::Metric& metric) {
+  if (entry.name_.empty()) {
+    entry.name_ = metric.name();
+  }
+  return entry.name_;
 }
 
 TcpStatsdSink::TlsSink::TlsSink(TcpStatsdSink& parent, Event::Dispatcher& dispatcher)
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 #include "envoy/local_info/local_info.h"
 #include "envoy/network/connection.h"
 #include "envoy/stats/histogram.h"
@@ -15,6 +19,8 @@
 #include "common/common/macros.h"
 #include "common/network/io_socket_handle_impl.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace StatSinks {
@@ -41,18 +47,76 @@ private:
   Network::IoHandlePtr io_handle_;
 };
 
+/**
+ * State kept across flushes for each stat by sinks that only send changed stats: the name the
+ * stat is sent under, its formatted tags, and the last gauge value sent. Looking a stat up by
+ * address avoids building its name on every flush. Entries hold a reference to their stat so that
+ * the address can't be reused while cached, and entries for stats that are no longer in the
+ * source are dropped at the end of each flush.
+ *
+ * Not thread safe. The cache is only used from the owning sink's flush(), which the server calls
+ * on the stats flush thread, or on the main thread if there is no flush thread. The next flush is
+ * only scheduled once the previous one has completed, so calls never overlap.
+ */
+class StatCache {
+public:
+  struct Entry {
+    // Empty until filled in by the sink the first time the stat is flushed.
+    std::string name_;
+    std::string tags_;
+    absl::optional<uint64_t> last_value_;
+  };
+
+  /**
+   * Starts a flush. Entries not looked up between here and endFlush() are dropped.
+   */
+  void beginFlush() { ++generation_; }
+
+  /**
+   * @param metric supplies the stat.
+   * @return Entry& the entry for the stat, which is created empty if the stat is not cached.
+   */
+  Entry& get(std::shared_ptr<const Stats::Metric> metric);
+
+  /**
+   * Ends a flush, dropping the entries of stats that weren't flushed.
+   */
+  void endFlush();
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  struct CachedStat {
+    std::shared_ptr<const Stats::Metric> metric_;
+    uint64_t generation_;
+    Entry entry_;
+  };
+
+  std::unordered_map<const Stats::Metric*, CachedStat> entries_;
+  uint64_t generation_{};
+};
+
 /**
  * Implementation of Sink that writes to a UDP statsd address.
  */
 class UdpStatsdSink : public Stats::Sink {
 public:
+  /**
+   * @param max_bytes_per_datagram if non-zero, flushed stats are packed into newline separated
+   *        datagrams of up to this many bytes, rather than sent one per datagram.
+   * @param changed_stats_only if true, counters that haven't been incremented and gauges that
+   *        haven't changed since the previous flush are not sent.
+   */
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix());
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                uint64_t max_bytes_per_datagram = 0, bool changed_stats_only = false);
   // For testing.
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, const std::shared_ptr<Writer>& writer,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix())
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                uint64_t max_bytes_per_datagram = 0, bool changed_stats_only = false)
       : tls_(tls.allocateSlot()), use_tag_(use_tag),
-        prefix_(prefix.empty() ? getDefaultPrefix() : prefix) {
+        prefix_(prefix.empty() ? getDefaultPrefix() : prefix),
+        max_bytes_per_datagram_(max_bytes_per_datagram), changed_stats_only_(changed_stats_only) {
     tls_->set(
         [writer](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr { return writer; });
   }
@@ -60,6 +124,7 @@ public:
   // Stats::Sink
   void flush(Stats::Source& source) override;
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override;
+  bool threadSafeFlush() const override { return true; }
 
   // Called in unit test to validate writer construction and address.
   int getFdForTests() { return tls_->getTyped<Writer>().getFdForTests(); }
@@ -67,6 +132,25 @@ public:
   const std::string& getPrefix() { return prefix_; }
 
 private:
+  /**
+   * Collects the lines of a flush, sending them as they fill a datagram.
+   */
+  class Batch {
+  public:
+    Batch(Writer& writer, uint64_t max_bytes) : writer_(writer), max_bytes_(max_bytes) {}
+
+    void add(const std::string& line);
+    void send();
+
+  private:
+    Writer& writer_;
+    const uint64_t max_bytes_;
+    std::string buffer_;
+  };
+
+  // Formats a stat line, using the stat's cache entry if given.
+  void flushStat(Batch& batch, const Stats::Metric& metric, StatCache::Entry* entry,
+                 uint64_t value, char stat_type);
   const std::string getName(const Stats::Metric& metric);
   const std::string buildTagStr(const std::vector<Stats::Tag>& tags);
 
@@ -75,6 +159,9 @@ private:
   const bool use_tag_;
   // Prefix for all flushed stats.
   const std::string prefix_;
+  const uint64_t max_bytes_per_datagram_;
+  const bool changed_stats_only_;
+  StatCache stat_cache_;
 };
 
 /**
@@ -82,9 +169,14 @@ private:
  */
 class TcpStatsdSink : public Stats::Sink {
 public:
+  /**
+   * @param changed_stats_only if true, counters that haven't been incremented and gauges that
+   *        haven't changed since the previous flush are not sent.
+   */
   TcpStatsdSink(const LocalInfo::LocalInfo& local_info, const std::string& cluster_name,
                 ThreadLocal::SlotAllocator& tls, Upstream::ClusterManager& cluster_manager,
-                Stats::Scope& scope, const std::string& prefix = getDefaultPrefix());
+                Stats::Scope& scope, const std::string& prefix = getDefaultPrefix(),
+                bool changed_stats_only = false);
 
   // Stats::Sink
   void flush(Stats::Source& source) override;
@@ -93,6 +185,8 @@ public:
     tls_->getTyped<TlsSink>().onTimespanComplete(histogram.name(),
                                                  std::chrono::milliseconds(value));
   }
+  // Connections are owned by the flushing thread's thread local cluster manager.
+  bool threadSafeFlush() const override { return true; }
 
   const std::string& getPrefix() { return prefix_; }
 
@@ -124,6 +218,8 @@ private:
     char* current_slice_mem_{};
   };
 
+  const std::string& cachedName(StatCache::Entry& entry, const Stats::Metric& metric);
+
   // Somewhat arbitrary 16MiB limit for buffered stats.
   static constexpr uint32_t MAX_BUFFERED_STATS_BYTES = (1024 * 1024 * 16);
 
@@ -132,6 +228,8 @@ private:
 
   // Prefix for all flushed stats.
   const std::string prefix_;
+  const bool changed_stats_only_;
+  StatCache stat_cache_;
 
   Upstream::ClusterInfoConstSharedPtr cluster_info_;
   ThreadLocal::SlotPtr tls_;
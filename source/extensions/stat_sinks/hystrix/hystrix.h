@@ -51,6 +51,8 @@ public:
                                        Buffer::Instance&, Server::AdminStream& admin_stream);
   void flush(Stats::Source& source) override;
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override{};
+  // Flushing walks the cluster manager's clusters and writes to admin streams.
+  bool threadSafeFlush() const override { return false; }
 
   /**
    * Register a new connection.
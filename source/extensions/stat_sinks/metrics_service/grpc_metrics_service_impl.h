@@ -75,6 +75,8 @@ public:
                      TimeSource& time_system);
   void flush(Stats::Source& source) override;
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+  // The metrics stream is owned by the main thread.
+  bool threadSafeFlush() const override { return false; }
 
   void flushCounter(const Stats::Counter& counter);
   void flushGauge(const Stats::Gauge& gauge);
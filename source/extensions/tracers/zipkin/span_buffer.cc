@@ -1,35 +1,45 @@
 #include "extensions/tracers/zipkin/span_buffer.h"
 
+#include "common/buffer/buffer_impl.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
 
-// TODO(fabolive): Need to avoid the copy to improve performance.
 bool SpanBuffer::addSpan(const Span& span) {
-  if (span_buffer_.size() == span_buffer_.capacity()) {
+  if (num_spans_ == max_spans_) {
     // Buffer full
     return false;
   }
-  span_buffer_.push_back(std::move(span));
+  if (num_spans_ > 0) {
+    encoded_spans_ += ",";
+  }
+  span.appendJson(encoded_spans_);
+  num_spans_++;
 
   return true;
 }
 
-std::string SpanBuffer::toStringifiedJsonArray() {
-  std::string stringified_json_array = "[";
+std::string SpanBuffer::toStringifiedJsonArray() { return encoded_spans_ + "]"; }
 
-  if (pendingSpans()) {
-    stringified_json_array += span_buffer_[0].toJson();
-    const uint64_t size = span_buffer_.size();
-    for (uint64_t i = 1; i < size; i++) {
-      stringified_json_array += ",";
-      stringified_json_array += span_buffer_[i].toJson();
-    }
-  }
-  stringified_json_array += "]";
+void SpanBuffer::drainJsonArray(Buffer::Instance& output) {
+  const size_t capacity = encoded_spans_.capacity();
+  encoded_spans_.push_back(']');
+  // The fragment owns the moved string and releases both once the body has been sent.
+  auto* json = new std::string(std::move(encoded_spans_));
+  auto* fragment = new Buffer::BufferFragmentImpl(
+      json->data(), json->size(),
+      [json](const void*, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+        delete json;
+        delete this_fragment;
+      });
+  output.addBufferFragment(*fragment);
 
-  return stringified_json_array;
+  // Keep the allocation size of the previous batch, as the next one is likely similar.
+  encoded_spans_ = std::string();
+  encoded_spans_.reserve(capacity);
+  clear();
 }
 
 } // namespace Zipkin
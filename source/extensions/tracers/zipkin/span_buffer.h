@@ -1,5 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <string>
+
+#include "envoy/buffer/buffer.h"
+
 #include "extensions/tracers/zipkin/zipkin_core_types.h"
 
 namespace Envoy {
@@ -9,7 +14,8 @@ namespace Zipkin {
 
 /**
  * This class implements a simple buffer to store Zipkin tracing spans
- * prior to flushing them.
+ * prior to flushing them. Spans are encoded as JSON when they are added, into a string
+ * that is handed over to the request body on flush, so that no copies of the spans are kept.
  */
 class SpanBuffer {
 public:
@@ -31,7 +37,7 @@ public:
    *
    * @param size The desired buffer size.
    */
-  void allocateBuffer(uint64_t size) { span_buffer_.reserve(size); }
+  void allocateBuffer(uint64_t size) { max_spans_ = std::max(max_spans_, size); }
 
   /**
    * Adds the given Zipkin span to the buffer.
@@ -46,12 +52,15 @@ public:
    * Empties the buffer. This method is supposed to be called when all buffered spans
    * have been sent to to the Zipkin service.
    */
-  void clear() { span_buffer_.clear(); }
+  void clear() {
+    encoded_spans_.assign("[");
+    num_spans_ = 0;
+  }
 
   /**
    * @return the number of spans currently buffered.
    */
-  uint64_t pendingSpans() { return span_buffer_.size(); }
+  uint64_t pendingSpans() { return num_spans_; }
 
   /**
    * @return the contents of the buffer as a stringified array of JSONs, where
@@ -59,9 +68,20 @@ public:
    */
   std::string toStringifiedJsonArray();
 
+  /**
+   * Moves the contents of the buffer, as returned by toStringifiedJsonArray(), into the given
+   * buffer without copying them, and empties this one.
+   *
+   * @param output The buffer to move the spans into.
+   */
+  void drainJsonArray(Buffer::Instance& output);
+
 private:
-  // We use a pre-allocated vector to improve performance
-  std::vector<Span> span_buffer_;
+  // "[" followed by the comma separated JSON encodings of the buffered spans, so that closing the
+  // array is the only change needed before the string is moved into a request body.
+  std::string encoded_spans_{"["};
+  uint64_t num_spans_{};
+  uint64_t max_spans_{};
 };
 
 } // namespace Zipkin
@@ -0,0 +1,65 @@
+#include "extensions/tracers/zipkin/tail_sampler.h"
+
+#include "common/tracing/http_tracer_impl.h"
+
+#include "absl/strings/numbers.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Zipkin {
+
+TailSampler::TailSampler(absl::optional<std::chrono::microseconds> min_duration,
+                         absl::optional<uint64_t> min_response_code,
+                         uint64_t max_spans_per_second, TailSamplingStats& stats,
+                         TimeSource& time_source)
+    : min_duration_(min_duration), min_response_code_(min_response_code), stats_(stats),
+      time_source_(time_source),
+      budget_(max_spans_per_second, time_source, static_cast<double>(max_spans_per_second)) {}
+
+bool TailSampler::shouldKeep(const Span& span) {
+  if (!interesting(span)) {
+    return false;
+  }
+
+  if (budget_.consume(1, false) == 0) {
+    stats_.tail_sampling_overflow_.inc();
+    return false;
+  }
+
+  stats_.tail_sampled_.inc();
+  return true;
+}
+
+bool TailSampler::interesting(const Span& span) const {
+  if (min_duration_) {
+    const int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+                            time_source_.monotonicTime().time_since_epoch())
+                            .count();
+    if (std::chrono::microseconds(now - span.startTime()) >= min_duration_.value()) {
+      return true;
+    }
+  }
+
+  if (min_response_code_) {
+    for (const BinaryAnnotation& annotation : span.binaryAnnotations()) {
+      if (annotation.key() != Tracing::Tags::get().HttpStatusCode) {
+        continue;
+      }
+      // A response code of 0 means that the request did not get a response.
+      uint64_t response_code;
+      if (absl::SimpleAtoi(annotation.value(), &response_code) &&
+          (response_code == 0 || response_code >= min_response_code_.value())) {
+        return true;
+      }
+      break;
+    }
+  }
+
+  return false;
+}
+
+} // namespace Zipkin
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/token_bucket_impl.h"
+
+#include "extensions/tracers/zipkin/zipkin_core_types.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Zipkin {
+
+/**
+ * All Zipkin tail sampling stats. @see stats_macros.h
+ */
+// clang-format off
+#define ZIPKIN_TAIL_SAMPLING_STATS(COUNTER)                                                        \
+  COUNTER(tail_sampled)                                                                            \
+  COUNTER(tail_sampling_overflow)
+// clang-format on
+
+/**
+ * Struct definition for all Zipkin tail sampling stats. @see stats_macros.h
+ */
+struct TailSamplingStats {
+  ZIPKIN_TAIL_SAMPLING_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Decides, once a span has finished, whether to keep a span that was not sampled when it started,
+ * based on how long it took and on the response code of its request.
+ *
+ * Each worker has its own instance, which keeps at most a fixed number of spans per second. This
+ * bounds the spans buffered for the collector when a large fraction of requests is slow or failing.
+ */
+class TailSampler {
+public:
+  /**
+   * @param min_duration supplies the duration from which spans are kept, if any.
+   * @param min_response_code supplies the response code from which spans are kept, if any.
+   * @param max_spans_per_second supplies the maximum number of spans kept per second.
+   * @param stats supplies the stats to update.
+   * @param time_source supplies the time source used to measure span durations.
+   */
+  TailSampler(absl::optional<std::chrono::microseconds> min_duration,
+              absl::optional<uint64_t> min_response_code, uint64_t max_spans_per_second,
+              TailSamplingStats& stats, TimeSource& time_source);
+
+  /**
+   * @param span supplies a finished span that was not sampled.
+   * @return bool whether the span should be reported.
+   */
+  bool shouldKeep(const Span& span);
+
+private:
+  bool interesting(const Span& span) const;
+
+  const absl::optional<std::chrono::microseconds> min_duration_;
+  const absl::optional<uint64_t> min_response_code_;
+  TailSamplingStats& stats_;
+  TimeSource& time_source_;
+  TokenBucketImpl budget_;
+};
+
+typedef std::unique_ptr<TailSampler> TailSamplerPtr;
+
+} // namespace Zipkin
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
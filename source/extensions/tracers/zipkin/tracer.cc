@@ -124,13 +124,17 @@ SpanPtr Tracer::startSpan(const Tracing::Config& config, const std::string& span
 }
 
 void Tracer::reportSpan(Span&& span) {
-  if (reporter_ && span.sampled()) {
+  if (reporter_ && (span.sampled() || (tail_sampler_ && tail_sampler_->shouldKeep(span)))) {
     reporter_->reportSpan(std::move(span));
   }
 }
 
 void Tracer::setReporter(ReporterPtr reporter) { reporter_ = std::move(reporter); }
 
+void Tracer::setTailSampler(TailSamplerPtr tail_sampler) {
+  tail_sampler_ = std::move(tail_sampler);
+}
+
 } // namespace Zipkin
 } // namespace Tracers
 } // namespace Extensions
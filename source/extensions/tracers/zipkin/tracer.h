@@ -6,6 +6,7 @@
 #include "envoy/tracing/http_tracer.h"
 
 #include "extensions/tracers/zipkin/span_context.h"
+#include "extensions/tracers/zipkin/tail_sampler.h"
 #include "extensions/tracers/zipkin/tracer_interface.h"
 #include "extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "extensions/tracers/zipkin/zipkin_core_types.h"
@@ -106,6 +107,12 @@ public:
    */
   void setReporter(ReporterPtr reporter);
 
+  /**
+   * Associates a TailSampler object with this Tracer. Finished spans that were not sampled are
+   * only reported if the tail sampler keeps them.
+   */
+  void setTailSampler(TailSamplerPtr tail_sampler);
+
   /**
    * @return the random-number generator associated with the Tracer.
    */
@@ -115,6 +122,7 @@ private:
   const std::string service_name_;
   Network::Address::InstanceConstSharedPtr address_;
   ReporterPtr reporter_;
+  TailSamplerPtr tail_sampler_;
   Runtime::RandomGenerator& random_generator_;
   const bool trace_id_128bit_;
   const bool shared_span_context_;
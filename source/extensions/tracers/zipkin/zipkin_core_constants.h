@@ -46,6 +46,7 @@ public:
 
   const std::string DEFAULT_COLLECTOR_ENDPOINT = "/api/v1/spans";
   const bool DEFAULT_SHARED_SPAN_CONTEXT = true;
+  const uint32_t DEFAULT_TAIL_SAMPLING_MAX_SPANS_PER_SECOND = 10;
 };
 
 typedef ConstSingleton<ZipkinCoreConstantValues> ZipkinCoreConstants;
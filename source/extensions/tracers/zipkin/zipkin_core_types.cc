@@ -7,7 +7,6 @@
 #include "extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "extensions/tracers/zipkin/zipkin_json_field_names.h"
 
-#include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 
 namespace Envoy {
@@ -15,43 +14,108 @@ namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
 
-Endpoint::Endpoint(const Endpoint& ep) {
-  service_name_ = ep.serviceName();
-  address_ = ep.address();
+namespace {
+
+// Adapts a std::string to rapidjson's output stream concept, so that JSON is written straight into
+// the caller's string rather than into a temporary buffer.
+class StringOutputStream {
+public:
+  using Ch = char;
+
+  explicit StringOutputStream(std::string& output) : output_(output) {}
+
+  void Put(char c) { output_.push_back(c); }
+  void Flush() {}
+
+private:
+  std::string& output_;
+};
+
+using JsonWriter = rapidjson::Writer<StringOutputStream>;
+
+void writeKey(JsonWriter& writer, const std::string& key) {
+  writer.Key(key.c_str(), key.size());
 }
 
-Endpoint& Endpoint::operator=(const Endpoint& ep) {
-  service_name_ = ep.serviceName();
-  address_ = ep.address();
-  return *this;
+// Formats a value into 16 characters at out, the same way as Hex::uint64ToHex() but without
+// allocating a string.
+void formatHex(uint64_t value, char* out) {
+  static const char* const digits = "0123456789abcdef";
+  for (int i = 15; i >= 0; i--) {
+    out[i] = digits[value & 0xf];
+    value >>= 4;
+  }
 }
 
-const std::string Endpoint::toJson() {
-  rapidjson::StringBuffer s;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+void writeEndpoint(JsonWriter& writer, const Endpoint& endpoint) {
   writer.StartObject();
-  if (!address_) {
-    writer.Key(ZipkinJsonFieldNames::get().ENDPOINT_IPV4.c_str());
+  const Network::Address::InstanceConstSharedPtr& address = endpoint.address();
+  if (!address) {
+    writeKey(writer, ZipkinJsonFieldNames::get().ENDPOINT_IPV4);
     writer.String("");
-    writer.Key(ZipkinJsonFieldNames::get().ENDPOINT_PORT.c_str());
+    writeKey(writer, ZipkinJsonFieldNames::get().ENDPOINT_PORT);
     writer.Uint(0);
   } else {
-    if (address_->ip()->version() == Network::Address::IpVersion::v4) {
+    if (address->ip()->version() == Network::Address::IpVersion::v4) {
       // IPv4
-      writer.Key(ZipkinJsonFieldNames::get().ENDPOINT_IPV4.c_str());
+      writeKey(writer, ZipkinJsonFieldNames::get().ENDPOINT_IPV4);
     } else {
       // IPv6
-      writer.Key(ZipkinJsonFieldNames::get().ENDPOINT_IPV6.c_str());
+      writeKey(writer, ZipkinJsonFieldNames::get().ENDPOINT_IPV6);
     }
-    writer.String(address_->ip()->addressAsString().c_str());
-    writer.Key(ZipkinJsonFieldNames::get().ENDPOINT_PORT.c_str());
-    writer.Uint(address_->ip()->port());
+    writer.String(address->ip()->addressAsString().c_str());
+    writeKey(writer, ZipkinJsonFieldNames::get().ENDPOINT_PORT);
+    writer.Uint(address->ip()->port());
+  }
+  writeKey(writer, ZipkinJsonFieldNames::get().ENDPOINT_SERVICE_NAME);
+  writer.String(endpoint.serviceName().c_str());
+  writer.EndObject();
+}
+
+void writeAnnotation(JsonWriter& writer, const Annotation& annotation) {
+  writer.StartObject();
+  writeKey(writer, ZipkinJsonFieldNames::get().ANNOTATION_TIMESTAMP);
+  writer.Uint64(annotation.timestamp());
+  writeKey(writer, ZipkinJsonFieldNames::get().ANNOTATION_VALUE);
+  writer.String(annotation.value().c_str());
+  if (annotation.isSetEndpoint()) {
+    writeKey(writer, ZipkinJsonFieldNames::get().ANNOTATION_ENDPOINT);
+    writeEndpoint(writer, annotation.endpoint());
+  }
+  writer.EndObject();
+}
+
+void writeBinaryAnnotation(JsonWriter& writer, const BinaryAnnotation& annotation) {
+  writer.StartObject();
+  writeKey(writer, ZipkinJsonFieldNames::get().BINARY_ANNOTATION_KEY);
+  writer.String(annotation.key().c_str());
+  writeKey(writer, ZipkinJsonFieldNames::get().BINARY_ANNOTATION_VALUE);
+  writer.String(annotation.value().c_str());
+  if (annotation.isSetEndpoint()) {
+    writeKey(writer, ZipkinJsonFieldNames::get().BINARY_ANNOTATION_ENDPOINT);
+    writeEndpoint(writer, annotation.endpoint());
   }
-  writer.Key(ZipkinJsonFieldNames::get().ENDPOINT_SERVICE_NAME.c_str());
-  writer.String(service_name_.c_str());
   writer.EndObject();
-  std::string json_string = s.GetString();
+}
+
+} // namespace
+
+Endpoint::Endpoint(const Endpoint& ep) {
+  service_name_ = ep.serviceName();
+  address_ = ep.address();
+}
 
+Endpoint& Endpoint::operator=(const Endpoint& ep) {
+  service_name_ = ep.serviceName();
+  address_ = ep.address();
+  return *this;
+}
+
+const std::string Endpoint::toJson() {
+  std::string json_string;
+  StringOutputStream stream(json_string);
+  JsonWriter writer(stream);
+  writeEndpoint(writer, *this);
   return json_string;
 }
 
@@ -80,22 +144,10 @@ void Annotation::changeEndpointServiceName(const std::string& service_name) {
 }
 
 const std::string Annotation::toJson() {
-  rapidjson::StringBuffer s;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
-  writer.StartObject();
-  writer.Key(ZipkinJsonFieldNames::get().ANNOTATION_TIMESTAMP.c_str());
-  writer.Uint64(timestamp_);
-  writer.Key(ZipkinJsonFieldNames::get().ANNOTATION_VALUE.c_str());
-  writer.String(value_.c_str());
-  writer.EndObject();
-
-  std::string json_string = s.GetString();
-
-  if (endpoint_) {
-    Util::mergeJsons(json_string, static_cast<Endpoint>(endpoint_.value()).toJson(),
-                     ZipkinJsonFieldNames::get().ANNOTATION_ENDPOINT);
-  }
-
+  std::string json_string;
+  StringOutputStream stream(json_string);
+  JsonWriter writer(stream);
+  writeAnnotation(writer, *this);
   return json_string;
 }
 
@@ -120,22 +172,10 @@ BinaryAnnotation& BinaryAnnotation::operator=(const BinaryAnnotation& ann) {
 }
 
 const std::string BinaryAnnotation::toJson() {
-  rapidjson::StringBuffer s;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
-  writer.StartObject();
-  writer.Key(ZipkinJsonFieldNames::get().BINARY_ANNOTATION_KEY.c_str());
-  writer.String(key_.c_str());
-  writer.Key(ZipkinJsonFieldNames::get().BINARY_ANNOTATION_VALUE.c_str());
-  writer.String(value_.c_str());
-  writer.EndObject();
-
-  std::string json_string = s.GetString();
-
-  if (endpoint_) {
-    Util::mergeJsons(json_string, static_cast<Endpoint>(endpoint_.value()).toJson(),
-                     ZipkinJsonFieldNames::get().BINARY_ANNOTATION_ENDPOINT);
-  }
-
+  std::string json_string;
+  StringOutputStream stream(json_string);
+  JsonWriter writer(stream);
+  writeBinaryAnnotation(writer, *this);
   return json_string;
 }
 
@@ -172,51 +212,61 @@ void Span::setServiceName(const std::string& service_name) {
 }
 
 const std::string Span::toJson() {
-  rapidjson::StringBuffer s;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+  std::string json_string;
+  appendJson(json_string);
+  return json_string;
+}
+
+void Span::appendJson(std::string& output) const {
+  StringOutputStream stream(output);
+  JsonWriter writer(stream);
   writer.StartObject();
-  writer.Key(ZipkinJsonFieldNames::get().SPAN_TRACE_ID.c_str());
-  writer.String(traceIdAsHexString().c_str());
-  writer.Key(ZipkinJsonFieldNames::get().SPAN_NAME.c_str());
+  char hex[32];
+  size_t trace_id_length = 0;
+  if (trace_id_high_) {
+    formatHex(trace_id_high_.value(), hex);
+    trace_id_length = 16;
+  }
+  formatHex(trace_id_, hex + trace_id_length);
+  writeKey(writer, ZipkinJsonFieldNames::get().SPAN_TRACE_ID);
+  writer.String(hex, trace_id_length + 16);
+  writeKey(writer, ZipkinJsonFieldNames::get().SPAN_NAME);
   writer.String(name_.c_str());
-  writer.Key(ZipkinJsonFieldNames::get().SPAN_ID.c_str());
-  writer.String(Hex::uint64ToHex(id_).c_str());
+  formatHex(id_, hex);
+  writeKey(writer, ZipkinJsonFieldNames::get().SPAN_ID);
+  writer.String(hex, 16);
 
   if (parent_id_ && parent_id_.value()) {
-    writer.Key(ZipkinJsonFieldNames::get().SPAN_PARENT_ID.c_str());
-    writer.String(Hex::uint64ToHex(parent_id_.value()).c_str());
+    formatHex(parent_id_.value(), hex);
+    writeKey(writer, ZipkinJsonFieldNames::get().SPAN_PARENT_ID);
+    writer.String(hex, 16);
   }
 
   if (timestamp_) {
-    writer.Key(ZipkinJsonFieldNames::get().SPAN_TIMESTAMP.c_str());
+    writeKey(writer, ZipkinJsonFieldNames::get().SPAN_TIMESTAMP);
     writer.Int64(timestamp_.value());
   }
 
   if (duration_) {
-    writer.Key(ZipkinJsonFieldNames::get().SPAN_DURATION.c_str());
+    writeKey(writer, ZipkinJsonFieldNames::get().SPAN_DURATION);
     writer.Int64(duration_.value());
   }
 
-  writer.EndObject();
-
-  std::string json_string = s.GetString();
-
-  std::vector<std::string> annotation_json_vector;
-
-  for (auto it = annotations_.begin(); it != annotations_.end(); it++) {
-    annotation_json_vector.push_back(it->toJson());
+  writeKey(writer, ZipkinJsonFieldNames::get().SPAN_ANNOTATIONS);
+  writer.StartArray();
+  for (const Annotation& annotation : annotations_) {
+    writeAnnotation(writer, annotation);
   }
-  Util::addArrayToJson(json_string, annotation_json_vector,
-                       ZipkinJsonFieldNames::get().SPAN_ANNOTATIONS);
+  writer.EndArray();
 
-  std::vector<std::string> binary_annotation_json_vector;
-  for (auto it = binary_annotations_.begin(); it != binary_annotations_.end(); it++) {
-    binary_annotation_json_vector.push_back(it->toJson());
+  writeKey(writer, ZipkinJsonFieldNames::get().SPAN_BINARY_ANNOTATIONS);
+  writer.StartArray();
+  for (const BinaryAnnotation& annotation : binary_annotations_) {
+    writeBinaryAnnotation(writer, annotation);
   }
-  Util::addArrayToJson(json_string, binary_annotation_json_vector,
-                       ZipkinJsonFieldNames::get().SPAN_BINARY_ANNOTATIONS);
+  writer.EndArray();
 
-  return json_string;
+  writer.EndObject();
 }
 
 void Span::finish() {
@@ -517,6 +517,14 @@ public:
    */
   const std::string toJson() override;
 
+  /**
+   * Appends the same JSON representation as toJson() to the given string, writing it in place
+   * rather than building intermediate strings for the span's annotations.
+   *
+   * @param output The string to append to.
+   */
+  void appendJson(std::string& output) const;
+
   /**
    * Associates a Tracer object with the span. The tracer's reportSpan() method is invoked
    * by the span's finish() method so that the tracer can decide what to do with the span
@@ -69,6 +69,8 @@ Driver::Driver(const envoy::config::trace::v2::ZipkinConfig& zipkin_config,
                TimeSource& time_source)
     : cm_(cluster_manager), tracer_stats_{ZIPKIN_TRACER_STATS(
                                 POOL_COUNTER_PREFIX(stats, "tracing.zipkin."))},
+      tail_sampling_stats_{
+          ZIPKIN_TAIL_SAMPLING_STATS(POOL_COUNTER_PREFIX(stats, "tracing.zipkin."))},
       tls_(tls.allocateSlot()), runtime_(runtime), local_info_(local_info),
       time_source_(time_source) {
   Config::Utility::checkCluster(TracerNames::get().Zipkin, zipkin_config.collector_cluster(), cm_);
@@ -84,12 +86,37 @@ Driver::Driver(const envoy::config::trace::v2::ZipkinConfig& zipkin_config,
   const bool shared_span_context = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
       zipkin_config, shared_span_context, ZipkinCoreConstants::get().DEFAULT_SHARED_SPAN_CONTEXT);
 
-  tls_->set([this, collector_endpoint, &random_generator, trace_id_128bit, shared_span_context](
-                Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+  const bool tail_sampling = zipkin_config.has_tail_sampling();
+  absl::optional<std::chrono::microseconds> min_duration;
+  absl::optional<uint64_t> min_response_code;
+  uint64_t max_spans_per_second = 0;
+  if (tail_sampling) {
+    const auto& tail_sampling_config = zipkin_config.tail_sampling();
+    if (tail_sampling_config.has_min_duration()) {
+      min_duration = std::chrono::milliseconds(
+          DurationUtil::durationToMilliseconds(tail_sampling_config.min_duration()));
+    }
+    if (tail_sampling_config.has_min_response_code()) {
+      min_response_code = tail_sampling_config.min_response_code().value();
+    }
+    max_spans_per_second = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        tail_sampling_config, max_spans_per_second,
+        ZipkinCoreConstants::get().DEFAULT_TAIL_SAMPLING_MAX_SPANS_PER_SECOND);
+  }
+
+  tls_->set([this, collector_endpoint, &random_generator, trace_id_128bit, shared_span_context,
+             tail_sampling, min_duration, min_response_code,
+             max_spans_per_second](Event::Dispatcher& dispatcher)
+                -> ThreadLocal::ThreadLocalObjectSharedPtr {
     TracerPtr tracer(new Tracer(local_info_.clusterName(), local_info_.address(), random_generator,
                                 trace_id_128bit, shared_span_context, time_source_));
     tracer->setReporter(
         ReporterImpl::NewInstance(std::ref(*this), std::ref(dispatcher), collector_endpoint));
+    if (tail_sampling) {
+      tracer->setTailSampler(std::make_unique<TailSampler>(min_duration, min_response_code,
+                                                           max_spans_per_second,
+                                                           tail_sampling_stats_, time_source_));
+    }
     return ThreadLocal::ThreadLocalObjectSharedPtr{new TlsTracer(std::move(tracer), *this)};
   });
 }
@@ -143,7 +170,6 @@ ReporterPtr ReporterImpl::NewInstance(Driver& driver, Event::Dispatcher& dispatc
   return ReporterPtr(new ReporterImpl(driver, dispatcher, collector_endpoint));
 }
 
-// TODO(fabolive): Need to avoid the copy to improve performance.
 void ReporterImpl::reportSpan(const Span& span) {
   span_buffer_.addSpan(span);
 
@@ -165,7 +191,6 @@ void ReporterImpl::flushSpans() {
   if (span_buffer_.pendingSpans()) {
     driver_.tracerStats().spans_sent_.add(span_buffer_.pendingSpans());
 
-    const std::string request_body = span_buffer_.toStringifiedJsonArray();
     Http::MessagePtr message(new Http::RequestMessageImpl());
     message->headers().insertMethod().value().setReference(Http::Headers::get().MethodValues.Post);
     message->headers().insertPath().value(collector_endpoint_);
@@ -174,7 +199,7 @@ void ReporterImpl::flushSpans() {
         Http::Headers::get().ContentTypeValues.Json);
 
     Buffer::InstancePtr body(new Buffer::OwnedImpl());
-    body->add(request_body);
+    span_buffer_.drainJsonArray(*body);
     message->body() = std::move(body);
 
     const uint64_t timeout =
@@ -183,8 +208,6 @@ void ReporterImpl::flushSpans() {
         .httpAsyncClientForCluster(driver_.cluster()->name())
         .send(std::move(message), *this,
               Http::AsyncClient::RequestOptions().setTimeout(std::chrono::milliseconds(timeout)));
-
-    span_buffer_.clear();
   }
 }
 
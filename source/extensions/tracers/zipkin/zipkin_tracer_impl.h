@@ -131,6 +131,7 @@ private:
   Upstream::ClusterManager& cm_;
   Upstream::ClusterInfoConstSharedPtr cluster_;
   ZipkinTracerStats tracer_stats_;
+  TailSamplingStats tail_sampling_stats_;
   ThreadLocal::SlotPtr tls_;
   Runtime::Loader& runtime_;
   const LocalInfo::LocalInfo& local_info_;
@@ -3,6 +3,8 @@
 #include <memory>
 #include <string>
 
+#include "envoy/singleton/manager.h"
+
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/config/datasource.h"
@@ -11,6 +13,8 @@
 #include "common/secret/sds_api.h"
 #include "common/ssl/certificate_validation_context_config_impl.h"
 
+#include "extensions/transport_sockets/tls/private_key_offload.h"
+
 #include "openssl/ssl.h"
 
 namespace Envoy {
@@ -18,6 +22,9 @@ namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
+// Singleton registration via macro defined in envoy/singleton/manager.h
+SINGLETON_MANAGER_REGISTRATION(private_key_offload_pool);
+
 namespace {
 
 std::vector<Secret::TlsCertificateConfigProviderSharedPtr> getTlsCertificateConfigProviders(
@@ -104,6 +111,47 @@ getCertificateValidationContextConfigProvider(
   }
 }
 
+Secret::TlsSessionTicketKeysConfigProviderSharedPtr getTlsSessionTicketKeysConfigProvider(
+    Server::Configuration::TransportSocketFactoryContext& factory_context,
+    const envoy::api::v2::auth::DownstreamTlsContext& config) {
+  if (config.session_ticket_keys_type_case() !=
+      envoy::api::v2::auth::DownstreamTlsContext::kSessionTicketKeysSdsSecretConfig) {
+    return nullptr;
+  }
+  const auto& sds_secret_config = config.session_ticket_keys_sds_secret_config();
+  if (sds_secret_config.has_sds_config()) {
+    // Fetch dynamic secret.
+    return factory_context.secretManager().findOrCreateTlsSessionTicketKeysProvider(
+        sds_secret_config.sds_config(), sds_secret_config.name(), factory_context);
+  } else {
+    // Load static secret.
+    auto secret_provider = factory_context.secretManager().findStaticTlsSessionTicketKeysProvider(
+        sds_secret_config.name());
+    if (!secret_provider) {
+      throw EnvoyException(
+          fmt::format("Unknown static session ticket keys: {}", sds_secret_config.name()));
+    }
+    return secret_provider;
+  }
+}
+
+Envoy::Ssl::PrivateKeyOperationRunnerSharedPtr getPrivateKeyOperationRunner(
+    Server::Configuration::TransportSocketFactoryContext& factory_context,
+    const envoy::api::v2::auth::DownstreamTlsContext& config) {
+  const uint32_t num_threads =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, private_key_offload_threads, 0);
+  if (num_threads == 0) {
+    return nullptr;
+  }
+  PrivateKeyOffloadPoolSharedPtr pool =
+      factory_context.singletonManager().getTyped<PrivateKeyOffloadPool>(
+          SINGLETON_MANAGER_REGISTERED_NAME(private_key_offload_pool), [&factory_context] {
+            return std::make_shared<PrivateKeyOffloadPool>(factory_context.api().threadFactory());
+          });
+  pool->reserveThreads(num_threads);
+  return pool;
+}
+
 } // namespace
 
 ContextConfigImpl::ContextConfigImpl(
@@ -123,7 +171,8 @@ ContextConfigImpl::ContextConfigImpl(
       min_protocol_version_(tlsVersionFromProto(config.tls_params().tls_minimum_protocol_version(),
                                                 default_min_protocol_version)),
       max_protocol_version_(tlsVersionFromProto(config.tls_params().tls_maximum_protocol_version(),
-                                                default_max_protocol_version)) {
+                                                default_max_protocol_version)),
+      dynamic_record_sizing_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, dynamic_record_sizing, false)) {
   if (default_cvc_ && certificate_validation_context_provider_ != nullptr) {
     // We need to validate combined certificate validation context.
     // The default certificate validation context and dynamic certificate validation
@@ -339,27 +388,26 @@ ServerContextConfigImpl::ServerContextConfigImpl(
                         DEFAULT_CIPHER_SUITES, DEFAULT_CURVES, factory_context),
       require_client_certificate_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, require_client_certificate, false)),
-      session_ticket_keys_([&config, &api = api_] {
-        std::vector<SessionTicketKey> ret;
-
-        switch (config.session_ticket_keys_type_case()) {
-        case envoy::api::v2::auth::DownstreamTlsContext::kSessionTicketKeys:
-          for (const auto& datasource : config.session_ticket_keys().keys()) {
-            validateAndAppendKey(ret, Config::DataSource::read(datasource, false, api));
-          }
-          break;
-        case envoy::api::v2::auth::DownstreamTlsContext::kSessionTicketKeysSdsSecretConfig:
-          throw EnvoyException("SDS not supported yet");
-          break;
-        case envoy::api::v2::auth::DownstreamTlsContext::SESSION_TICKET_KEYS_TYPE_NOT_SET:
-          break;
-        default:
-          throw EnvoyException(fmt::format("Unexpected case for oneof session_ticket_keys: {}",
-                                           config.session_ticket_keys_type_case()));
-        }
-
-        return ret;
-      }()) {
+      session_ticket_keys_provider_(
+          getTlsSessionTicketKeysConfigProvider(factory_context, config)),
+      private_key_operation_runner_(getPrivateKeyOperationRunner(factory_context, config)) {
+  switch (config.session_ticket_keys_type_case()) {
+  case envoy::api::v2::auth::DownstreamTlsContext::kSessionTicketKeys:
+    session_ticket_keys_ = getSessionTicketKeys(config.session_ticket_keys());
+    break;
+  case envoy::api::v2::auth::DownstreamTlsContext::kSessionTicketKeysSdsSecretConfig:
+    // Dynamic keys are loaded once the first SDS response arrives.
+    if (session_ticket_keys_provider_->secret() != nullptr) {
+      session_ticket_keys_ = getSessionTicketKeys(*session_ticket_keys_provider_->secret());
+    }
+    break;
+  case envoy::api::v2::auth::DownstreamTlsContext::SESSION_TICKET_KEYS_TYPE_NOT_SET:
+    break;
+  default:
+    throw EnvoyException(fmt::format("Unexpected case for oneof session_ticket_keys: {}",
+                                     config.session_ticket_keys_type_case()));
+  }
+
   if ((config.common_tls_context().tls_certificates().size() +
        config.common_tls_context().tls_certificate_sds_secret_configs().size()) == 0) {
     throw EnvoyException("No TLS certificates found for server context");
@@ -380,6 +428,39 @@ ServerContextConfigImpl::ServerContextConfigImpl(
           }(),
           factory_context) {}
 
+ServerContextConfigImpl::~ServerContextConfigImpl() {
+  if (stk_update_callback_handle_) {
+    stk_update_callback_handle_->remove();
+  }
+}
+
+void ServerContextConfigImpl::setSecretUpdateCallback(std::function<void()> callback) {
+  ContextConfigImpl::setSecretUpdateCallback(callback);
+  if (session_ticket_keys_provider_) {
+    if (stk_update_callback_handle_) {
+      stk_update_callback_handle_->remove();
+    }
+    // Once session_ticket_keys_provider_ receives new keys, this callback replaces
+    // session_ticket_keys_ so that the rebuilt context encrypts new tickets with the new first key,
+    // while the remaining keys still decrypt tickets issued before the rotation.
+    stk_update_callback_handle_ =
+        session_ticket_keys_provider_->addUpdateCallback([this, callback]() {
+          session_ticket_keys_ = getSessionTicketKeys(*session_ticket_keys_provider_->secret());
+          callback();
+        });
+  }
+}
+
+std::vector<Ssl::ServerContextConfig::SessionTicketKey>
+ServerContextConfigImpl::getSessionTicketKeys(
+    const envoy::api::v2::auth::TlsSessionTicketKeys& keys) {
+  std::vector<SessionTicketKey> result;
+  for (const auto& datasource : keys.keys()) {
+    validateAndAppendKey(result, Config::DataSource::read(datasource, false, api_));
+  }
+  return result;
+}
+
 // Append a SessionTicketKey to keys, initializing it with key_data.
 // Throws if key_data is invalid.
 void ServerContextConfigImpl::validateAndAppendKey(
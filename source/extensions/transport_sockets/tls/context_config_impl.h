@@ -43,6 +43,7 @@ public:
   }
   unsigned minProtocolVersion() const override { return min_protocol_version_; };
   unsigned maxProtocolVersion() const override { return max_protocol_version_; };
+  bool dynamicRecordSizing() const override { return dynamic_record_sizing_; }
 
   bool isReady() const override {
     const bool tls_is_ready =
@@ -92,6 +93,7 @@ private:
   Common::CallbackHandle* cvc_validation_callback_handle_{};
   const unsigned min_protocol_version_;
   const unsigned max_protocol_version_;
+  const bool dynamic_record_sizing_;
 };
 
 class ClientContextConfigImpl : public ContextConfigImpl, public Envoy::Ssl::ClientContextConfig {
@@ -134,11 +136,24 @@ public:
       const Json::Object& config,
       Server::Configuration::TransportSocketFactoryContext& secret_provider_context);
 
+  ~ServerContextConfigImpl() override;
+
+  // Ssl::ContextConfig
+  bool isReady() const override {
+    const bool stk_is_ready =
+        (session_ticket_keys_provider_ == nullptr || session_ticket_keys_provider_->secret());
+    return ContextConfigImpl::isReady() && stk_is_ready;
+  }
+  void setSecretUpdateCallback(std::function<void()> callback) override;
+
   // Ssl::ServerContextConfig
   bool requireClientCertificate() const override { return require_client_certificate_; }
   const std::vector<SessionTicketKey>& sessionTicketKeys() const override {
     return session_ticket_keys_;
   }
+  Envoy::Ssl::PrivateKeyOperationRunnerSharedPtr privateKeyOperationRunner() const override {
+    return private_key_operation_runner_;
+  }
 
 private:
   static const unsigned DEFAULT_MIN_VERSION;
@@ -147,8 +162,17 @@ private:
   static const std::string DEFAULT_CURVES;
 
   const bool require_client_certificate_;
-  const std::vector<SessionTicketKey> session_ticket_keys_;
-
+  // Set when the keys come from a static or SDS secret. An SDS update replaces
+  // session_ticket_keys_ and rebuilds the context, which is how keys are rotated.
+  Secret::TlsSessionTicketKeysConfigProviderSharedPtr session_ticket_keys_provider_;
+  Common::CallbackHandle* stk_update_callback_handle_{};
+  std::vector<SessionTicketKey> session_ticket_keys_;
+  // The server wide offload pool, held by every context built from this config so that the
+  // offload threads outlive SDS updates.
+  const Envoy::Ssl::PrivateKeyOperationRunnerSharedPtr private_key_operation_runner_;
+
+  std::vector<SessionTicketKey>
+  getSessionTicketKeys(const envoy::api::v2::auth::TlsSessionTicketKeys& keys);
   static void validateAndAppendKey(std::vector<ServerContextConfig::SessionTicketKey>& keys,
                                    const std::string& key_data);
 };
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "envoy/common/exception.h"
@@ -15,6 +16,7 @@
 #include "common/common/utility.h"
 #include "common/protobuf/utility.h"
 
+#include "extensions/transport_sockets/tls/private_key_offload.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "openssl/evp.h"
@@ -48,7 +50,8 @@ bool cbsContainsU16(CBS& cbs, uint16_t n) {
 ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
                          TimeSource& time_source)
     : scope_(scope), stats_(generateStats(scope)), time_source_(time_source),
-      tls_max_version_(config.maxProtocolVersion()) {
+      tls_max_version_(config.maxProtocolVersion()),
+      dynamic_record_sizing_(config.dynamicRecordSizing()) {
   const auto tls_certificates = config.tlsCertificates();
   tls_contexts_.resize(std::max(1UL, tls_certificates.size()));
 
@@ -630,7 +633,8 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
     : ContextImpl(scope, config, time_source),
       server_name_indication_(config.serverNameIndication()),
       allow_renegotiation_(config.allowRenegotiation()),
-      max_session_keys_(config.maxSessionKeys()) {
+      max_session_keys_(config.maxSessionKeys()),
+      session_key_shards_in_use_(std::min<size_t>(max_session_keys_, SessionKeyShards)) {
   // This should be guaranteed during configuration ingestion for client contexts.
   ASSERT(tls_contexts_.size() == 1);
   if (!parsed_alpn_protocols_.empty()) {
@@ -652,6 +656,12 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
   }
 
   if (max_session_keys_ > 0) {
+    // Split max_session_keys_ as evenly as possible, so the per-SNI total matches the config.
+    for (size_t i = 0; i < session_key_shards_in_use_; ++i) {
+      session_key_shards_[i].max_session_keys_ =
+          max_session_keys_ / session_key_shards_in_use_ +
+          (i < max_session_keys_ % session_key_shards_in_use_ ? 1 : 0);
+    }
     SSL_CTX_set_session_cache_mode(tls_contexts_[0].ssl_ctx_.get(), SSL_SESS_CACHE_CLIENT);
     SSL_CTX_sess_set_new_cb(
         tls_contexts_[0].ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
@@ -659,7 +669,7 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
               static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
           ClientContextImpl* client_context_impl = dynamic_cast<ClientContextImpl*>(context_impl);
           RELEASE_ASSERT(client_context_impl != nullptr, ""); // for Coverity
-          return client_context_impl->newSessionKey(session);
+          return client_context_impl->newSessionKey(ssl, session);
         });
   }
 }
@@ -680,27 +690,33 @@ bssl::UniquePtr<SSL> ClientContextImpl::newSsl(absl::optional<std::string> overr
   }
 
   if (max_session_keys_ > 0) {
-    if (session_keys_single_use_) {
+    SessionKeyShard& shard = sessionKeyShard();
+    if (shard.session_keys_single_use_) {
       // Stored single-use session keys, use write/write locks.
-      absl::WriterMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
+      absl::WriterMutexLock l(&shard.mu_);
+      auto it = shard.session_keys_.find(server_name_indication);
+      if (it != shard.session_keys_.end() && !it->second.empty()) {
         // Use the most recently stored session key, since it has the highest
         // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
+        SSL_SESSION* session = it->second.front().get();
         SSL_set_session(ssl_con.get(), session);
         // Remove single-use session key (TLS 1.3) after first use.
         if (SSL_SESSION_should_be_single_use(session)) {
-          session_keys_.pop_front();
+          it->second.pop_front();
         }
+      } else {
+        stats_.session_cache_miss_.inc();
       }
     } else {
       // Never stored single-use session keys, use read/write locks.
-      absl::ReaderMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
+      absl::ReaderMutexLock l(&shard.mu_);
+      auto it = shard.session_keys_.find(server_name_indication);
+      if (it != shard.session_keys_.end() && !it->second.empty()) {
         // Use the most recently stored session key, since it has the highest
         // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
+        SSL_set_session(ssl_con.get(), it->second.front().get());
+      } else {
+        stats_.session_cache_miss_.inc();
       }
     }
   }
@@ -708,22 +724,37 @@ bssl::UniquePtr<SSL> ClientContextImpl::newSsl(absl::optional<std::string> overr
   return ssl_con;
 }
 
-int ClientContextImpl::newSessionKey(SSL_SESSION* session) {
+int ClientContextImpl::newSessionKey(SSL* ssl, SSL_SESSION* session) {
+  // On the client side this is the SNI set in newSsl(), if any.
+  const char* server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+  const std::string key = server_name != nullptr ? server_name : "";
+  SessionKeyShard& shard = sessionKeyShard();
   // In case we ever store single-use session key (TLS 1.3),
   // we need to switch to using write/write locks.
   if (SSL_SESSION_should_be_single_use(session)) {
-    session_keys_single_use_ = true;
+    shard.session_keys_single_use_ = true;
   }
-  absl::WriterMutexLock l(&session_keys_mu_);
+  absl::WriterMutexLock l(&shard.mu_);
+  if (shard.session_keys_.size() >= MaxSessionKeyServerNames &&
+      shard.session_keys_.find(key) == shard.session_keys_.end()) {
+    shard.session_keys_.erase(shard.session_keys_.begin());
+  }
+  auto& session_keys = shard.session_keys_[key];
   // Evict oldest entries.
-  while (session_keys_.size() >= max_session_keys_) {
-    session_keys_.pop_back();
+  while (session_keys.size() >= shard.max_session_keys_) {
+    session_keys.pop_back();
   }
   // Add new session key at the front of the queue, so that it's used first.
-  session_keys_.push_front(bssl::UniquePtr<SSL_SESSION>(session));
+  session_keys.push_front(bssl::UniquePtr<SSL_SESSION>(session));
   return 1; // Tell BoringSSL that we took ownership of the session.
 }
 
+ClientContextImpl::SessionKeyShard& ClientContextImpl::sessionKeyShard() {
+  ASSERT(session_key_shards_in_use_ > 0);
+  return session_key_shards_[std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                             session_key_shards_in_use_];
+}
+
 uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sigalgs) {
   // This is used only when testing RSA/ECDSA certificate selection, so only the signing algorithms
   // used in tests are supported here.
@@ -743,6 +774,7 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   if (config.tlsCertificates().empty()) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
   }
+  private_key_operation_runner_ = config.privateKeyOperationRunner();
   // First, configure the base context for ClientHello interception.
   // TODO(htuch): replace with SSL_IDENTITY when we have this as a means to do multi-cert in
   // BoringSSL.
@@ -790,6 +822,11 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
           });
     }
 
+    // The method is copied along with the certificate when selectTlsContext() switches SSL_CTX.
+    if (private_key_operation_runner_ != nullptr) {
+      SSL_CTX_set_private_key_method(ctx.ssl_ctx_.get(), PrivateKeyConnection::method());
+    }
+
     int rc = SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_context_buf,
                                             session_context_len);
     RELEASE_ASSERT(rc == 1, "");
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <string>
@@ -12,6 +14,7 @@
 
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "openssl/ssl.h"
@@ -30,11 +33,13 @@ namespace Tls {
   COUNTER(connection_error)                                                                        \
   COUNTER(handshake)                                                                               \
   COUNTER(session_reused)                                                                          \
+  COUNTER(session_cache_miss)                                                                      \
   COUNTER(no_certificate)                                                                          \
   COUNTER(fail_verify_no_cert)                                                                     \
   COUNTER(fail_verify_error)                                                                       \
   COUNTER(fail_verify_san)                                                                         \
-  COUNTER(fail_verify_cert_hash)
+  COUNTER(fail_verify_cert_hash)                                                                   \
+  HISTOGRAM(handshake_duration_us)
 // clang-format on
 
 /**
@@ -73,6 +78,18 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  TimeSource& timeSource() { return time_source_; }
+
+  bool dynamicRecordSizing() const { return dynamic_record_sizing_; }
+
+  /**
+   * @return the runner that private key operations of handshakes are offloaded to, or nullptr if
+   * they are run synchronously during SSL_do_handshake().
+   */
+  const Envoy::Ssl::PrivateKeyOperationRunnerSharedPtr& privateKeyOperationRunner() const {
+    return private_key_operation_runner_;
+  }
+
   // Ssl::Context
   size_t daysUntilFirstCertExpires() const override;
   Envoy::Ssl::CertificateDetailsPtr getCaCertInformation() const override;
@@ -159,6 +176,8 @@ protected:
   std::string cert_chain_file_path_;
   TimeSource& time_source_;
   const unsigned tls_max_version_;
+  const bool dynamic_record_sizing_;
+  Envoy::Ssl::PrivateKeyOperationRunnerSharedPtr private_key_operation_runner_;
 };
 
 typedef std::shared_ptr<ContextImpl> ContextImplSharedPtr;
@@ -171,15 +190,37 @@ public:
   bssl::UniquePtr<SSL> newSsl(absl::optional<std::string> override_server_name) override;
 
 private:
-  int newSessionKey(SSL_SESSION* session);
+  // Session keys are sharded by the thread that established the session, so that workers almost
+  // never contend on the same lock, and keyed by SNI, so that a session is only offered to the
+  // upstream that issued it. max_session_keys_ is split across the shards in use, so each SNI
+  // still holds at most max_session_keys_ keys in total, most recent first within a shard.
+  struct SessionKeyShard {
+    absl::Mutex mu_;
+    // This shard's share of max_session_keys_; always at least 1 for shards in use.
+    size_t max_session_keys_{};
+    // Set once a single-use (TLS 1.3) session key is stored, after which lookups take the writer
+    // lock so that the key can be removed; until then they share a reader lock.
+    std::atomic<bool> session_keys_single_use_{false};
+    absl::flat_hash_map<std::string, std::deque<bssl::UniquePtr<SSL_SESSION>>>
+        session_keys_ GUARDED_BY(mu_);
+  };
+
+  // Enough shards for one per worker on most hosts; threads that share a shard only share a lock.
+  // Fewer shards are used when max_session_keys_ is smaller than this.
+  static constexpr size_t SessionKeyShards = 16;
+  // Bounds the number of SNI values remembered per shard when SNI is overridden per connection,
+  // so that at most MaxSessionKeyServerNames * max_session_keys_ keys are held in total.
+  static constexpr size_t MaxSessionKeyServerNames = 64;
+
+  int newSessionKey(SSL* ssl, SSL_SESSION* session);
+  SessionKeyShard& sessionKeyShard();
   uint16_t parseSigningAlgorithmsForTest(const std::string& sigalgs);
 
   const std::string server_name_indication_;
   const bool allow_renegotiation_;
   const size_t max_session_keys_;
-  absl::Mutex session_keys_mu_;
-  std::deque<bssl::UniquePtr<SSL_SESSION>> session_keys_ GUARDED_BY(session_keys_mu_);
-  bool session_keys_single_use_{false};
+  const size_t session_key_shards_in_use_;
+  std::array<SessionKeyShard, SessionKeyShards> session_key_shards_;
 };
 
 class ServerContextImpl : public ContextImpl, public Envoy::Ssl::ServerContext {
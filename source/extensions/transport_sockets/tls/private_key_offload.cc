@@ -0,0 +1,283 @@
+#include "extensions/transport_sockets/tls/private_key_offload.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+
+#include "absl/types/optional.h"
+#include "openssl/err.h"
+#include "openssl/evp.h"
+#include "openssl/rsa.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+PrivateKeyOffloadPool::PrivateKeyOffloadPool(Thread::ThreadFactory& thread_factory)
+    : thread_factory_(thread_factory) {}
+
+PrivateKeyOffloadPool::~PrivateKeyOffloadPool() {
+  std::vector<Thread::ThreadPtr> threads;
+  {
+    Thread::LockGuard lock(lock_);
+    exit_ = true;
+    queue_event_.notifyAll();
+    threads.swap(threads_);
+  }
+
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+}
+
+void PrivateKeyOffloadPool::reserveThreads(uint32_t num_threads) {
+  Thread::LockGuard lock(lock_);
+  num_threads_ = std::max(num_threads_, num_threads);
+}
+
+void PrivateKeyOffloadPool::post(std::function<void()> operation) {
+  Thread::LockGuard lock(lock_);
+  ASSERT(num_threads_ > 0);
+  while (threads_.size() < num_threads_) {
+    threads_.emplace_back(thread_factory_.createThread([this]() -> void { threadRoutine(); }));
+  }
+  queue_.push_back(std::move(operation));
+  queue_event_.notifyOne();
+}
+
+void PrivateKeyOffloadPool::threadRoutine() {
+  while (true) {
+    std::function<void()> operation;
+
+    {
+      Thread::LockGuard lock(lock_);
+      while (queue_.empty() && !exit_) {
+        queue_event_.wait(lock_);
+      }
+
+      if (queue_.empty()) {
+        return;
+      }
+      operation = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    operation();
+  }
+}
+
+struct PrivateKeyConnection::Operation {
+  // Runs the operation, filling in output_. Only called on one thread at a time.
+  bool run() {
+    if (signature_algorithm_.has_value()) {
+      bssl::ScopedEVP_MD_CTX ctx;
+      EVP_PKEY_CTX* pctx;
+      if (!EVP_DigestSignInit(ctx.get(), &pctx,
+                              SSL_get_signature_algorithm_digest(signature_algorithm_.value()),
+                              nullptr, key_.get())) {
+        return false;
+      }
+      if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm_.value()) &&
+          (!EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) ||
+           !EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1 /* salt length is digest length */))) {
+        return false;
+      }
+      size_t len = EVP_PKEY_size(key_.get());
+      output_.resize(len);
+      if (!EVP_DigestSign(ctx.get(), output_.data(), &len, input_.data(), input_.size())) {
+        return false;
+      }
+      output_.resize(len);
+      return true;
+    }
+
+    // Decryption is only used by the RSA key exchange.
+    RSA* rsa = EVP_PKEY_get0_RSA(key_.get());
+    if (rsa == nullptr) {
+      return false;
+    }
+    size_t len;
+    output_.resize(RSA_size(rsa));
+    if (!RSA_decrypt(rsa, &len, output_.data(), output_.size(), input_.data(), input_.size(),
+                     RSA_NO_PADDING)) {
+      return false;
+    }
+    output_.resize(len);
+    return true;
+  }
+
+  bssl::UniquePtr<EVP_PKEY> key_;
+  // Unset for decryption.
+  absl::optional<uint16_t> signature_algorithm_;
+  std::vector<uint8_t> input_;
+  // Only read once done_ has been observed under lock_.
+  std::vector<uint8_t> output_;
+
+  Thread::MutexBasicLockable lock_;
+  bool done_ GUARDED_BY(lock_){};
+  bool succeeded_ GUARDED_BY(lock_){};
+  // Cleared when the connection is destroyed, so that it is no longer notified.
+  PrivateKeyConnection* connection_ GUARDED_BY(lock_){};
+};
+
+PrivateKeyConnection::PrivateKeyConnection(SSL* ssl, Envoy::Ssl::PrivateKeyOperationRunner& runner,
+                                           Event::Dispatcher& dispatcher,
+                                           std::function<void()> on_complete)
+    : ssl_(ssl), runner_(runner), dispatcher_(dispatcher), on_complete_(on_complete) {
+  int rc = SSL_set_ex_data(ssl_, sslIndex(), this);
+  RELEASE_ASSERT(rc == 1, "");
+}
+
+PrivateKeyConnection::~PrivateKeyConnection() {
+  if (operation_ != nullptr) {
+    Thread::LockGuard lock(operation_->lock_);
+    operation_->connection_ = nullptr;
+  }
+  SSL_set_ex_data(ssl_, sslIndex(), nullptr);
+}
+
+const SSL_PRIVATE_KEY_METHOD* PrivateKeyConnection::method() {
+  static const SSL_PRIVATE_KEY_METHOD method = {sign, decrypt, complete};
+  return &method;
+}
+
+PrivateKeyConnection* PrivateKeyConnection::get(SSL* ssl) {
+  return static_cast<PrivateKeyConnection*>(SSL_get_ex_data(ssl, sslIndex()));
+}
+
+int PrivateKeyConnection::sslIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int ssl_index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    RELEASE_ASSERT(ssl_index >= 0, "");
+    return ssl_index;
+  }());
+}
+
+ssl_private_key_result_t PrivateKeyConnection::sign(SSL* ssl, uint8_t* out, size_t* out_len,
+                                                    size_t max_out, uint16_t signature_algorithm,
+                                                    const uint8_t* in, size_t in_len) {
+  auto operation = std::make_shared<Operation>();
+  EVP_PKEY* key = SSL_get_privatekey(ssl);
+  if (key == nullptr) {
+    return ssl_private_key_failure;
+  }
+  EVP_PKEY_up_ref(key);
+  operation->key_.reset(key);
+  operation->signature_algorithm_ = signature_algorithm;
+  operation->input_.assign(in, in + in_len);
+
+  PrivateKeyConnection* connection = get(ssl);
+  if (connection == nullptr) {
+    return runInline(*operation, out, out_len, max_out);
+  }
+  return connection->start(std::move(operation));
+}
+
+ssl_private_key_result_t PrivateKeyConnection::decrypt(SSL* ssl, uint8_t* out, size_t* out_len,
+                                                       size_t max_out, const uint8_t* in,
+                                                       size_t in_len) {
+  auto operation = std::make_shared<Operation>();
+  EVP_PKEY* key = SSL_get_privatekey(ssl);
+  if (key == nullptr) {
+    return ssl_private_key_failure;
+  }
+  EVP_PKEY_up_ref(key);
+  operation->key_.reset(key);
+  operation->input_.assign(in, in + in_len);
+
+  PrivateKeyConnection* connection = get(ssl);
+  if (connection == nullptr) {
+    return runInline(*operation, out, out_len, max_out);
+  }
+  return connection->start(std::move(operation));
+}
+
+ssl_private_key_result_t PrivateKeyConnection::complete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                                        size_t max_out) {
+  PrivateKeyConnection* connection = get(ssl);
+  if (connection == nullptr || connection->operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+
+  OperationSharedPtr operation = connection->operation_;
+  {
+    Thread::LockGuard lock(operation->lock_);
+    if (!operation->done_) {
+      return ssl_private_key_retry;
+    }
+    operation->connection_ = nullptr;
+    connection->operation_.reset();
+    if (!operation->succeeded_) {
+      return ssl_private_key_failure;
+    }
+  }
+
+  if (operation->output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  memcpy(out, operation->output_.data(), operation->output_.size());
+  *out_len = operation->output_.size();
+  return ssl_private_key_success;
+}
+
+ssl_private_key_result_t PrivateKeyConnection::runInline(Operation& operation, uint8_t* out,
+                                                         size_t* out_len, size_t max_out) {
+  if (!operation.run() || operation.output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  memcpy(out, operation.output_.data(), operation.output_.size());
+  *out_len = operation.output_.size();
+  return ssl_private_key_success;
+}
+
+ssl_private_key_result_t PrivateKeyConnection::start(OperationSharedPtr operation) {
+  // BoringSSL does not start another operation until the previous one has completed.
+  ASSERT(operation_ == nullptr);
+  operation_ = operation;
+  {
+    Thread::LockGuard lock(operation->lock_);
+    operation->connection_ = this;
+  }
+
+  runner_.post([operation]() -> void {
+    const bool succeeded = operation->run();
+    // Errors are reported to the connection through the handshake result, not this thread's
+    // error queue.
+    ERR_clear_error();
+
+    Thread::LockGuard lock(operation->lock_);
+    operation->done_ = true;
+    operation->succeeded_ = succeeded;
+    if (operation->connection_ == nullptr) {
+      return;
+    }
+    // The connection may be gone by the time the dispatcher runs this, in which case either the
+    // operation has been released or connection_ has been cleared.
+    std::weak_ptr<Operation> weak_operation = operation;
+    operation->connection_->dispatcher_.post([weak_operation]() -> void {
+      OperationSharedPtr operation = weak_operation.lock();
+      if (operation == nullptr) {
+        return;
+      }
+      PrivateKeyConnection* connection;
+      {
+        Thread::LockGuard lock(operation->lock_);
+        connection = operation->connection_;
+      }
+      if (connection != nullptr) {
+        connection->on_complete_();
+      }
+    });
+  });
+
+  return ssl_private_key_retry;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
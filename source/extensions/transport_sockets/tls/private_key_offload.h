@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/ssl/private_key_operations.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A pool of threads that run private key operations in the order they are posted. One pool is
+ * shared by every server context config of the server through the singleton manager, so the
+ * number of threads does not grow with the number of listeners and filter chains.
+ *
+ * Threads are started by post(), so a pool that never runs an operation, such as the one created
+ * while validating a config, does not start any.
+ */
+class PrivateKeyOffloadPool : public Singleton::Instance,
+                              public Envoy::Ssl::PrivateKeyOperationRunner {
+public:
+  explicit PrivateKeyOffloadPool(Thread::ThreadFactory& thread_factory);
+  // Runs any operations that are still queued before joining the threads.
+  ~PrivateKeyOffloadPool();
+
+  /**
+   * Raises the size of the pool to at least num_threads threads. The extra threads start with the
+   * next post().
+   * @param num_threads supplies the number of threads requested by a config.
+   */
+  void reserveThreads(uint32_t num_threads);
+
+  // Ssl::PrivateKeyOperationRunner
+  void post(std::function<void()> operation) override;
+
+private:
+  void threadRoutine();
+
+  Thread::ThreadFactory& thread_factory_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar queue_event_;
+  std::deque<std::function<void()>> queue_ GUARDED_BY(lock_);
+  bool exit_ GUARDED_BY(lock_){};
+  uint32_t num_threads_ GUARDED_BY(lock_){};
+  std::vector<Thread::ThreadPtr> threads_ GUARDED_BY(lock_);
+};
+
+typedef std::shared_ptr<PrivateKeyOffloadPool> PrivateKeyOffloadPoolSharedPtr;
+
+/**
+ * Per connection state for offloading the private key operations of a server handshake. BoringSSL
+ * calls into this through the SSL_PRIVATE_KEY_METHOD returned by method(). Each operation copies
+ * its input and takes a reference on the private key, runs on the runner, and then posts back to
+ * the connection's dispatcher, where onComplete() is called so that the handshake can be driven
+ * again. The next call to SSL_do_handshake() picks up the result.
+ *
+ * Must be created and destroyed on the connection's dispatcher thread. Destroying it cancels the
+ * notification of an operation that is still running.
+ */
+class PrivateKeyConnection {
+public:
+  PrivateKeyConnection(SSL* ssl, Envoy::Ssl::PrivateKeyOperationRunner& runner,
+                       Event::Dispatcher& dispatcher, std::function<void()> on_complete);
+  ~PrivateKeyConnection();
+
+  /**
+   * @return const SSL_PRIVATE_KEY_METHOD* the method to install on server SSL_CTXs whose private
+   * key operations are offloaded. Connections without a PrivateKeyConnection attached still
+   * perform the operations synchronously.
+   */
+  static const SSL_PRIVATE_KEY_METHOD* method();
+
+private:
+  struct Operation;
+  typedef std::shared_ptr<Operation> OperationSharedPtr;
+
+  static PrivateKeyConnection* get(SSL* ssl);
+  static int sslIndex();
+  static ssl_private_key_result_t sign(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                       uint16_t signature_algorithm, const uint8_t* in,
+                                       size_t in_len);
+  static ssl_private_key_result_t decrypt(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                          const uint8_t* in, size_t in_len);
+  static ssl_private_key_result_t complete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                           size_t max_out);
+  static ssl_private_key_result_t runInline(Operation& operation, uint8_t* out, size_t* out_len,
+                                            size_t max_out);
+
+  ssl_private_key_result_t start(OperationSharedPtr operation);
+
+  SSL* const ssl_;
+  Envoy::Ssl::PrivateKeyOperationRunner& runner_;
+  Event::Dispatcher& dispatcher_;
+  const std::function<void()> on_complete_;
+  OperationSharedPtr operation_;
+};
+
+typedef std::unique_ptr<PrivateKeyConnection> PrivateKeyConnectionPtr;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
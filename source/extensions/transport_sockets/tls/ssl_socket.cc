@@ -24,6 +24,16 @@ namespace {
 
 constexpr absl::string_view NotReadyReason{"TLS error: Secret is not supplied by SDS"};
 
+// The largest plaintext that fits in a single TLS record.
+constexpr uint64_t MaxRecordSize = 16384;
+// Leaves room for the record header, explicit nonce and tag, and for TCP options, within a
+// typical 1500 byte MTU.
+constexpr uint64_t SmallRecordSize = 1300;
+// With dynamic record sizing, the number of bytes written in small records before switching to
+// full records, and how long a connection must be idle to switch back to small records.
+constexpr uint64_t DynamicRecordSizingThreshold = 1024 * 1024;
+constexpr std::chrono::milliseconds DynamicRecordSizingIdleTimeout{1000};
+
 // This SslSocket will be used when SSL secret is not fetched from SDS server.
 class NotReadySslSocket : public Network::TransportSocket {
 public:
@@ -62,6 +72,13 @@ void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& c
 
   BIO* bio = BIO_new_socket(callbacks_->ioHandle().fd(), 0);
   SSL_set_bio(ssl_.get(), bio, bio);
+
+  if (ctx_->privateKeyOperationRunner() != nullptr) {
+    // Once an offloaded operation completes, the handshake is resumed from doRead().
+    private_key_connection_ = std::make_unique<PrivateKeyConnection>(
+        ssl_.get(), *ctx_->privateKeyOperationRunner(), callbacks_->connection().dispatcher(),
+        [this]() -> void { callbacks_->setReadBufferReady(); });
+  }
 }
 
 Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
@@ -126,11 +143,19 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
 
 PostIoAction SslSocket::doHandshake() {
   ASSERT(!handshake_complete_);
+  if (!handshake_start_.has_value()) {
+    handshake_start_ = ctx_->timeSource().monotonicTime();
+  }
   int rc = SSL_do_handshake(ssl_.get());
   if (rc == 1) {
     ENVOY_CONN_LOG(debug, "handshake complete", callbacks_->connection());
     handshake_complete_ = true;
+    private_key_connection_.reset();
     ctx_->logHandshake(ssl_.get());
+    ctx_->stats().handshake_duration_us_.recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            ctx_->timeSource().monotonicTime() - handshake_start_.value())
+            .count());
     callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 
     // It's possible that we closed during the handshake callback.
@@ -143,6 +168,7 @@ PostIoAction SslSocket::doHandshake() {
     switch (err) {
     case SSL_ERROR_WANT_READ:
     case SSL_ERROR_WANT_WRITE:
+    case SSL_ERROR_WANT_PRIVATE_KEY_OPERATION:
       return PostIoAction::KeepOpen;
     default:
       drainErrorQueue();
@@ -187,12 +213,22 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (ctx_->dynamicRecordSizing() && write_buffer.length() > 0) {
+    const MonotonicTime now = ctx_->timeSource().monotonicTime();
+    if (now - last_write_time_ > DynamicRecordSizingIdleTimeout) {
+      bytes_since_idle_ = 0;
+    }
+    last_write_time_ = now;
+  }
+
+  // Each SSL_write() produces a single record, so the pending data is linearized up to the record
+  // size rather than written slice by slice.
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = std::min(write_buffer.length(), maxRecordSize());
   }
 
   uint64_t total_bytes_written = 0;
@@ -210,7 +246,8 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      bytes_since_idle_ += rc;
+      bytes_to_write = std::min(write_buffer.length(), maxRecordSize());
     } else {
       int err = SSL_get_error(ssl_.get(), rc);
       switch (err) {
@@ -235,6 +272,13 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+uint64_t SslSocket::maxRecordSize() const {
+  if (ctx_->dynamicRecordSizing() && bytes_since_idle_ < DynamicRecordSizingThreshold) {
+    return SmallRecordSize;
+  }
+  return MaxRecordSize;
+}
+
 void SslSocket::onConnected() { ASSERT(!handshake_complete_); }
 
 void SslSocket::shutdownSsl() {
@@ -356,6 +400,9 @@ std::vector<std::string> SslSocket::dnsSansPeerCertificate() const {
 }
 
 void SslSocket::closeSocket(Network::ConnectionEvent) {
+  // The connection can no longer be resumed by an offloaded private key operation.
+  private_key_connection_.reset();
+
   // Attempt to send a shutdown before closing the socket. It's possible this won't go out if
   // there is no room on the socket. We can extend the state machine to handle this at some point
   // if needed.
@@ -12,6 +12,7 @@
 #include "common/common/logger.h"
 
 #include "extensions/transport_sockets/tls/context_impl.h"
+#include "extensions/transport_sockets/tls/private_key_offload.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/synchronization/mutex.h"
@@ -76,15 +77,23 @@ public:
 
 private:
   Network::PostIoAction doHandshake();
+  uint64_t maxRecordSize() const;
   void drainErrorQueue();
   void shutdownSsl();
 
   Network::TransportSocketCallbacks* callbacks_{};
   ContextImplSharedPtr ctx_;
   bssl::UniquePtr<SSL> ssl_;
+  // Declared after ssl_ so that it is detached before the SSL is freed.
+  PrivateKeyConnectionPtr private_key_connection_;
+  absl::optional<MonotonicTime> handshake_start_;
   bool handshake_complete_{};
   bool shutdown_sent_{};
   uint64_t bytes_to_retry_{};
+  // Bytes written since the connection was last idle, and when it last wrote, for dynamic record
+  // sizing.
+  uint64_t bytes_since_idle_{};
+  MonotonicTime last_write_time_;
   std::string failure_reason_;
   mutable std::string cached_sha_256_peer_certificate_digest_;
   mutable std::string cached_url_encoded_pem_encoded_peer_certificate_;
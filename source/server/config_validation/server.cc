@@ -47,7 +47,7 @@ ValidationInstance::ValidationInstance(const Options& options, Event::TimeSystem
       dispatcher_(api_->allocateDispatcher()),
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory().currentThreadId())),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+                          store, options.fileBufferLimitBytes(), options.dropOnFileBufferLimit()),
       mutex_tracer_(nullptr), time_system_(time_system) {
   try {
     initialize(options, local_address, component_factory);
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <fstream>
+#include <limits>
 #include <regex>
 #include <string>
 #include <unordered_map>
@@ -48,10 +49,12 @@
 #include "common/profiler/profiler.h"
 #include "common/router/config_impl.h"
 #include "common/stats/histogram_impl.h"
+#include "common/stats/metric_impl.h"
 #include "common/upstream/host_utility.h"
 
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
@@ -137,7 +140,10 @@ const char AdminHtmlEnd[] = R"(
 </body>
 )";
 
-const std::regex PromRegex("[^a-zA-Z0-9_]");
+// Number of stats formatted per dispatcher iteration when streaming /stats output. Large enough to
+// keep the per chunk overhead low, and small enough that a scrape of hundreds of thousands of stats
+// doesn't hold up the main thread for long at a time.
+constexpr uint64_t StatsPerChunk = 1000;
 
 void populateFallbackResponseHeaders(Http::Code code, Http::HeaderMap& header_map) {
   header_map.insertStatus().value(std::to_string(enumToInt(code)));
@@ -217,11 +223,34 @@ Http::FilterTrailersStatus AdminFilter::decodeTrailers(Http::HeaderMap&) {
 }
 
 void AdminFilter::onDestroy() {
+  if (stream_timer_ != nullptr) {
+    stream_timer_->disableTimer();
+    stream_timer_.reset();
+    callbacks_->removeDownstreamWatermarkCallbacks(*this);
+  }
+  streaming_callback_ = nullptr;
   for (const auto& callback : on_destroy_callbacks_) {
     callback();
   }
 }
 
+void AdminFilter::onAboveWriteBufferHighWatermark() { ++high_watermark_count_; }
+
+void AdminFilter::onBelowWriteBufferLowWatermark() {
+  ASSERT(high_watermark_count_ > 0);
+  if (--high_watermark_count_ == 0 && streaming_callback_) {
+    stream_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+void AdminFilter::drainStreamedResponse(Buffer::Instance& response) {
+  if (streaming_callback_) {
+    while (streaming_callback_(response)) {
+    }
+    streaming_callback_ = nullptr;
+  }
+}
+
 void AdminFilter::addOnDestroyCallback(std::function<void()> cb) {
   on_destroy_callbacks_.push_back(std::move(cb));
 }
@@ -663,7 +692,6 @@ Http::Code AdminImpl::handlerServerInfo(absl::string_view, Http::HeaderMap& head
 
 Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& response_headers,
                                    Buffer::Instance& response, AdminStream& admin_stream) {
-  Http::Code rc = Http::Code::OK;
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(url);
 
   const bool used_only = params.find("usedonly") != params.end();
@@ -673,71 +701,181 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
           ? absl::optional<std::regex>{std::regex(params.at("filter"))}
           : absl::nullopt;
 
-  std::map<std::string, uint64_t> all_stats;
+  if (has_format) {
+    const std::string format_value = params.at("format");
+    if (format_value == "prometheus") {
+      return handlerPrometheusStats(url, response_headers, response, admin_stream);
+    } else if (format_value != "json") {
+      response.add("usage: /stats?format=json  or /stats?format=prometheus \n");
+      response.add("\n");
+      return Http::Code::NotFound;
+    }
+
+    std::map<std::string, uint64_t> all_stats;
+    for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
+      if (shouldShowMetric(counter, used_only, regex)) {
+        all_stats.emplace(counter->name(), counter->value());
+      }
+    }
+
+    for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
+      if (shouldShowMetric(gauge, used_only, regex)) {
+        all_stats.emplace(gauge->name(), gauge->value());
+      }
+    }
+
+    response_headers.insertContentType().value().setReference(
+        Http::Headers::get().ContentTypeValues.Json);
+    response.add(AdminImpl::statsAsJson(all_stats, server_.stats().histograms(), used_only, regex));
+    return Http::Code::OK;
+  }
+
+  // Display plain stats if format query param is not there. The values of counters and gauges are
+  // read up front so that they are consistent with each other, but formatting, and computing
+  // histogram summaries, is done a chunk at a time as the response is streamed.
+  std::vector<std::pair<std::string, uint64_t>> all_stats;
   for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
     if (shouldShowMetric(counter, used_only, regex)) {
-      all_stats.emplace(counter->name(), counter->value());
+      all_stats.emplace_back(counter->name(), counter->value());
     }
   }
 
   for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
     if (shouldShowMetric(gauge, used_only, regex)) {
-      all_stats.emplace(gauge->name(), gauge->value());
+      all_stats.emplace_back(gauge->name(), gauge->value());
     }
   }
 
-  if (has_format) {
-    const std::string format_value = params.at("format");
-    if (format_value == "json") {
-      response_headers.insertContentType().value().setReference(
-          Http::Headers::get().ContentTypeValues.Json);
-      response.add(
-          AdminImpl::statsAsJson(all_stats, server_.stats().histograms(), used_only, regex));
-    } else if (format_value == "prometheus") {
-      return handlerPrometheusStats(url, response_headers, response, admin_stream);
-    } else {
-      response.add("usage: /stats?format=json  or /stats?format=prometheus \n");
-      response.add("\n");
-      rc = Http::Code::NotFound;
-    }
-  } else { // Display plain stats if format query param is not there.
-    for (auto stat : all_stats) {
-      response.add(fmt::format("{}: {}\n", stat.first, stat.second));
-    }
-    // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why we use a
-    // multimap here. This makes sure that duplicate histograms get output. When shared storage is
-    // implemented this can be switched back to a normal map.
-    std::multimap<std::string, std::string> all_histograms;
-    for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
-      if (shouldShowMetric(histogram, used_only, regex)) {
-        all_histograms.emplace(histogram->name(), histogram->quantileSummary());
-      }
-    }
-    for (auto histogram : all_histograms) {
-      response.add(fmt::format("{}: {}\n", histogram.first, histogram.second));
+  // A stable sort keeps the counter when a counter and a gauge share a name.
+  std::stable_sort(all_stats.begin(), all_stats.end(),
+                   [](const std::pair<std::string, uint64_t>& a,
+                      const std::pair<std::string, uint64_t>& b) { return a.first < b.first; });
+  all_stats.erase(std::unique(all_stats.begin(), all_stats.end(),
+                              [](const std::pair<std::string, uint64_t>& a,
+                                 const std::pair<std::string, uint64_t>& b) {
+                                return a.first == b.first;
+                              }),
+                  all_stats.end());
+
+  // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why duplicate
+  // names are kept here. This makes sure that duplicate histograms get output. When shared storage
+  // is implemented they can be dropped like the stats above.
+  std::vector<std::pair<std::string, Stats::ParentHistogramSharedPtr>> all_histograms;
+  for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
+    if (shouldShowMetric(histogram, used_only, regex)) {
+      all_histograms.emplace_back(histogram->name(), histogram);
     }
   }
-  return rc;
+  std::stable_sort(all_histograms.begin(), all_histograms.end(),
+                   [](const std::pair<std::string, Stats::ParentHistogramSharedPtr>& a,
+                      const std::pair<std::string, Stats::ParentHistogramSharedPtr>& b) {
+                     return a.first < b.first;
+                   });
+
+  admin_stream.streamResponse(
+      [all_stats = std::move(all_stats), all_histograms = std::move(all_histograms),
+       next_stat = size_t(0), next_histogram = size_t(0)](Buffer::Instance& chunk) mutable -> bool {
+        uint64_t written = 0;
+        for (; next_stat < all_stats.size() && written < StatsPerChunk; ++next_stat, ++written) {
+          chunk.add(fmt::format("{}: {}\n", all_stats[next_stat].first,
+                                all_stats[next_stat].second));
+        }
+        for (; next_histogram < all_histograms.size() && written < StatsPerChunk;
+             ++next_histogram, ++written) {
+          chunk.add(fmt::format("{}: {}\n", all_histograms[next_histogram].first,
+                                all_histograms[next_histogram].second->quantileSummary()));
+        }
+        return next_stat < all_stats.size() || next_histogram < all_histograms.size();
+      });
+  return Http::Code::OK;
 }
 
 Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query, Http::HeaderMap&,
-                                             Buffer::Instance& response, AdminStream&) {
+                                             Buffer::Instance&, AdminStream& admin_stream) {
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(path_and_query);
   const bool used_only = params.find("usedonly") != params.end();
-  PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
-                                              server_.stats().histograms(), response, used_only);
+  auto writer = std::make_shared<PrometheusStatsFormatter::Writer>(
+      server_.stats().counters(), server_.stats().gauges(), server_.stats().histograms(),
+      used_only);
+  admin_stream.streamResponse([writer](Buffer::Instance& chunk) -> bool {
+    return writer->nextChunk(chunk, StatsPerChunk);
+  });
+  return Http::Code::OK;
+}
+
+Http::Code AdminImpl::handlerStatsMemory(absl::string_view url, Http::HeaderMap&,
+                                         Buffer::Instance& response, AdminStream&) {
+  const Http::Utility::QueryParams params = Http::Utility::parseQueryString(url);
+  uint64_t depth = 2;
+  const auto depth_param = params.find("depth");
+  if (depth_param != params.end() &&
+      (!StringUtil::atoull(depth_param->second.c_str(), depth) || depth == 0)) {
+    response.add("usage: /stats/memory?depth=<number of leading name segments, at least 1>\n");
+    return Http::Code::BadRequest;
+  }
+
+  // Scopes are not tracked once stats are created, so stats are grouped by the first `depth`
+  // segments of their name, which matches the scope for stats such as "cluster.<name>." at the
+  // default depth.
+  struct ScopeMemory {
+    uint64_t stats_{};
+    uint64_t name_bytes_{};
+  };
+  std::unordered_map<std::string, ScopeMemory> scopes;
+  ScopeMemory total;
+  auto add_stat = [&scopes, &total, depth](const std::string& name) {
+    size_t end = 0;
+    for (uint64_t i = 0; i < depth && end != std::string::npos; ++i) {
+      end = name.find('.', i == 0 ? 0 : end + 1);
+    }
+    ScopeMemory& scope = scopes[name.substr(0, end)];
+    ++scope.stats_;
+    scope.name_bytes_ += name.size();
+    ++total.stats_;
+    total.name_bytes_ += name.size();
+  };
+  for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
+    add_stat(counter->name());
+  }
+  for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
+    add_stat(gauge->name());
+  }
+  for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
+    add_stat(histogram->name());
+  }
+
+  std::vector<std::pair<std::string, ScopeMemory>> sorted_scopes(scopes.begin(), scopes.end());
+  std::sort(sorted_scopes.begin(), sorted_scopes.end(),
+            [](const std::pair<std::string, ScopeMemory>& a,
+               const std::pair<std::string, ScopeMemory>& b) {
+              return a.second.name_bytes_ != b.second.name_bytes_
+                         ? a.second.name_bytes_ > b.second.name_bytes_
+                         : a.first < b.first;
+            });
+
+  response.add(fmt::format("total: {} stats, {} name bytes, {} tag-extracted names, {} tag sets\n",
+                           total.stats_, total.name_bytes_,
+                           Stats::TagExtractedNamePool::get().size(),
+                           Stats::TagVectorPool::get().size()));
+  for (const auto& scope : sorted_scopes) {
+    response.add(fmt::format("{}: {} stats, {} name bytes\n", scope.first, scope.second.stats_,
+                             scope.second.name_bytes_));
+  }
   return Http::Code::OK;
 }
 
 std::string PrometheusStatsFormatter::sanitizeName(const std::string& name) {
   // The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by
   // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/.
-  std::string stats_name = std::regex_replace(name, PromRegex, "_");
-  if (stats_name[0] >= '0' && stats_name[0] <= '9') {
-    return fmt::format("_{}", stats_name);
-  } else {
-    return stats_name;
+  std::string stats_name;
+  stats_name.reserve(name.size() + 1);
+  if (!name.empty() && absl::ascii_isdigit(name[0])) {
+    stats_name.push_back('_');
+  }
+  for (const char c : name) {
+    stats_name.push_back(absl::ascii_isalnum(c) ? c : '_');
   }
+  return stats_name;
 }
 
 std::string PrometheusStatsFormatter::formattedTags(const std::vector<Stats::Tag>& tags) {
@@ -760,71 +898,114 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::GaugeSharedPtr>& gauges,
     const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
     const bool used_only) {
-  std::unordered_set<std::string> metric_type_tracker;
-  for (const auto& counter : counters) {
-    if (!shouldShowMetric(counter, used_only)) {
-      continue;
-    }
-
-    const std::string tags = formattedTags(counter->tags());
-    const std::string metric_name = metricName(counter->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} counter\n", metric_name));
-    }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, counter->value()));
+  Writer writer(std::vector<Stats::CounterSharedPtr>(counters),
+                std::vector<Stats::GaugeSharedPtr>(gauges),
+                std::vector<Stats::ParentHistogramSharedPtr>(histograms), used_only);
+  while (writer.nextChunk(response, std::numeric_limits<uint64_t>::max())) {
   }
+  return writer.metricTypes();
+}
 
-  for (const auto& gauge : gauges) {
-    if (!shouldShowMetric(gauge, used_only)) {
+PrometheusStatsFormatter::Writer::Writer(std::vector<Stats::CounterSharedPtr>&& counters,
+                                         std::vector<Stats::GaugeSharedPtr>&& gauges,
+                                         std::vector<Stats::ParentHistogramSharedPtr>&& histograms,
+                                         bool used_only)
+    : counters_(std::move(counters)), gauges_(std::move(gauges)),
+      histograms_(std::move(histograms)), used_only_(used_only) {}
+
+bool PrometheusStatsFormatter::Writer::nextChunk(Buffer::Instance& response, uint64_t max_stats) {
+  // Only stats that are written count towards max_stats, so that a chunk is never empty just
+  // because of a run of unused stats.
+  uint64_t written = 0;
+  for (; next_counter_ < counters_.size() && written < max_stats; ++next_counter_) {
+    const Stats::Counter& counter = *counters_[next_counter_];
+    if (!shouldShowMetric(counters_[next_counter_], used_only_)) {
       continue;
     }
+    const std::string& metric_name = metricName(counter, "counter", response);
+    response.add(
+        fmt::format("{0}{{{1}}} {2}\n", metric_name, formattedTags(counter), counter.value()));
+    ++written;
+  }
 
-    const std::string tags = formattedTags(gauge->tags());
-    const std::string metric_name = metricName(gauge->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} gauge\n", metric_name));
+  for (; next_gauge_ < gauges_.size() && written < max_stats; ++next_gauge_) {
+    const Stats::Gauge& gauge = *gauges_[next_gauge_];
+    if (!shouldShowMetric(gauges_[next_gauge_], used_only_)) {
+      continue;
     }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, gauge->value()));
+    const std::string& metric_name = metricName(gauge, "gauge", response);
+    response.add(
+        fmt::format("{0}{{{1}}} {2}\n", metric_name, formattedTags(gauge), gauge.value()));
+    ++written;
   }
 
-  for (const auto& histogram : histograms) {
-    if (!shouldShowMetric(histogram, used_only)) {
+  for (; next_histogram_ < histograms_.size() && written < max_stats; ++next_histogram_) {
+    if (!shouldShowMetric(histograms_[next_histogram_], used_only_)) {
       continue;
     }
+    writeHistogram(*histograms_[next_histogram_], response);
+    ++written;
+  }
 
-    const std::string tags = formattedTags(histogram->tags());
-    const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
+  return next_histogram_ < histograms_.size() || next_gauge_ < gauges_.size() ||
+         next_counter_ < counters_.size();
+}
 
-    const std::string metric_name = metricName(histogram->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} histogram\n", metric_name));
-    }
+const std::string& PrometheusStatsFormatter::Writer::metricName(const Stats::Metric& metric,
+                                                                absl::string_view type,
+                                                                Buffer::Instance& response) {
+  auto it = metric_names_.find(&metric.tagExtractedName());
+  if (it != metric_names_.end()) {
+    return it->second;
+  }
 
-    const Stats::HistogramStatistics& stats = histogram->cumulativeStatistics();
-    const std::vector<double>& supported_buckets = stats.supportedBuckets();
-    const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
-    for (size_t i = 0; i < supported_buckets.size(); ++i) {
-      double bucket = supported_buckets[i];
-      uint64_t value = computed_buckets[i];
-      // We want to print the bucket in a fixed point (non-scientific) format. The fmt library
-      // doesn't have a specific modifier to format as a fixed-point value only so we use the
-      // 'g' operator which prints the number in general fixed point format or scientific format
-      // with precision 50 to round the number up to 32 significant digits in fixed point format
-      // which should cover pretty much all cases
-      response.add(fmt::format("{0}_bucket{{{1}le=\"{2:.32g}\"}} {3}\n", metric_name, hist_tags,
-                               bucket, value));
-    }
+  it = metric_names_
+           .emplace(&metric.tagExtractedName(),
+                    PrometheusStatsFormatter::metricName(metric.tagExtractedName()))
+           .first;
+  // Distinct tag-extracted names may sanitize to the same metric name, so the type is tracked by
+  // metric name rather than by cache entry.
+  if (metric_type_tracker_.insert(it->second).second) {
+    response.add(fmt::format("# TYPE {0} {1}\n", it->second, type));
+  }
+  return it->second;
+}
 
-    response.add(fmt::format("{0}_bucket{{{1}le=\"+Inf\"}} {2}\n", metric_name, hist_tags,
-                             stats.sampleCount()));
-    response.add(fmt::format("{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags, stats.sampleSum()));
-    response.add(fmt::format("{0}_count{{{1}}} {2}\n", metric_name, tags, stats.sampleCount()));
+const std::string& PrometheusStatsFormatter::Writer::formattedTags(const Stats::Metric& metric) {
+  auto it = formatted_tags_.find(&metric.tags());
+  if (it == formatted_tags_.end()) {
+    it = formatted_tags_
+             .emplace(&metric.tags(), PrometheusStatsFormatter::formattedTags(metric.tags()))
+             .first;
+  }
+  return it->second;
+}
+
+void PrometheusStatsFormatter::Writer::writeHistogram(const Stats::ParentHistogram& histogram,
+                                                      Buffer::Instance& response) {
+  const std::string& tags = formattedTags(histogram);
+  const std::string hist_tags = histogram.tags().empty() ? EMPTY_STRING : (tags + ",");
+  const std::string& metric_name = metricName(histogram, "histogram", response);
+
+  const Stats::HistogramStatistics& stats = histogram.cumulativeStatistics();
+  const std::vector<double>& supported_buckets = stats.supportedBuckets();
+  const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
+  for (size_t i = 0; i < supported_buckets.size(); ++i) {
+    double bucket = supported_buckets[i];
+    uint64_t value = computed_buckets[i];
+    // We want to print the bucket in a fixed point (non-scientific) format. The fmt library
+    // doesn't have a specific modifier to format as a fixed-point value only so we use the
+    // 'g' operator which prints the number in general fixed point format or scientific format
+    // with precision 50 to round the number up to 32 significant digits in fixed point format
+    // which should cover pretty much all cases
+    response.add(fmt::format("{0}_bucket{{{1}le=\"{2:.32g}\"}} {3}\n", metric_name, hist_tags,
+                             bucket, value));
   }
 
-  return metric_type_tracker.size();
+  response.add(fmt::format("{0}_bucket{{{1}le=\"+Inf\"}} {2}\n", metric_name, hist_tags,
+                           stats.sampleCount()));
+  response.add(fmt::format("{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags, stats.sampleSum()));
+  response.add(fmt::format("{0}_count{{{1}}} {2}\n", metric_name, tags, stats.sampleCount()));
 }
 
 std::string
@@ -1072,6 +1253,21 @@ void AdminFilter::onComplete() {
   RELEASE_ASSERT(request_headers_, "");
   Http::Code code = parent_.runCallback(path, *header_map, response, *this);
   populateFallbackResponseHeaders(code, *header_map);
+  if (streaming_callback_) {
+    // The rest of the response is encoded a chunk per dispatcher iteration, so that the main
+    // thread can service other events in between and the response is never buffered in full.
+    callbacks_->encodeHeaders(std::move(header_map), false);
+    if (response.length() > 0) {
+      callbacks_->encodeData(response, false);
+    }
+    stream_timer_ = callbacks_->dispatcher().createTimer([this]() -> void { onStreamTimer(); });
+    callbacks_->addDownstreamWatermarkCallbacks(*this);
+    if (high_watermark_count_ == 0) {
+      stream_timer_->enableTimer(std::chrono::milliseconds(0));
+    }
+    return;
+  }
+
   callbacks_->encodeHeaders(std::move(header_map),
                             end_stream_on_complete_ && response.length() == 0);
 
@@ -1080,6 +1276,20 @@ void AdminFilter::onComplete() {
   }
 }
 
+void AdminFilter::onStreamTimer() {
+  Buffer::OwnedImpl chunk;
+  const bool more = streaming_callback_(chunk);
+  if (!more) {
+    streaming_callback_ = nullptr;
+  }
+  callbacks_->encodeData(chunk, !more);
+  // Encoding may push the connection over its high watermark, in which case streaming resumes
+  // from onBelowWriteBufferLowWatermark().
+  if (more && high_watermark_count_ == 0) {
+    stream_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
 AdminImpl::NullRouteConfigProvider::NullRouteConfigProvider(TimeSource& time_source)
     : config_(new Router::NullConfigImpl()), time_source_(time_source) {}
 
@@ -1146,6 +1356,8 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
           {"/stats", "print server stats", MAKE_ADMIN_HANDLER(handlerStats), false, false},
           {"/stats/prometheus", "print server stats in prometheus format",
            MAKE_ADMIN_HANDLER(handlerPrometheusStats), false, false},
+          {"/stats/memory", "print stat counts and name bytes grouped by scope",
+           MAKE_ADMIN_HANDLER(handlerStatsMemory), false, false},
           {"/listeners", "print listener addresses", MAKE_ADMIN_HANDLER(handlerListenerInfo), false,
            false},
           {"/runtime", "print runtime values", MAKE_ADMIN_HANDLER(handlerRuntime), false, false},
@@ -1335,6 +1547,7 @@ Http::Code AdminImpl::request(absl::string_view path_and_query, absl::string_vie
   Buffer::OwnedImpl response;
 
   Http::Code code = runCallback(path_and_query, response_headers, response, filter);
+  filter.drainStreamedResponse(response);
   populateFallbackResponseHeaders(code, response_headers);
   body = response.toString();
   return code;
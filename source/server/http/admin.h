@@ -4,10 +4,12 @@
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "envoy/admin/v2alpha/clusters.pb.h"
+#include "envoy/event/timer.h"
 #include "envoy/http/filter.h"
 #include "envoy/network/filter.h"
 #include "envoy/network/listen_socket.h"
@@ -245,6 +247,9 @@ private:
   Http::Code handlerPrometheusStats(absl::string_view path_and_query,
                                     Http::HeaderMap& response_headers, Buffer::Instance& response,
                                     AdminStream&);
+  Http::Code handlerStatsMemory(absl::string_view path_and_query,
+                                Http::HeaderMap& response_headers, Buffer::Instance& response,
+                                AdminStream&);
   Http::Code handlerRuntime(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                             Buffer::Instance& response, AdminStream&);
   Http::Code handlerRuntimeModify(absl::string_view path_and_query,
@@ -324,6 +329,7 @@ private:
  * A terminal HTTP filter that implements server admin functionality.
  */
 class AdminFilter : public Http::StreamDecoderFilter,
+                    public Http::DownstreamWatermarkCallbacks,
                     public AdminStream,
                     Logger::Loggable<Logger::Id::admin> {
 public:
@@ -346,6 +352,18 @@ public:
   Http::StreamDecoderFilterCallbacks& getDecoderFilterCallbacks() const override;
   const Buffer::Instance* getRequestBody() const override;
   const Http::HeaderMap& getRequestHeaders() const override;
+  void streamResponse(StreamingCallback cb) override { streaming_callback_ = std::move(cb); }
+
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override;
+  void onBelowWriteBufferLowWatermark() override;
+
+  /**
+   * Appends the whole of a streamed response to a buffer. Used when there is no dispatcher to
+   * stream the response from, as in AdminImpl::request().
+   * @param response supplies the buffer to append to.
+   */
+  void drainStreamedResponse(Buffer::Instance& response);
 
 private:
   /**
@@ -353,6 +371,11 @@ private:
    */
   void onComplete();
 
+  /**
+   * Encodes the next chunk of a streamed response, and schedules the one after it.
+   */
+  void onStreamTimer();
+
   AdminImpl& parent_;
   // Handlers relying on the reference should use addOnDestroyCallback()
   // to add a callback that will notify them when the reference is no
@@ -361,6 +384,9 @@ private:
   Http::HeaderMap* request_headers_{};
   std::list<std::function<void()>> on_destroy_callbacks_;
   bool end_stream_on_complete_ = true;
+  StreamingCallback streaming_callback_;
+  Event::TimerPtr stream_timer_;
+  uint32_t high_watermark_count_{};
 };
 
 /**
@@ -389,6 +415,53 @@ public:
    */
   static std::string metricName(const std::string& extractedName);
 
+  /**
+   * Formats a snapshot of stats a few at a time, so that a scrape can be streamed across several
+   * dispatcher iterations. Stats share their tag-extracted names and tag vectors (see
+   * Stats::InternPool), so sanitized names and formatted tags are cached by address and computed
+   * once per distinct value rather than once per stat.
+   */
+  class Writer {
+  public:
+    Writer(std::vector<Stats::CounterSharedPtr>&& counters,
+           std::vector<Stats::GaugeSharedPtr>&& gauges,
+           std::vector<Stats::ParentHistogramSharedPtr>&& histograms, bool used_only);
+
+    /**
+     * Appends up to max_stats more stats to the response.
+     * @return bool true if there are stats left to write.
+     */
+    bool nextChunk(Buffer::Instance& response, uint64_t max_stats);
+
+    /**
+     * @return uint64_t total number of metric types written so far.
+     */
+    uint64_t metricTypes() const { return metric_type_tracker_.size(); }
+
+  private:
+    /**
+     * @return const std::string& the cached metric name for a stat, appending a TYPE line to the
+     * response the first time the name is seen.
+     */
+    const std::string& metricName(const Stats::Metric& metric, absl::string_view type,
+                                  Buffer::Instance& response);
+    const std::string& formattedTags(const Stats::Metric& metric);
+    void writeHistogram(const Stats::ParentHistogram& histogram, Buffer::Instance& response);
+
+    const std::vector<Stats::CounterSharedPtr> counters_;
+    const std::vector<Stats::GaugeSharedPtr> gauges_;
+    const std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+    const bool used_only_;
+    size_t next_counter_{};
+    size_t next_gauge_{};
+    size_t next_histogram_{};
+    // Keyed by the address of the stat's tag-extracted name and tags, which the snapshot above
+    // keeps alive for the lifetime of the writer.
+    std::unordered_map<const std::string*, std::string> metric_names_;
+    std::unordered_map<const std::vector<Stats::Tag>*, std::string> formatted_tags_;
+    std::unordered_set<std::string> metric_type_tracker_;
+  };
+
 private:
   /**
    * Take a string and sanitize it according to Prometheus conventions.
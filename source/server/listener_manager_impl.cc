@@ -437,7 +437,7 @@ void ListenerImpl::convertDestinationIPsMapToTrie() {
     auto& destination_ips_pair = port.second;
     auto& destination_ips_map = destination_ips_pair.first;
     std::vector<std::pair<ServerNamesMapSharedPtr, std::vector<Network::Address::CidrRange>>> list;
-    for (const auto& entry : destination_ips_map) {
+    for (auto& entry : destination_ips_map) {
       std::vector<Network::Address::CidrRange> subnets;
       if (entry.first == EMPTY_STRING) {
         if (Network::Address::ipFamilySupported(AF_INET)) {
@@ -449,12 +449,14 @@ void ListenerImpl::convertDestinationIPsMapToTrie() {
       } else {
         subnets.push_back(Network::Address::CidrRange::create(entry.first));
       }
+      // The map is moved rather than copied, as it is only needed to build the trie.
       list.push_back(
           std::make_pair<ServerNamesMapSharedPtr, std::vector<Network::Address::CidrRange>>(
-              std::make_shared<ServerNamesMap>(entry.second),
+              std::make_shared<ServerNamesMap>(std::move(entry.second)),
               std::vector<Network::Address::CidrRange>(subnets)));
     }
     destination_ips_pair.second = std::make_unique<DestinationIPsTrie>(list, true);
+    destination_ips_map.clear();
   }
 }
 
@@ -503,7 +505,7 @@ ListenerImpl::findFilterChainForDestinationIP(const DestinationIPsTrie& destinat
 const Network::FilterChain*
 ListenerImpl::findFilterChainForServerName(const ServerNamesMap& server_names_map,
                                            const Network::ConnectionSocket& socket) const {
-  const std::string server_name(socket.requestedServerName());
+  const absl::string_view server_name = socket.requestedServerName();
 
   // Match on exact server name, i.e. "www.example.com" for "www.example.com".
   const auto server_name_exact_match = server_names_map.find(server_name);
@@ -513,8 +515,8 @@ ListenerImpl::findFilterChainForServerName(const ServerNamesMap& server_names_ma
 
   // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
   size_t pos = server_name.find('.', 1);
-  while (pos < server_name.size() - 1 && pos != std::string::npos) {
-    const std::string wildcard = server_name.substr(pos);
+  while (pos < server_name.size() - 1 && pos != absl::string_view::npos) {
+    const absl::string_view wildcard = server_name.substr(pos);
     const auto server_name_wildcard_match = server_names_map.find(wildcard);
     if (server_name_wildcard_match != server_names_map.end()) {
       return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
@@ -534,7 +536,7 @@ ListenerImpl::findFilterChainForServerName(const ServerNamesMap& server_names_ma
 const Network::FilterChain* ListenerImpl::findFilterChainForTransportProtocol(
     const TransportProtocolsMap& transport_protocols_map,
     const Network::ConnectionSocket& socket) const {
-  const std::string transport_protocol(socket.detectedTransportProtocol());
+  const absl::string_view transport_protocol = socket.detectedTransportProtocol();
 
   // Match on exact transport protocol, e.g. "tls".
   const auto transport_protocol_match = transport_protocols_map.find(transport_protocol);
@@ -18,6 +18,8 @@
 
 #include "server/lds_api.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -316,13 +318,17 @@ public:
   SystemTime last_updated_;
 
 private:
+  // The maps below are looked up with the absl::string_view values of the socket, which
+  // absl::flat_hash_map supports without copying them into a std::string.
   typedef std::array<Network::FilterChainSharedPtr, 3> SourceTypesArray;
-  typedef std::unordered_map<std::string, SourceTypesArray> ApplicationProtocolsMap;
-  typedef std::unordered_map<std::string, ApplicationProtocolsMap> TransportProtocolsMap;
+  typedef absl::flat_hash_map<std::string, SourceTypesArray> ApplicationProtocolsMap;
+  typedef absl::flat_hash_map<std::string, ApplicationProtocolsMap> TransportProtocolsMap;
   // Both exact server names and wildcard domains are part of the same map, in which wildcard
   // domains are prefixed with "." (i.e. ".example.com" for "*.example.com") to differentiate
-  // between exact and wildcard entries.
-  typedef std::unordered_map<std::string, TransportProtocolsMap> ServerNamesMap;
+  // between exact and wildcard entries. A lookup costs one probe for the exact name plus one per
+  // label for the wildcard domains, regardless of how many server names are configured. This only
+  // covers matching: each filter chain still holds its own TLS context.
+  typedef absl::flat_hash_map<std::string, TransportProtocolsMap> ServerNamesMap;
   typedef std::unordered_map<std::string, ServerNamesMap> DestinationIPsMap;
   typedef std::shared_ptr<ServerNamesMap> ServerNamesMapSharedPtr;
   typedef Network::LcTrie::LcTrie<ServerNamesMapSharedPtr> DestinationIPsTrie;
@@ -96,6 +96,14 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
   TCLAP::ValueArg<uint32_t> file_flush_interval_msec("", "file-flush-interval-msec",
                                                      "Interval for log flushing in msec", false,
                                                      10000, "uint32_t", cmd);
+  TCLAP::ValueArg<uint64_t> file_buffer_limit_bytes(
+      "", "file-buffer-limit-bytes",
+      "Maximum number of bytes buffered for each log file, or 0 for no limit", false, 0,
+      "uint64_t", cmd);
+  TCLAP::SwitchArg drop_on_file_buffer_limit(
+      "", "drop-on-file-buffer-limit",
+      "Drop log writes once a log file's buffer is full rather than waiting for it to be flushed",
+      cmd, false);
   TCLAP::ValueArg<uint32_t> drain_time_s("", "drain-time-s", "Hot restart drain time in seconds",
                                          false, 600, "uint32_t", cmd);
   TCLAP::ValueArg<uint32_t> parent_shutdown_time_s("", "parent-shutdown-time-s",
@@ -226,6 +234,8 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
   service_node_ = service_node.getValue();
   service_zone_ = service_zone.getValue();
   file_flush_interval_msec_ = std::chrono::milliseconds(file_flush_interval_msec.getValue());
+  file_buffer_limit_bytes_ = file_buffer_limit_bytes.getValue();
+  drop_on_file_buffer_limit_ = drop_on_file_buffer_limit.getValue();
   drain_time_ = std::chrono::seconds(drain_time_s.getValue());
   parent_shutdown_time_ = std::chrono::seconds(parent_shutdown_time_s.getValue());
   max_stats_ = max_stats.getValue();
@@ -307,6 +317,8 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   }
   command_line_options->mutable_file_flush_interval()->MergeFrom(
       Protobuf::util::TimeUtil::MillisecondsToDuration(fileFlushIntervalMsec().count()));
+  command_line_options->set_file_buffer_limit_bytes(fileBufferLimitBytes());
+  command_line_options->set_drop_on_file_buffer_limit(dropOnFileBufferLimit());
   command_line_options->mutable_parent_shutdown_time()->MergeFrom(
       Protobuf::util::TimeUtil::SecondsToDuration(parentShutdownTime().count()));
   command_line_options->mutable_drain_time()->MergeFrom(
@@ -326,7 +338,8 @@ OptionsImpl::OptionsImpl(const std::string& service_cluster, const std::string&
       local_address_ip_version_(Network::Address::IpVersion::v4), log_level_(log_level),
       log_format_(Logger::Logger::DEFAULT_LOG_FORMAT), restart_epoch_(0u),
       service_cluster_(service_cluster), service_node_(service_node), service_zone_(service_zone),
-      file_flush_interval_msec_(10000), drain_time_(600), parent_shutdown_time_(900),
+      file_flush_interval_msec_(10000), file_buffer_limit_bytes_(0),
+      drop_on_file_buffer_limit_(false), drain_time_(600), parent_shutdown_time_(900),
       mode_(Server::Mode::Serve), max_stats_(ENVOY_DEFAULT_MAX_STATS), hot_restart_disabled_(false),
       signal_handling_enabled_(true), mutex_tracing_enabled_(false), cpuset_threads_(false),
       libevent_buffer_enabled_(false) {}
@@ -61,6 +61,12 @@ public:
   void setFileFlushIntervalMsec(std::chrono::milliseconds file_flush_interval_msec) {
     file_flush_interval_msec_ = file_flush_interval_msec;
   }
+  void setFileBufferLimitBytes(uint64_t file_buffer_limit_bytes) {
+    file_buffer_limit_bytes_ = file_buffer_limit_bytes;
+  }
+  void setDropOnFileBufferLimit(bool drop_on_file_buffer_limit) {
+    drop_on_file_buffer_limit_ = drop_on_file_buffer_limit;
+  }
   void setServiceClusterName(const std::string& service_cluster) {
     service_cluster_ = service_cluster;
   }
@@ -99,6 +105,8 @@ public:
   std::chrono::milliseconds fileFlushIntervalMsec() const override {
     return file_flush_interval_msec_;
   }
+  uint64_t fileBufferLimitBytes() const override { return file_buffer_limit_bytes_; }
+  bool dropOnFileBufferLimit() const override { return drop_on_file_buffer_limit_; }
   const std::string& serviceClusterName() const override { return service_cluster_; }
   const std::string& serviceNodeName() const override { return service_node_; }
   const std::string& serviceZone() const override { return service_zone_; }
@@ -133,6 +141,8 @@ private:
   std::string service_node_;
   std::string service_zone_;
   std::chrono::milliseconds file_flush_interval_msec_;
+  uint64_t file_buffer_limit_bytes_;
+  bool drop_on_file_buffer_limit_;
   std::chrono::seconds drain_time_;
   std::chrono::seconds parent_shutdown_time_;
   Server::Mode mode_;
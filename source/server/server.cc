@@ -2,6 +2,7 @@
 
 #include <signal.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <functional>
@@ -36,6 +37,7 @@
 #include "common/router/rds_impl.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/singleton/manager_impl.h"
+#include "common/stats/source_impl.h"
 #include "common/stats/thread_local_store.h"
 #include "common/upstream/cluster_manager_impl.h"
 
@@ -66,7 +68,7 @@ InstanceImpl::InstanceImpl(const Options& options, Event::TimeSystem& time_syste
       worker_factory_(thread_local_, *api_, hooks),
       dns_resolver_(dispatcher_->createDnsResolver({})),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+                          store, options.fileBufferLimitBytes(), options.dropOnFileBufferLimit()),
       terminated_(false),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
                                                   : nullptr),
@@ -158,14 +160,36 @@ void InstanceImpl::flushStats() {
     server_stats_->total_connections_.set(numConnections() + info.num_connections_);
     server_stats_->days_until_first_cert_expiring_.set(
         sslContextManager().daysUntilFirstCertExpires());
-    InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_.source());
-    // TODO(ramaraochavali): consider adding different flush interval for histograms.
-    if (stat_flush_timer_ != nullptr) {
-      stat_flush_timer_->enableTimer(config_.statsFlushInterval());
+    if (stats_flush_thread_ == nullptr) {
+      InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_.source());
+      enableStatFlushTimer();
+      return;
     }
+
+    // Sinks that can only be flushed on the main thread are flushed now, and the rest on the stats
+    // flush thread. All of them see the same snapshot of the store. The next flush is not scheduled
+    // until the stats flush thread is done, so flushes never overlap.
+    auto snapshot = std::make_shared<Stats::SnapshotSourceImpl>(stats_store_);
+    std::vector<Stats::Sink*> thread_safe_sinks;
+    for (const auto& sink : config_.statsSinks()) {
+      if (sink->threadSafeFlush()) {
+        thread_safe_sinks.push_back(sink.get());
+      } else {
+        sink->flush(*snapshot);
+      }
+    }
+    stats_flush_thread_->flush(std::move(thread_safe_sinks), snapshot,
+                               [this]() -> void { enableStatFlushTimer(); });
   });
 }
 
+void InstanceImpl::enableStatFlushTimer() {
+  // TODO(ramaraochavali): consider adding different flush interval for histograms.
+  if (stat_flush_timer_ != nullptr) {
+    stat_flush_timer_->enableTimer(config_.statsFlushInterval());
+  }
+}
+
 void InstanceImpl::getParentStats(HotRestart::GetParentStatsInfo& info) {
   info.memory_allocated_ = Memory::Stats::totalCurrentlyAllocated();
   info.num_connections_ = numConnections();
@@ -304,6 +328,31 @@ void InstanceImpl::initialize(const Options& options,
   listener_manager_ =
       std::make_unique<ListenerManagerImpl>(*this, listener_component_factory_, worker_factory_);
 
+  // Like the workers, the stats flush thread must be registered before any thread local slots are
+  // allocated.
+  if (bootstrap_.stats_flush_on_dedicated_thread()) {
+    stats_flush_thread_ = std::make_unique<StatsFlushThread>(thread_local_, *dispatcher_, *api_);
+  }
+
+  // The threads of shared HTTP/2 connection pools are registered for the same reason. They cannot
+  // be started when a cluster first opts in, since threads registered after a slot is set never see
+  // its data, so unless configured they are only started if a static cluster opts in.
+  uint32_t shared_http2_conn_pool_threads = 0;
+  if (bootstrap_.cluster_manager().has_shared_http2_connection_pool_threads()) {
+    shared_http2_conn_pool_threads =
+        bootstrap_.cluster_manager().shared_http2_connection_pool_threads().value();
+  } else if (std::any_of(bootstrap_.static_resources().clusters().begin(),
+                         bootstrap_.static_resources().clusters().end(),
+                         [](const envoy::api::v2::Cluster& cluster) {
+                           return cluster.shared_http2_connection_pool();
+                         })) {
+    shared_http2_conn_pool_threads = 2;
+  }
+  if (shared_http2_conn_pool_threads > 0) {
+    shared_http2_conn_pools_ = std::make_unique<Http::Http2::SharedConnPoolManager>(
+        *api_, thread_local_, shared_http2_conn_pool_threads);
+  }
+
   // The main thread is also registered for thread local updates so that code that does not care
   // whether it runs on the main thread or on workers can still use TLS.
   thread_local_.registerThread(*dispatcher_, true);
@@ -324,7 +373,7 @@ void InstanceImpl::initialize(const Options& options,
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       *admin_, Runtime::LoaderSingleton::get(), stats_store_, thread_local_, *random_generator_,
       dns_resolver_, *ssl_context_manager_, *dispatcher_, *local_info_, *secret_manager_, *api_,
-      http_context_, access_log_manager_, *singleton_manager_);
+      http_context_, access_log_manager_, *singleton_manager_, shared_http2_conn_pools_.get());
 
   // Now the configuration gets parsed. The configuration may start setting
   // thread local data per above. See MainImpl::initialize() for why ConfigImpl
@@ -365,6 +414,10 @@ void InstanceImpl::initialize(const Options& options,
   // GuardDog (deadlock detection) object and thread setup before workers are
   // started and before our own run() loop runs.
   guard_dog_ = std::make_unique<Server::GuardDogImpl>(stats_store_, config_, *api_);
+
+  if (stats_flush_thread_ != nullptr) {
+    stats_flush_thread_->start(*guard_dog_);
+  }
 }
 
 void InstanceImpl::startWorkers() {
@@ -508,6 +561,12 @@ void InstanceImpl::terminate() {
     listener_manager_->stopWorkers();
   }
 
+  // The final flush below happens entirely on the main thread.
+  if (stats_flush_thread_ != nullptr) {
+    stats_flush_thread_->stop();
+    stats_flush_thread_.reset();
+  }
+
   // Only flush if we have not been hot restarted.
   if (stat_flush_timer_) {
     flushStats();
@@ -516,6 +575,10 @@ void InstanceImpl::terminate() {
   if (config_.clusterManager() != nullptr) {
     config_.clusterManager()->shutdown();
   }
+  // Already stopped by the cluster manager unless it was never created.
+  if (shared_http2_conn_pools_ != nullptr) {
+    shared_http2_conn_pools_->shutdown();
+  }
   handler_.reset();
   thread_local_.shutdownThread();
   restarter_.shutdown();
@@ -21,6 +21,7 @@
 #include "common/common/logger_delegates.h"
 #include "common/grpc/async_client_manager_impl.h"
 #include "common/http/context_impl.h"
+#include "common/http/http2/shared_conn_pool.h"
 #include "common/init/manager_impl.h"
 #include "common/memory/heap_shrinker.h"
 #include "common/runtime/runtime_impl.h"
@@ -31,6 +32,7 @@
 #include "server/http/admin.h"
 #include "server/listener_manager_impl.h"
 #include "server/overload_manager_impl.h"
+#include "server/stats_flush_thread.h"
 #include "server/test_hooks.h"
 #include "server/worker_impl.h"
 
@@ -201,6 +203,7 @@ public:
 private:
   ProtobufTypes::MessagePtr dumpBootstrapConfig();
   void flushStats();
+  void enableStatFlushTimer();
   void initialize(const Options& options, Network::Address::InstanceConstSharedPtr local_address,
                   ComponentFactory& component_factory, TestHooks& hooks);
   void loadServerFlags(const absl::optional<std::string>& flags_path);
@@ -241,6 +244,8 @@ private:
   ProdListenerComponentFactory listener_component_factory_;
   ProdWorkerFactory worker_factory_;
   std::unique_ptr<ListenerManager> listener_manager_;
+  // Must outlive the cluster manager in config_, whose clusters may have pools on its threads.
+  Http::Http2::SharedConnPoolManagerPtr shared_http2_conn_pools_;
   Configuration::MainImpl config_;
   Network::DnsResolverSharedPtr dns_resolver_;
   Event::TimerPtr stat_flush_timer_;
@@ -249,6 +254,7 @@ private:
   AccessLog::AccessLogManagerImpl access_log_manager_;
   std::unique_ptr<Upstream::ClusterManagerFactory> cluster_manager_factory_;
   std::unique_ptr<Server::GuardDog> guard_dog_;
+  StatsFlushThreadPtr stats_flush_thread_;
   bool terminated_;
   std::unique_ptr<Logger::FileSinkDelegate> file_logger_;
   envoy::config::bootstrap::v2::Bootstrap bootstrap_;
@@ -0,0 +1,55 @@
+#include "server/stats_flush_thread.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Server {
+
+StatsFlushThread::StatsFlushThread(ThreadLocal::Instance& tls, Event::Dispatcher& main_dispatcher,
+                                   Api::Api& api)
+    : tls_(tls), main_dispatcher_(main_dispatcher), api_(api),
+      dispatcher_(api.allocateDispatcher()) {
+  tls_.registerThread(*dispatcher_, false);
+}
+
+void StatsFlushThread::start(GuardDog& guard_dog) {
+  ASSERT(!thread_);
+  thread_ =
+      api_.threadFactory().createThread([this, &guard_dog]() -> void { threadRoutine(guard_dog); });
+}
+
+void StatsFlushThread::stop() {
+  // Initialization may fail before the thread is started.
+  if (thread_) {
+    dispatcher_->exit();
+    thread_->join();
+    thread_.reset();
+  }
+}
+
+void StatsFlushThread::flush(std::vector<Stats::Sink*>&& sinks, Stats::SourceSharedPtr snapshot,
+                             std::function<void()> completion) {
+  dispatcher_->post([this, sinks = std::move(sinks), snapshot, completion]() -> void {
+    for (Stats::Sink* sink : sinks) {
+      ASSERT(sink->threadSafeFlush());
+      sink->flush(*snapshot);
+    }
+    main_dispatcher_.post(completion);
+  });
+}
+
+void StatsFlushThread::threadRoutine(GuardDog& guard_dog) {
+  ENVOY_LOG(debug, "stats flush thread entering dispatch loop");
+  auto watchdog = guard_dog.createWatchDog(api_.threadFactory().currentThreadId());
+  watchdog->startWatchdog(*dispatcher_);
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  ENVOY_LOG(debug, "stats flush thread exited dispatch loop");
+  guard_dog.stopWatching(watchdog);
+
+  // Thread local sink state, such as statsd connections, must be destroyed on this thread.
+  tls_.shutdownThread();
+  watchdog.reset();
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/server/guarddog.h"
+#include "envoy/stats/sink.h"
+#include "envoy/stats/source.h"
+#include "envoy/thread/thread.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * A thread that stats sinks are flushed on, so that formatting and writing stats does not hold up
+ * the main thread. Like a worker, the thread is registered for thread local updates, so sinks that
+ * keep their connections in thread local storage work the same way as on the main thread.
+ */
+class StatsFlushThread : Logger::Loggable<Logger::Id::main> {
+public:
+  StatsFlushThread(ThreadLocal::Instance& tls, Event::Dispatcher& main_dispatcher, Api::Api& api);
+
+  /**
+   * Start the thread.
+   * @param guard_dog supplies the guard dog that watches the thread.
+   */
+  void start(GuardDog& guard_dog);
+
+  /**
+   * Stop the thread, waiting for any flush in progress to finish. Completions of flushes that have
+   * not yet run are dropped.
+   */
+  void stop();
+
+  /**
+   * Flush a snapshot to sinks on the thread.
+   * @param sinks supplies the sinks to flush, which must have a thread safe flush and must outlive
+   *        the thread.
+   * @param snapshot supplies the metrics to flush.
+   * @param completion supplies a callback posted to the main dispatcher once all the sinks have
+   *        been flushed.
+   */
+  void flush(std::vector<Stats::Sink*>&& sinks, Stats::SourceSharedPtr snapshot,
+             std::function<void()> completion);
+
+private:
+  void threadRoutine(GuardDog& guard_dog);
+
+  ThreadLocal::Instance& tls_;
+  Event::Dispatcher& main_dispatcher_;
+  Api::Api& api_;
+  Event::DispatcherPtr dispatcher_;
+  Thread::ThreadPtr thread_;
+};
+
+typedef std::unique_ptr<StatsFlushThread> StatsFlushThreadPtr;
+
+} // namespace Server
+} // namespace Envoy
@@ -817,6 +817,25 @@ TEST(AccessLogFormatterTest, CompositeFormatterSuccess) {
   }
 }
 
+// Headers that the header map keeps inline are read through their inline accessors, and other
+// headers by name. Both must format the same way.
+TEST(AccessLogFormatterTest, CompositeFormatterInlineHeaders) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestHeaderMapImpl request_header{
+      {":method", "GET"}, {"user-agent", "curl/7.64.0"}, {"x-custom", "custom"}};
+  Http::TestHeaderMapImpl response_header{{"x-envoy-upstream-service-time", "12"}};
+  Http::TestHeaderMapImpl response_trailer{{"grpc-status", "0"}};
+
+  const std::string format =
+      "%REQ(:METHOD)% %REQ(X-MISSING?USER-AGENT):4% %REQ(X-REQUEST-ID?X-CUSTOM)% "
+      "%REQ(X-REQUEST-ID)%|%REQ(X-REQUEST-ID):0%|%RESP(X-ENVOY-UPSTREAM-SERVICE-TIME)% "
+      "%TRAILER(GRPC-STATUS)% %TRAILER(GRPC-MESSAGE)%";
+  FormatterImpl formatter(format);
+
+  EXPECT_EQ("GET curl custom -||12 0 -",
+            formatter.format(request_header, response_header, response_trailer, stream_info));
+}
+
 TEST(AccessLogFormatterTest, ParserFailures) {
   AccessLogFormatParser parser;
 
@@ -28,7 +28,7 @@ class AccessLogManagerImplTest : public testing::Test {
 protected:
   AccessLogManagerImplTest()
       : file_(new NiceMock<Filesystem::MockFile>), thread_factory_(Thread::threadFactoryForTest()),
-        access_log_manager_(timeout_40ms_, api_, dispatcher_, lock_, store_) {
+        access_log_manager_(timeout_40ms_, api_, dispatcher_, lock_, store_, 0, false) {
     EXPECT_CALL(file_system_, createFile("foo"))
         .WillOnce(Return(ByMove(std::unique_ptr<NiceMock<Filesystem::MockFile>>(file_))));
 
@@ -301,6 +301,129 @@ TEST_F(AccessLogManagerImplTest, bigDataChunkShouldBeFlushedWithoutTimer) {
   EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+TEST_F(AccessLogManagerImplTest, dropOnBufferLimit) {
+  AccessLogManagerImpl access_log_manager(timeout_40ms_, api_, dispatcher_, lock_, store_, 10,
+                                          true);
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  EXPECT_CALL(*file_, open_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager.createAccessLog("foo");
+
+  // The first write is flushed straight away.
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("prime"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  log_file->write("prime");
+
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    while (file_->num_writes_ != 1) {
+      file_->write_event_.wait(file_->write_mutex_);
+    }
+  }
+
+  // Fill the buffer up to the limit. The next write does not fit, so it is dropped and the buffer
+  // is flushed.
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("0123456789"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  log_file->write("0123456789");
+  log_file->write("dropped");
+  EXPECT_EQ(1U, store_.counter("access_log_file.write_dropped").value());
+  EXPECT_EQ(0U, store_.counter("access_log_file.write_blocked").value());
+
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    while (file_->num_writes_ != 2) {
+      file_->write_event_.wait(file_->write_mutex_);
+    }
+  }
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, blockOnBufferLimit) {
+  AccessLogManagerImpl access_log_manager(timeout_40ms_, api_, dispatcher_, lock_, store_, 10,
+                                          false);
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  EXPECT_CALL(*file_, open_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager.createAccessLog("foo");
+
+  Sequence sq;
+  EXPECT_CALL(*file_, write_(_))
+      .InSequence(sq)
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("prime"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  EXPECT_CALL(*file_, write_(_))
+      .InSequence(sq)
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("0123456789"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  EXPECT_CALL(*file_, write_(_))
+      .InSequence(sq)
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("blocked"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log_file->write("prime");
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    while (file_->num_writes_ != 1) {
+      file_->write_event_.wait(file_->write_mutex_);
+    }
+  }
+
+  // The second write does not fit in the buffer, so it waits for the buffer to be flushed rather
+  // than being dropped.
+  log_file->write("0123456789");
+  Thread::ThreadPtr writer =
+      thread_factory_.createThread([&log_file]() -> void { log_file->write("blocked"); });
+  writer->join();
+  EXPECT_EQ(1U, store_.counter("access_log_file.write_blocked").value());
+  EXPECT_EQ(0U, store_.counter("access_log_file.write_dropped").value());
+
+  log_file->flush();
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    EXPECT_EQ(3U, file_->num_writes_);
+  }
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// Test that a synchronous flush that drains the buffer wakes writers waiting for the buffer limit,
+// whether it races ahead of the flush thread or not.
+TEST_F(AccessLogManagerImplTest, flushWakesBlockedWriter) {
+  AccessLogManagerImpl access_log_manager(timeout_40ms_, api_, dispatcher_, lock_, store_, 10,
+                                          false);
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  EXPECT_CALL(*file_, open_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager.createAccessLog("foo");
+  ON_CALL(*file_, write_(_))
+      .WillByDefault(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  for (int i = 0; i < 100; i++) {
+    log_file->write("0123456789");
+    Thread::ThreadPtr writer =
+        thread_factory_.createThread([&log_file]() -> void { log_file->write("blocked"); });
+    log_file->flush();
+    writer->join();
+    log_file->flush();
+  }
+  EXPECT_EQ(0U, store_.counter("access_log_file.write_dropped").value());
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 TEST_F(AccessLogManagerImplTest, reopenAllFiles) {
   EXPECT_CALL(dispatcher_, createTimer_(_)).WillRepeatedly(ReturnNew<NiceMock<Event::MockTimer>>());
 
@@ -0,0 +1,79 @@
+// Usage: bazel run //test/common/http:conn_manager_utility_speed_test
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/event/real_time_system.h"
+#include "common/http/conn_manager_utility.h"
+#include "common/http/header_map_impl.h"
+#include "common/runtime/runtime_impl.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/stream_info/stream_info_impl.h"
+#include "common/tracing/http_tracer_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// A loader with a single empty snapshot, so that every runtime check uses its default value.
+class StaticLoader : public Runtime::Loader {
+public:
+  StaticLoader()
+      : stats_{ALL_RUNTIME_STATS(POOL_COUNTER(store_), POOL_GAUGE(store_))},
+        snapshot_(generator_, stats_, std::vector<Runtime::Snapshot::OverrideLayerConstPtr>{}) {}
+
+  // Runtime::Loader
+  Runtime::Snapshot& snapshot() override { return snapshot_; }
+  void mergeValues(const std::unordered_map<std::string, std::string>&) override {}
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  Runtime::RandomGeneratorImpl generator_;
+  Runtime::RuntimeStats stats_;
+  Runtime::SnapshotImpl snapshot_;
+};
+
+// Measures the tracing work done for each request with tracing enabled and 0.1% random sampling:
+// generating the x-request-id, making the sampling decision and reading it back.
+void BM_TracingDecision(benchmark::State& state) {
+  StaticLoader runtime;
+  Runtime::RandomGeneratorImpl random;
+  Event::RealTimeSystem time_system;
+  StreamInfo::StreamInfoImpl stream_info(time_system);
+  const TracingConnectionManagerConfig tracing_config{
+      Tracing::OperationName::Ingress, {}, 100, 10, 100, false};
+
+  uint64_t traced = 0;
+  for (auto _ : state) {
+    HeaderMapImpl request_headers;
+    request_headers.insertRequestId().value(random.uuid());
+    ConnectionManagerUtility::mutateTracingRequestHeader(request_headers, runtime,
+                                                         tracing_config);
+    if (Tracing::HttpTracerUtility::isTracing(stream_info, request_headers).traced) {
+      traced++;
+    }
+  }
+  benchmark::DoNotOptimize(traced);
+}
+BENCHMARK(BM_TracingDecision);
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -987,6 +987,39 @@ TEST_F(ConnectionManagerUtilityTest, RandomSamplingWhenGlobalSet) {
             UuidUtils::isTraceableUuid(request_headers.get_("x-request-id")));
 }
 
+// Sampling a request whose x-request-id references memory the header map does not own copies the
+// value rather than modifying it in place.
+TEST_F(ConnectionManagerUtilityTest, RandomSamplingReferencedRequestId) {
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("tracing.random_sampling", 10000, _, 10000))
+      .WillOnce(Return(true));
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("tracing.global_enabled", 100, _))
+      .WillOnce(Return(true));
+
+  const std::string request_id = "125a4afb-6f55-44ba-ad80-413f09f48a28";
+  Http::TestHeaderMapImpl request_headers;
+  request_headers.addReference(Headers::get().RequestId, request_id);
+  callMutateRequestHeaders(request_headers, Protocol::Http2);
+
+  EXPECT_EQ("125a4afb-6f55-94ba-ad80-413f09f48a28", request_headers.get_("x-request-id"));
+  EXPECT_EQ("125a4afb-6f55-44ba-ad80-413f09f48a28", request_id);
+}
+
+// Not sampled, global on. The x-request-id is left untouched.
+TEST_F(ConnectionManagerUtilityTest, NoTraceWhenNotSampledAndGlobalSet) {
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("tracing.random_sampling", 10000, _, 10000))
+      .WillOnce(Return(false));
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("tracing.global_enabled", 100, _))
+      .WillOnce(Return(true));
+
+  const std::string request_id = "125a4afb-6f55-44ba-ad80-413f09f48a28";
+  Http::TestHeaderMapImpl request_headers;
+  request_headers.addReference(Headers::get().RequestId, request_id);
+  callMutateRequestHeaders(request_headers, Protocol::Http2);
+
+  EXPECT_EQ(HeaderString::Type::Reference, request_headers.RequestId()->value().type());
+  EXPECT_EQ(request_id, request_headers.get_("x-request-id"));
+}
+
 // Sampling must not be done on client traced.
 TEST_F(ConnectionManagerUtilityTest, SamplingMustNotBeDoneOnClientTraced) {
   EXPECT_CALL(runtime_.snapshot_, featureEnabled("tracing.random_sampling", 10000, _, 10000))
@@ -723,6 +723,23 @@ TEST_F(Http2ConnPoolImplTest, DrainedConnectionsNotActive) {
 
   closeClient(0);
 }
+
+TEST_F(Http2ConnPoolImplTest, Prewarm) {
+  expectClientCreate();
+  pool_.prewarm();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+
+  // The pool already has a primary client so this is a no-op.
+  pool_.prewarm();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+
+  EXPECT_CALL(*test_clients_[0].connect_timer_, disableTimer());
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  ActiveTestRequest r1(*this, 0, true);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_prefetch_hit_.value());
+  completeRequestCloseUpstream(0, r1);
+}
 } // namespace Http2
 } // namespace Http
 } // namespace Envoy
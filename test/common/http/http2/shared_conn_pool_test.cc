@@ -0,0 +1,277 @@
+#include <functional>
+#include <memory>
+
+#include "common/http/http2/shared_conn_pool.h"
+#include "common/stats/heap_stat_data.h"
+#include "common/stats/stats_options_impl.h"
+#include "common/stats/symbol_table_impl.h"
+#include "common/stats/thread_local_store.h"
+#include "common/thread_local/thread_local_impl.h"
+
+#include "test/common/http/common.h"
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/common.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/printers.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+class SharedConnPoolTest : public testing::Test {
+public:
+  SharedConnPoolTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()),
+        manager_(*api_, tls_, 1) {
+    ON_CALL(inner_encoder_.stream_, bufferLimit()).WillByDefault(Return(1024));
+    // The mock keeps its thread local data for the main thread only.
+    ON_CALL(tls_, shutdownThread()).WillByDefault(Return());
+  }
+
+  ~SharedConnPoolTest() {
+    pool_.reset();
+    manager_.shutdown();
+  }
+
+  ConnectionPool::InstancePtr createPool(const std::vector<uint8_t>& hash_key) {
+    return manager_.createPool(
+        *dispatcher_, host_, Upstream::ResourcePriority::Default, hash_key,
+        [this](Event::Dispatcher& dispatcher) -> ConnectionPool::InstancePtr {
+          auto pool = std::make_unique<NiceMock<ConnectionPool::MockInstance>>();
+          ON_CALL(*pool, newStream(_, _))
+              .WillByDefault(Invoke([this](StreamDecoder& decoder,
+                                           ConnectionPool::Callbacks& callbacks)
+                                        -> ConnectionPool::Cancellable* {
+                inner_decoder_ = &decoder;
+                inner_callbacks_ = &callbacks;
+                return &cancellable_;
+              }));
+          ON_CALL(*pool, prewarm()).WillByDefault(Invoke([this]() -> void { ++prewarms_; }));
+          ++pools_created_;
+          owner_dispatcher_ = &dispatcher;
+          if (!owner_created_.HasBeenNotified()) {
+            owner_created_.Notify();
+          }
+          return pool;
+        });
+  }
+
+  // Runs the given function on the owner thread and waits for it. Everything posted to the owner
+  // thread before this call has run once it returns.
+  void runOnOwner(std::function<void()> cb) {
+    owner_created_.WaitForNotification();
+    absl::Notification done;
+    owner_dispatcher_->post([&cb, &done]() -> void {
+      cb();
+      done.Notify();
+    });
+    done.WaitForNotification();
+  }
+
+  void syncOwner() {
+    runOnOwner([]() -> void {});
+  }
+
+  // Runs the worker dispatcher until the condition holds.
+  void runWorkerUntil(std::function<bool()> condition) {
+    while (!condition()) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  // Creates a stream on pool_ and makes it ready.
+  StreamEncoder& readyStream() {
+    EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_));
+    syncOwner();
+    EXPECT_NE(nullptr, inner_callbacks_);
+
+    runOnOwner([this]() -> void { inner_callbacks_->onPoolReady(inner_encoder_, host_); });
+    EXPECT_CALL(callbacks_.pool_ready_, ready());
+    runWorkerUntil([this]() -> bool { return callbacks_.outer_encoder_ != nullptr; });
+    return *callbacks_.outer_encoder_;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  std::shared_ptr<NiceMock<Upstream::MockHost>> host_{new NiceMock<Upstream::MockHost>()};
+  NiceMock<MockStreamEncoder> inner_encoder_;
+  ConnectionPool::MockCancellable cancellable_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  SharedConnPoolManager manager_;
+  ConnectionPool::InstancePtr pool_;
+  MockStreamDecoder decoder_;
+  ConnPoolCallbacks callbacks_;
+
+  // Written on the owner thread, read once the test has synchronized with it.
+  absl::Notification owner_created_;
+  Event::Dispatcher* owner_dispatcher_{};
+  StreamDecoder* inner_decoder_{};
+  ConnectionPool::Callbacks* inner_callbacks_{};
+  uint32_t pools_created_{};
+  uint32_t prewarms_{};
+};
+
+TEST_F(SharedConnPoolTest, RequestResponse) {
+  pool_ = createPool({});
+  StreamEncoder& encoder = readyStream();
+  EXPECT_TRUE(pool_->hasActiveConnections());
+  EXPECT_EQ(1024U, encoder.getStream().bufferLimit());
+
+  TestHeaderMapImpl request_headers{{":method", "GET"}, {":path", "/"}};
+  EXPECT_CALL(inner_encoder_, encodeHeaders(HeaderMapEqualRef(&request_headers), true));
+  encoder.encodeHeaders(request_headers, true);
+  syncOwner();
+
+  runOnOwner([this]() -> void {
+    inner_decoder_->decodeHeaders(HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, false);
+    Buffer::OwnedImpl data("hello");
+    inner_decoder_->decodeData(data, true);
+  });
+  EXPECT_CALL(decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(decoder_, decodeData(BufferStringEqual("hello"), true));
+  runWorkerUntil([this]() -> bool { return !pool_->hasActiveConnections(); });
+
+  ReadyWatcher drained;
+  EXPECT_CALL(drained, ready());
+  pool_->addDrainedCallback([&drained]() -> void { drained.ready(); });
+}
+
+TEST_F(SharedConnPoolTest, CancelPending) {
+  pool_ = createPool({});
+  ConnectionPool::Cancellable* handle = pool_->newStream(decoder_, callbacks_);
+  EXPECT_NE(nullptr, handle);
+  syncOwner();
+
+  EXPECT_CALL(cancellable_, cancel());
+  handle->cancel();
+  EXPECT_FALSE(pool_->hasActiveConnections());
+  syncOwner();
+}
+
+TEST_F(SharedConnPoolTest, PoolFailure) {
+  pool_ = createPool({});
+  EXPECT_NE(nullptr, pool_->newStream(decoder_, callbacks_));
+  syncOwner();
+
+  runOnOwner([this]() -> void {
+    inner_callbacks_->onPoolFailure(ConnectionPool::PoolFailureReason::ConnectionFailure, "", host_);
+  });
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runWorkerUntil([this]() -> bool { return !pool_->hasActiveConnections(); });
+}
+
+TEST_F(SharedConnPoolTest, LocalReset) {
+  pool_ = createPool({});
+  StreamEncoder& encoder = readyStream();
+
+  MockStreamCallbacks stream_callbacks;
+  encoder.getStream().addCallbacks(stream_callbacks);
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::LocalReset, _));
+  EXPECT_CALL(inner_encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  encoder.getStream().resetStream(StreamResetReason::LocalReset);
+  EXPECT_FALSE(pool_->hasActiveConnections());
+  syncOwner();
+}
+
+TEST_F(SharedConnPoolTest, RemoteResetAndWatermarks) {
+  pool_ = createPool({});
+  StreamEncoder& encoder = readyStream();
+
+  MockStreamCallbacks stream_callbacks;
+  encoder.getStream().addCallbacks(stream_callbacks);
+
+  bool above_high_watermark = false;
+  EXPECT_CALL(stream_callbacks, onAboveWriteBufferHighWatermark())
+      .WillOnce(Invoke([&above_high_watermark]() -> void { above_high_watermark = true; }));
+  runOnOwner([this]() -> void { inner_encoder_.stream_.runHighWatermarkCallbacks(); });
+  runWorkerUntil([&above_high_watermark]() -> bool { return above_high_watermark; });
+
+  EXPECT_CALL(inner_encoder_.stream_, readDisable(true));
+  encoder.getStream().readDisable(true);
+  syncOwner();
+
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::RemoteReset, _));
+  runOnOwner([this]() -> void {
+    inner_encoder_.stream_.resetStream(StreamResetReason::RemoteReset);
+  });
+  runWorkerUntil([this]() -> bool { return !pool_->hasActiveConnections(); });
+}
+
+TEST_F(SharedConnPoolTest, PoolsSharedByKey) {
+  Event::DispatcherPtr other_dispatcher = api_->allocateDispatcher();
+  pool_ = createPool({1});
+  ConnectionPool::InstancePtr same_key = manager_.createPool(
+      *other_dispatcher, host_, Upstream::ResourcePriority::Default, {1},
+      [](Event::Dispatcher&) -> ConnectionPool::InstancePtr { return nullptr; });
+  ConnectionPool::InstancePtr other_key = createPool({2});
+
+  pool_->prewarm();
+  same_key->prewarm();
+  other_key->prewarm();
+  syncOwner();
+  EXPECT_EQ(2U, pools_created_);
+  EXPECT_EQ(3U, prewarms_);
+}
+
+TEST_F(SharedConnPoolTest, NewStreamAfterShutdown) {
+  pool_ = createPool({});
+  manager_.shutdown();
+
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  EXPECT_EQ(nullptr, pool_->newStream(decoder_, callbacks_));
+  EXPECT_FALSE(pool_->hasActiveConnections());
+}
+
+// Pools on the shared threads record stats through thread local storage, which requires the threads
+// to be registered for thread local updates like workers.
+TEST(SharedConnPoolManagerTest, ThreadLocalStats) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher();
+  Stats::SymbolTableImpl symbol_table;
+  Stats::HeapStatDataAllocator alloc(symbol_table);
+  Stats::StatsOptionsImpl stats_options;
+  ThreadLocal::InstanceImpl tls;
+  Stats::ThreadLocalStoreImpl store(stats_options, alloc);
+  SharedConnPoolManager manager(*api, tls, 1);
+  tls.registerThread(*dispatcher, true);
+  store.initializeThreading(*dispatcher, tls);
+
+  absl::Notification recorded;
+  auto host = std::make_shared<NiceMock<Upstream::MockHost>>();
+  ConnectionPool::InstancePtr pool = manager.createPool(
+      *dispatcher, host, Upstream::ResourcePriority::Default, {},
+      [&store, &recorded](Event::Dispatcher&) -> ConnectionPool::InstancePtr {
+        // The same thread local paths as upstream_cx_connect_ms and upstream_cx_length_ms.
+        store.histogram("shared.upstream_cx_connect_ms").recordValue(5);
+        store.counter("shared.upstream_cx_total").inc();
+        recorded.Notify();
+        return std::make_unique<NiceMock<ConnectionPool::MockInstance>>();
+      });
+  pool->prewarm();
+  recorded.WaitForNotification();
+  EXPECT_EQ(1, store.counter("shared.upstream_cx_total").value());
+  pool.reset();
+
+  store.shutdownThreading();
+  tls.shutdownGlobalThreading();
+  manager.shutdown();
+  tls.shutdownThread();
+}
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
@@ -1,9 +1,12 @@
+#include <unistd.h>
+
 #include <memory>
 #include <string>
 
 #include "common/runtime/runtime_impl.h"
 #include "common/stats/isolated_store_impl.h"
 
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/filesystem/mocks.h"
 #include "test/mocks/runtime/mocks.h"
@@ -326,6 +329,50 @@ TEST(LoaderImplTest, All) {
   testNewOverrides(loader, store);
 }
 
+TEST(LoaderImplTest, KeyHandles) {
+  MockRandomGenerator generator;
+  NiceMock<ThreadLocal::MockInstance> tls;
+  Stats::IsolatedStoreImpl store;
+  LoaderImpl loader(generator, store, tls);
+
+  const KeyHandle foo = KeyRegistry::get().registerKey("key_handle_test.foo");
+  const KeyHandle bar = KeyRegistry::get().registerKey("key_handle_test.bar");
+  EXPECT_NE(foo.index(), bar.index());
+  EXPECT_EQ(foo.index(), KeyRegistry::get().registerKey("key_handle_test.foo").index());
+  EXPECT_EQ("key_handle_test.foo", foo.name());
+
+  // Unset keys, looked up twice so that the cached result is used.
+  envoy::type::FractionalPercent percent;
+  percent.set_numerator(0);
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(7UL, loader.snapshot().getInteger(foo, 7));
+    EXPECT_FALSE(loader.snapshot().featureEnabled(foo, 0));
+    EXPECT_TRUE(loader.snapshot().featureEnabled(foo, 100));
+    EXPECT_TRUE(loader.snapshot().featureEnabled(foo, 50, 49));
+    EXPECT_FALSE(loader.snapshot().featureEnabled(foo, 50, 50));
+    EXPECT_TRUE(loader.snapshot().featureEnabled(foo, 5000, 4999, 10000));
+    EXPECT_FALSE(loader.snapshot().featureEnabled(foo, percent, 0));
+  }
+
+  // New values are seen through a handle that was resolved against the previous snapshot.
+  loader.mergeValues({{"key_handle_test.foo", "42"}, {"key_handle_test.bar", "numerator: 1"}});
+  EXPECT_EQ(42UL, loader.snapshot().getInteger(foo, 7));
+  EXPECT_EQ(42UL, loader.snapshot().getInteger(foo, 7));
+  EXPECT_TRUE(loader.snapshot().featureEnabled(foo, 0, 41));
+  EXPECT_FALSE(loader.snapshot().featureEnabled(foo, 0, 42));
+  EXPECT_EQ(7UL, loader.snapshot().getInteger(bar, 7));
+  EXPECT_TRUE(loader.snapshot().featureEnabled(bar, percent, 0));
+  EXPECT_FALSE(loader.snapshot().featureEnabled(bar, percent, 1));
+  EXPECT_CALL(generator, random()).WillOnce(Return(41));
+  EXPECT_TRUE(loader.snapshot().featureEnabled(foo, 0));
+
+  // A key registered after the snapshot was built.
+  const KeyHandle baz = KeyRegistry::get().registerKey("key_handle_test.baz");
+  EXPECT_EQ(7UL, loader.snapshot().getInteger(baz, 7));
+  loader.mergeValues({{"key_handle_test.baz", "3"}});
+  EXPECT_EQ(3UL, loader.snapshot().getInteger(baz, 7));
+}
+
 class DiskLayerTest : public testing::Test {
 protected:
   DiskLayerTest() : api_(Api::createApiForTest()) {}
@@ -350,6 +397,91 @@ TEST_F(DiskLayerTest, Loop) {
       EnvoyException, "Walk recursion depth exceeded 16");
 }
 
+TEST_F(DiskLayerTest, PackedFile) {
+  const std::string path = TestEnvironment::writeStringToFileForTest(
+      "runtime_packed_file", "# comment\nfoo 1\nbar.baz hello world  \n\nfoo 2\n");
+  DiskLayer layer("test", path, *api_);
+  EXPECT_EQ(2, layer.values().size());
+  EXPECT_EQ("2", layer.values().at("foo").raw_string_value_);
+  EXPECT_EQ(2UL, layer.values().at("foo").uint_value_.value());
+  EXPECT_EQ("hello world", layer.values().at("bar.baz").raw_string_value_);
+}
+
+TEST_F(DiskLayerTest, PackedFileInvalidLine) {
+  const std::string path =
+      TestEnvironment::writeStringToFileForTest("runtime_packed_file", "foo 1\nbar\n");
+  EXPECT_THROW_WITH_MESSAGE(DiskLayer("test", path, *api_), EnvoyException,
+                            fmt::format("Invalid line in runtime file {}: bar", path));
+}
+
+// Files that are unchanged since the previous load are not read again.
+TEST(DiskLayerReuseTest, Directory) {
+  NiceMock<Api::MockApi> api;
+  TestEnvironment::writeStringToFileForTest("runtime_reuse/foo", "1");
+  TestEnvironment::writeStringToFileForTest("runtime_reuse/bar/baz", "2");
+  const std::string path = TestEnvironment::temporaryPath("runtime_reuse");
+
+  EXPECT_CALL(api.file_system_, fileReadToEnd(path + "/foo")).WillOnce(Return("1"));
+  EXPECT_CALL(api.file_system_, fileReadToEnd(path + "/bar/baz")).WillOnce(Return("2"));
+  DiskLayer first("test", path, api);
+  EXPECT_EQ(1UL, first.values().at("foo").uint_value_.value());
+
+  DiskLayer second("test", path, api, &first);
+  EXPECT_EQ(1UL, second.values().at("foo").uint_value_.value());
+  EXPECT_EQ(2UL, second.values().at("bar.baz").uint_value_.value());
+
+  // Replace one file and remove the other. The new contents have a different size, so that the
+  // change is seen even if the file system reuses the inode within the same second.
+  TestEnvironment::writeStringToFileForTest("runtime_reuse/foo", "33");
+  TestEnvironment::removePath(path + "/bar");
+  EXPECT_CALL(api.file_system_, fileReadToEnd(path + "/foo")).WillOnce(Return("33"));
+  DiskLayer third("test", path, api, &second);
+  EXPECT_EQ(1, third.values().size());
+  EXPECT_EQ(33UL, third.values().at("foo").uint_value_.value());
+}
+
+TEST(DiskLayerReuseTest, PackedFile) {
+  NiceMock<Api::MockApi> api;
+  const std::string path =
+      TestEnvironment::writeStringToFileForTest("runtime_reuse_packed", "foo 1\n");
+
+  EXPECT_CALL(api.file_system_, fileReadToEnd(path)).WillOnce(Return("foo 1\n"));
+  DiskLayer first("test", path, api);
+  DiskLayer second("test", path, api, &first);
+  EXPECT_EQ(1UL, second.values().at("foo").uint_value_.value());
+
+  TestEnvironment::writeStringToFileForTest("runtime_reuse_packed", "foo 22\n");
+  EXPECT_CALL(api.file_system_, fileReadToEnd(path)).WillOnce(Return("foo 22\n"));
+  DiskLayer third("test", path, api, &second);
+  EXPECT_EQ(22UL, third.values().at("foo").uint_value_.value());
+}
+
+// A new tree made of hard links to the old one is reloaded by reading only the replaced files.
+TEST(DiskLayerReuseTest, HardLinkedTree) {
+  NiceMock<Api::MockApi> api;
+  TestEnvironment::removePath(TestEnvironment::temporaryPath("runtime_reuse_links"));
+  TestEnvironment::writeStringToFileForTest("runtime_reuse_links/v1/foo", "1");
+  TestEnvironment::writeStringToFileForTest("runtime_reuse_links/v1/bar/baz", "2");
+  const std::string v1 = TestEnvironment::temporaryPath("runtime_reuse_links/v1");
+  const std::string v2 = TestEnvironment::temporaryPath("runtime_reuse_links/v2");
+
+  EXPECT_CALL(api.file_system_, fileReadToEnd(v1 + "/foo")).WillOnce(Return("1"));
+  EXPECT_CALL(api.file_system_, fileReadToEnd(v1 + "/bar/baz")).WillOnce(Return("2"));
+  DiskLayer first("test", v1, api);
+
+  // The equivalent of cp -al v1 v2, followed by replacing foo in the new tree.
+  TestEnvironment::createPath(v2 + "/bar");
+  ASSERT_EQ(0, ::link((v1 + "/foo").c_str(), (v2 + "/foo").c_str()));
+  ASSERT_EQ(0, ::link((v1 + "/bar/baz").c_str(), (v2 + "/bar/baz").c_str()));
+  TestEnvironment::writeStringToFileForTest("runtime_reuse_links/v2/foo", "3");
+
+  EXPECT_CALL(api.file_system_, fileReadToEnd(v2 + "/foo")).WillOnce(Return("3"));
+  EXPECT_CALL(api.file_system_, fileReadToEnd(v2 + "/bar/baz")).Times(0);
+  DiskLayer second("test", v2, api, &first);
+  EXPECT_EQ(3UL, second.values().at("foo").uint_value_.value());
+  EXPECT_EQ(2UL, second.values().at("bar.baz").uint_value_.value());
+}
+
 TEST(NoRuntime, FeatureEnabled) {
   // Make sure the registry is not set up.
   ASSERT_TRUE(Runtime::LoaderSingleton::getExisting() == nullptr);
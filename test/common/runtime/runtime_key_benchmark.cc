@@ -0,0 +1,82 @@
+// Usage: bazel run //test/common/runtime:runtime_key_benchmark
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common/fmt.h"
+#include "common/runtime/runtime_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Runtime {
+namespace {
+
+const char BenchmarkKey[] = "upstream.benchmark_feature";
+
+// Builds a snapshot holding a number of keys resembling a production runtime, with the key under
+// test set to 50%.
+class SnapshotTester {
+public:
+  SnapshotTester(uint64_t num_keys)
+      : stats_{ALL_RUNTIME_STATS(POOL_COUNTER(store_), POOL_GAUGE(store_))}, admin_layer_(stats_) {
+    std::unordered_map<std::string, std::string> values;
+    for (uint64_t i = 0; i < num_keys; i++) {
+      values.emplace(fmt::format("upstream.service_{}.retry_percent", i), "50");
+    }
+    values.emplace(BenchmarkKey, "50");
+    admin_layer_.mergeValues(values);
+
+    std::vector<Snapshot::OverrideLayerConstPtr> layers;
+    layers.emplace_back(std::make_unique<const AdminLayer>(admin_layer_));
+    snapshot_ = std::make_unique<SnapshotImpl>(generator_, stats_, std::move(layers));
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  RandomGeneratorImpl generator_;
+  RuntimeStats stats_;
+  AdminLayer admin_layer_;
+  std::unique_ptr<SnapshotImpl> snapshot_;
+};
+
+// Measures featureEnabled() with a string key, as built by callers holding a std::string.
+void BM_FeatureEnabledString(benchmark::State& state) {
+  SnapshotTester tester(state.range(0));
+  const std::string key = BenchmarkKey;
+  uint64_t random = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tester.snapshot_->featureEnabled(key, 0, random++));
+  }
+}
+BENCHMARK(BM_FeatureEnabledString)->Arg(10)->Arg(1000)->Arg(100000);
+
+// Measures featureEnabled() with a registered key handle.
+void BM_FeatureEnabledHandle(benchmark::State& state) {
+  SnapshotTester tester(state.range(0));
+  const KeyHandle key = KeyRegistry::get().registerKey(BenchmarkKey);
+  uint64_t random = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tester.snapshot_->featureEnabled(key, 0, random++));
+  }
+}
+BENCHMARK(BM_FeatureEnabledHandle)->Arg(10)->Arg(1000)->Arg(100000);
+
+} // namespace
+} // namespace Runtime
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
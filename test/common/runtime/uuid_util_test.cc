@@ -33,6 +33,22 @@ TEST(UUIDUtilsTest, mod) {
 
   EXPECT_TRUE(UuidUtils::uuidModBy("ffffffff-0012-0110-00ff-0c00400600ff", result, 10000));
   EXPECT_EQ(7295, result);
+
+  EXPECT_TRUE(UuidUtils::uuidModBy("FFFFFFFF-0012-0110-00ff-0c00400600ff", result, 10000));
+  EXPECT_EQ(7295, result);
+
+  EXPECT_TRUE(UuidUtils::uuidModBy("0000000f", result, 100));
+  EXPECT_EQ(15, result);
+
+  EXPECT_FALSE(UuidUtils::uuidModBy("0000000", result, 100));
+  EXPECT_FALSE(UuidUtils::uuidModBy("0000000g-0000-0000-0000-000000000000", result, 100));
+  EXPECT_FALSE(UuidUtils::uuidModBy("-0000000-0000-0000-0000-000000000000", result, 100));
+  EXPECT_FALSE(UuidUtils::uuidModBy("0x000000-0000-0000-0000-000000000000", result, 100));
+
+  // Only the leading 8 characters of the view are read.
+  const std::string padded = "000000ffz";
+  EXPECT_TRUE(UuidUtils::uuidModBy(absl::string_view(padded.data(), 8), result, 10000));
+  EXPECT_EQ(255, result);
 }
 
 TEST(UUIDUtilsTest, checkDistribution) {
@@ -91,4 +107,18 @@ TEST(UUIDUtilsTest, setAndCheckTraceable) {
   std::string invalid_uuid = "";
   EXPECT_FALSE(UuidUtils::setTraceableUuid(invalid_uuid, UuidTraceStatus::Forced));
 }
+
+TEST(UUIDUtilsTest, setTraceableInPlace) {
+  char uuid[] = "a121e9e1-feae-4136-9e0e-6fac343d56c9";
+  const size_t length = sizeof(uuid) - 1;
+
+  EXPECT_TRUE(UuidUtils::setTraceableUuid(uuid, length, UuidTraceStatus::Sampled));
+  EXPECT_EQ("a121e9e1-feae-9136-9e0e-6fac343d56c9", absl::string_view(uuid, length));
+
+  EXPECT_TRUE(UuidUtils::setTraceableUuid(uuid, length, UuidTraceStatus::NoTrace));
+  EXPECT_EQ("a121e9e1-feae-4136-9e0e-6fac343d56c9", absl::string_view(uuid, length));
+
+  EXPECT_FALSE(UuidUtils::setTraceableUuid(uuid, length - 1, UuidTraceStatus::Forced));
+  EXPECT_EQ("a121e9e1-feae-4136-9e0e-6fac343d56c9", absl::string_view(uuid, length));
+}
 } // namespace Envoy
@@ -153,6 +153,83 @@ TEST_F(SdsApiTest, DynamicCertificateValidationContextUpdateSuccess) {
   handle->remove();
 }
 
+// Validate that TlsSessionTicketKeysSdsApi updates keys if a good secret is passed to
+// onConfigUpdate(), and rejects secrets of another type.
+TEST_F(SdsApiTest, DynamicTlsSessionTicketKeysUpdateSuccess) {
+  NiceMock<Server::MockInstance> server;
+  NiceMock<Init::MockManager> init_manager;
+  envoy::api::v2::core::ConfigSource config_source;
+  TlsSessionTicketKeysSdsApi sds_api(
+      server.localInfo(), server.dispatcher(), server.random(), server.stats(),
+      server.clusterManager(), init_manager, config_source, "ticket_keys", []() {}, *api_);
+  EXPECT_EQ(nullptr, sds_api.secret());
+
+  NiceMock<Secret::MockSecretCallbacks> secret_callback;
+  auto handle =
+      sds_api.addUpdateCallback([&secret_callback]() { secret_callback.onAddOrUpdateSecret(); });
+
+  envoy::api::v2::auth::Secret typed_secret;
+  typed_secret.set_name("ticket_keys");
+  typed_secret.mutable_session_ticket_keys()->add_keys()->set_inline_bytes(std::string(80, 'a'));
+  typed_secret.mutable_session_ticket_keys()->add_keys()->set_inline_bytes(std::string(80, 'b'));
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> secret_resources;
+  secret_resources.Add()->PackFrom(typed_secret);
+
+  EXPECT_CALL(secret_callback, onAddOrUpdateSecret());
+  sds_api.onConfigUpdate(secret_resources, "");
+  ASSERT_NE(nullptr, sds_api.secret());
+  ASSERT_EQ(2, sds_api.secret()->keys_size());
+  EXPECT_EQ(std::string(80, 'a'), sds_api.secret()->keys(0).inline_bytes());
+
+  envoy::api::v2::auth::Secret wrong_secret;
+  wrong_secret.set_name("ticket_keys");
+  wrong_secret.mutable_validation_context();
+  secret_resources.Clear();
+  secret_resources.Add()->PackFrom(wrong_secret);
+  EXPECT_CALL(secret_callback, onAddOrUpdateSecret()).Times(0);
+  EXPECT_THROW_WITH_MESSAGE(sds_api.onConfigUpdate(secret_resources, ""), EnvoyException,
+                            "SDS secret ticket_keys does not contain session ticket keys");
+  EXPECT_EQ(2, sds_api.secret()->keys_size());
+
+  handle->remove();
+}
+
+// Validate that TlsSessionTicketKeysSdsApi rejects an update containing a key of the wrong length
+// and keeps the keys from the previous update.
+TEST_F(SdsApiTest, DynamicTlsSessionTicketKeysUpdateBadKeyLength) {
+  NiceMock<Server::MockInstance> server;
+  NiceMock<Init::MockManager> init_manager;
+  envoy::api::v2::core::ConfigSource config_source;
+  TlsSessionTicketKeysSdsApi sds_api(
+      server.localInfo(), server.dispatcher(), server.random(), server.stats(),
+      server.clusterManager(), init_manager, config_source, "ticket_keys", []() {}, *api_);
+
+  NiceMock<Secret::MockSecretCallbacks> secret_callback;
+  auto handle =
+      sds_api.addUpdateCallback([&secret_callback]() { secret_callback.onAddOrUpdateSecret(); });
+
+  envoy::api::v2::auth::Secret typed_secret;
+  typed_secret.set_name("ticket_keys");
+  typed_secret.mutable_session_ticket_keys()->add_keys()->set_inline_bytes(std::string(80, 'a'));
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> secret_resources;
+  secret_resources.Add()->PackFrom(typed_secret);
+  EXPECT_CALL(secret_callback, onAddOrUpdateSecret());
+  sds_api.onConfigUpdate(secret_resources, "");
+
+  typed_secret.mutable_session_ticket_keys()->add_keys()->set_inline_bytes(std::string(79, 'b'));
+  secret_resources.Clear();
+  secret_resources.Add()->PackFrom(typed_secret);
+  EXPECT_CALL(secret_callback, onAddOrUpdateSecret()).Times(0);
+  EXPECT_THROW_WITH_MESSAGE(sds_api.onConfigUpdate(secret_resources, ""), EnvoyException,
+                            "Incorrect TLS session ticket key length in SDS secret ticket_keys. "
+                            "Length 79, expected length 80.");
+  ASSERT_NE(nullptr, sds_api.secret());
+  ASSERT_EQ(1, sds_api.secret()->keys_size());
+  EXPECT_EQ(std::string(80, 'a'), sds_api.secret()->keys(0).inline_bytes());
+
+  handle->remove();
+}
+
 class CvcValidationCallback {
 public:
   virtual ~CvcValidationCallback() {}
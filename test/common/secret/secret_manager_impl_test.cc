@@ -127,9 +127,9 @@ TEST_F(SecretManagerImplTest, DuplicateStaticCertificateValidationContextSecret)
                             "Duplicate static CertificateValidationContext secret name abc.com");
 }
 
-// Validate that secret manager throws an exception when adding static secret of a type that is not
-// supported.
-TEST_F(SecretManagerImplTest, NotImplementedException) {
+// Validate that secret manager adds static session ticket keys successfully, and throws an
+// exception when adding duplicated static session ticket keys.
+TEST_F(SecretManagerImplTest, TlsSessionTicketKeysSecretLoadSuccess) {
   envoy::api::v2::auth::Secret secret_config;
 
   const std::string yaml =
@@ -137,11 +137,27 @@ TEST_F(SecretManagerImplTest, NotImplementedException) {
 name: "abc.com"
 session_ticket_keys:
   keys:
-    - filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+    - filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ticket_key_a"
 )EOF";
 
   MessageUtil::loadFromYaml(TestEnvironment::substitute(yaml), secret_config);
 
+  std::unique_ptr<SecretManager> secret_manager(new SecretManagerImpl());
+  secret_manager->addStaticSecret(secret_config);
+
+  ASSERT_EQ(secret_manager->findStaticTlsSessionTicketKeysProvider("undefined"), nullptr);
+  ASSERT_NE(secret_manager->findStaticTlsSessionTicketKeysProvider("abc.com"), nullptr);
+  EXPECT_EQ(
+      1, secret_manager->findStaticTlsSessionTicketKeysProvider("abc.com")->secret()->keys_size());
+  EXPECT_THROW_WITH_MESSAGE(secret_manager->addStaticSecret(secret_config), EnvoyException,
+                            "Duplicate static TlsSessionTicketKeys secret name abc.com");
+}
+
+// Validate that secret manager throws an exception when adding static secret without a type.
+TEST_F(SecretManagerImplTest, NotImplementedException) {
+  envoy::api::v2::auth::Secret secret_config;
+  secret_config.set_name("abc.com");
+
   std::unique_ptr<SecretManager> secret_manager(new SecretManagerImpl());
 
   EXPECT_THROW_WITH_MESSAGE(secret_manager->addStaticSecret(secret_config), EnvoyException,
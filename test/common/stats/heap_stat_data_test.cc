@@ -1,10 +1,14 @@
 #include <string>
+#include <vector>
 
 #include "common/stats/fake_symbol_table_impl.h"
 #include "common/stats/heap_stat_data.h"
 #include "common/stats/stats_options_impl.h"
 
 #include "test/test_common/logging.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/strings/str_cat.h"
 
 #include "gtest/gtest.h"
 
@@ -48,6 +52,123 @@ TEST_F(HeapStatDataTest, HeapAlloc) {
   alloc_.free(*stat_3);
 }
 
+TEST_F(HeapStatDataTest, ShardedCounter) {
+  CounterSharedPtr counter = alloc_.makeCounter("counter", "", {});
+  EXPECT_FALSE(counter->used());
+  EXPECT_EQ(0, counter->value());
+
+  counter->inc();
+  counter->add(5);
+  EXPECT_TRUE(counter->used());
+  EXPECT_EQ(6, counter->value());
+  EXPECT_EQ(6, counter->latch());
+  EXPECT_EQ(0, counter->latch());
+
+  counter->add(4);
+  counter->reset();
+  EXPECT_EQ(0, counter->value());
+  EXPECT_EQ(4, counter->latch());
+  counter->inc();
+  EXPECT_EQ(1, counter->value());
+  EXPECT_EQ(1, counter->latch());
+}
+
+// Counters with the same name share their value.
+TEST_F(HeapStatDataTest, ShardedCounterSharedByName) {
+  CounterSharedPtr counter_1 = alloc_.makeCounter("counter", "", {});
+  CounterSharedPtr counter_2 = alloc_.makeCounter("counter", "", {});
+  counter_1->inc();
+  counter_2->add(2);
+  EXPECT_EQ(3, counter_1->value());
+  EXPECT_EQ(3, counter_2->value());
+  EXPECT_EQ(3, counter_2->latch());
+  EXPECT_EQ(0, counter_1->latch());
+}
+
+// A freed counter's slot is reused with a value of zero.
+TEST_F(HeapStatDataTest, ShardedCounterSlotReuse) {
+  CounterSharedPtr counter = alloc_.makeCounter("counter", "", {});
+  counter->add(10);
+  counter.reset();
+
+  counter = alloc_.makeCounter("other_counter", "", {});
+  EXPECT_EQ(0, counter->value());
+  EXPECT_EQ(0, counter->latch());
+}
+
+TEST_F(HeapStatDataTest, ShardedCounterMultipleThreads) {
+  CounterSharedPtr counter = alloc_.makeCounter("counter", "", {});
+  const uint32_t num_threads = 8;
+  const uint32_t increments_per_thread = 10000;
+
+  // Run the threads in two waves so that the second wave reuses the slabs of the first.
+  for (uint32_t wave = 0; wave < 2; wave++) {
+    std::vector<Thread::ThreadPtr> threads;
+    for (uint32_t i = 0; i < num_threads; i++) {
+      threads.push_back(Thread::threadFactoryForTest().createThread([&counter]() -> void {
+        for (uint32_t j = 0; j < increments_per_thread; j++) {
+          counter->inc();
+        }
+      }));
+    }
+    for (Thread::ThreadPtr& thread : threads) {
+      thread->join();
+    }
+    EXPECT_EQ((wave + 1) * num_threads * increments_per_thread, counter->value());
+  }
+  EXPECT_EQ(2 * num_threads * increments_per_thread, counter->latch());
+}
+
+// Stats share a single copy of equal tag-extracted names and tag vectors.
+TEST_F(HeapStatDataTest, InternedTags) {
+  const uint64_t names = TagExtractedNamePool::get().size();
+  const uint64_t tag_sets = TagVectorPool::get().size();
+  {
+    CounterSharedPtr a_rq = alloc_.makeCounter("cluster.a.upstream_rq_total",
+                                               "cluster.upstream_rq_total", {{"cluster", "a"}});
+    CounterSharedPtr a_cx = alloc_.makeCounter("cluster.a.upstream_cx_total",
+                                               "cluster.upstream_cx_total", {{"cluster", "a"}});
+    CounterSharedPtr b_rq = alloc_.makeCounter("cluster.b.upstream_rq_total",
+                                               "cluster.upstream_rq_total", {{"cluster", "b"}});
+    EXPECT_EQ(&a_rq->tagExtractedName(), &b_rq->tagExtractedName());
+    EXPECT_NE(&a_rq->tagExtractedName(), &a_cx->tagExtractedName());
+    EXPECT_EQ(&a_rq->tags(), &a_cx->tags());
+    EXPECT_NE(&a_rq->tags(), &b_rq->tags());
+    EXPECT_EQ("b", b_rq->tags()[0].value_);
+    EXPECT_EQ(names + 2, TagExtractedNamePool::get().size());
+    EXPECT_EQ(tag_sets + 2, TagVectorPool::get().size());
+  }
+  EXPECT_EQ(names, TagExtractedNamePool::get().size());
+  EXPECT_EQ(tag_sets, TagVectorPool::get().size());
+}
+
+// Stats sharing interned values can be created and destroyed concurrently, and every value is
+// released once the last stat using it is gone.
+TEST_F(HeapStatDataTest, InternedTagsMultipleThreads) {
+  const uint64_t names = TagExtractedNamePool::get().size();
+  const uint64_t tag_sets = TagVectorPool::get().size();
+  const uint32_t num_threads = 8;
+  const uint32_t iterations = 1000;
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([this, i]() -> void {
+      const std::string cluster = absl::StrCat("c", i % 2);
+      for (uint32_t j = 0; j < iterations; j++) {
+        CounterSharedPtr counter =
+            alloc_.makeCounter(absl::StrCat("cluster.", cluster, ".upstream_rq_", j % 10),
+                               absl::StrCat("cluster.upstream_rq_", j % 10), {{"cluster", cluster}});
+        EXPECT_EQ(cluster, counter->tags()[0].value_);
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(names, TagExtractedNamePool::get().size());
+  EXPECT_EQ(tag_sets, TagVectorPool::get().size());
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
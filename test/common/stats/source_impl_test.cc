@@ -48,6 +48,31 @@ TEST(SourceImplTest, Caching) {
   EXPECT_EQ(source.cachedHistograms(), stored_histograms);
 }
 
+TEST(SnapshotSourceImplTest, Snapshot) {
+  NiceMock<MockStore> store;
+  std::vector<CounterSharedPtr> stored_counters{std::make_shared<MockCounter>()};
+  std::vector<GaugeSharedPtr> stored_gauges{std::make_shared<MockGauge>()};
+  std::vector<ParentHistogramSharedPtr> stored_histograms{std::make_shared<MockParentHistogram>()};
+
+  ON_CALL(store, counters()).WillByDefault(ReturnPointee(&stored_counters));
+  ON_CALL(store, gauges()).WillByDefault(ReturnPointee(&stored_gauges));
+  ON_CALL(store, histograms()).WillByDefault(ReturnPointee(&stored_histograms));
+
+  SnapshotSourceImpl source(store);
+  const std::vector<CounterSharedPtr> snapshot_counters = stored_counters;
+  const std::vector<GaugeSharedPtr> snapshot_gauges = stored_gauges;
+  const std::vector<ParentHistogramSharedPtr> snapshot_histograms = stored_histograms;
+
+  // Changes to the store are never reflected, even after clearing the cache.
+  stored_counters.push_back(std::make_shared<MockCounter>());
+  stored_gauges.clear();
+  stored_histograms.push_back(std::make_shared<MockParentHistogram>());
+  source.clearCache();
+  EXPECT_EQ(source.cachedCounters(), snapshot_counters);
+  EXPECT_EQ(source.cachedGauges(), snapshot_gauges);
+  EXPECT_EQ(source.cachedHistograms(), snapshot_histograms);
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
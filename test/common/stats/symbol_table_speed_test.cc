@@ -5,8 +5,10 @@
 
 #include "common/common/logger.h"
 #include "common/common/thread.h"
+#include "common/memory/stats.h"
 #include "common/stats/symbol_table_impl.h"
 
+#include "test/common/stats/stat_test_utility.h"
 #include "test/test_common/utility.h"
 
 #include "absl/synchronization/blocking_counter.h"
@@ -54,6 +56,77 @@ static void BM_CreateRace(benchmark::State& state) {
 }
 BENCHMARK(BM_CreateRace);
 
+// Encodes a name whose symbols already exist from several threads at once,
+// which only takes the symbol table lock shared.
+static std::unique_ptr<Envoy::Stats::SymbolTableImpl> existing_table;
+static std::unique_ptr<Envoy::Stats::StatNameStorage> existing_name;
+static void BM_EncodeExisting(benchmark::State& state) {
+  const absl::string_view stat_name_string = "cluster.service_0.upstream_rq_total";
+  if (state.thread_index == 0) {
+    existing_table = std::make_unique<Envoy::Stats::SymbolTableImpl>();
+    existing_name =
+        std::make_unique<Envoy::Stats::StatNameStorage>(stat_name_string, *existing_table);
+  }
+
+  for (auto _ : state) {
+    Envoy::Stats::StatNameStorage name(stat_name_string, *existing_table);
+    name.free(*existing_table);
+  }
+
+  if (state.thread_index == 0) {
+    existing_name->free(*existing_table);
+    existing_name.reset();
+    existing_table.reset();
+  }
+}
+BENCHMARK(BM_EncodeExisting)->ThreadRange(1, 16)->UseRealTime();
+
+// Reports the bytes held per stat name for 1M stat names drawn from
+// TestUtil::forEachSampleStat(), stored as strings and as StatNameStorage
+// backed by SymbolTableImpl. This relies on malloc stats, and is skipped
+// when they are unavailable.
+static void BM_MemoryPerStat(benchmark::State& state) {
+  // forEachSampleStat() generates 70 stats per cluster.
+  const int num_clusters = 1000000 / 70;
+  for (auto _ : state) {
+    uint64_t num_stats = 0;
+    size_t start_mem = Envoy::Memory::Stats::totalCurrentlyAllocated();
+    size_t string_mem_used;
+    {
+      std::vector<std::string> names;
+      Envoy::Stats::TestUtil::forEachSampleStat(
+          num_clusters, [&names](absl::string_view stat) { names.push_back(std::string(stat)); });
+      num_stats = names.size();
+      string_mem_used = Envoy::Memory::Stats::totalCurrentlyAllocated() - start_mem;
+    }
+
+    start_mem = Envoy::Memory::Stats::totalCurrentlyAllocated();
+    size_t symbol_table_mem_used;
+    {
+      Envoy::Stats::SymbolTableImpl table;
+      std::vector<Envoy::Stats::StatNameStorage> names;
+      Envoy::Stats::TestUtil::forEachSampleStat(
+          num_clusters, [&names, &table](absl::string_view stat) {
+            names.emplace_back(Envoy::Stats::StatNameStorage(stat, table));
+          });
+      symbol_table_mem_used = Envoy::Memory::Stats::totalCurrentlyAllocated() - start_mem;
+      for (Envoy::Stats::StatNameStorage& name : names) {
+        name.free(table);
+      }
+    }
+
+    if (start_mem == 0) {
+      state.SkipWithError("malloc stats are unavailable");
+      break;
+    }
+    state.counters["num_stats"] = num_stats;
+    state.counters["string_bytes_per_stat"] = static_cast<double>(string_mem_used) / num_stats;
+    state.counters["symbol_table_bytes_per_stat"] =
+        static_cast<double>(symbol_table_mem_used) / num_stats;
+  }
+}
+BENCHMARK(BM_MemoryPerStat)->Iterations(1)->Unit(benchmark::kMillisecond);
+
 int main(int argc, char** argv) {
   Envoy::Thread::MutexBasicLockable lock;
   Envoy::Logger::Context logger_context(spdlog::level::warn,
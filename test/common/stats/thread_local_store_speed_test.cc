@@ -1,6 +1,8 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from a
 // quiescent system with disabled cstate power management.
 
+#include <vector>
+
 #include "common/common/logger.h"
 #include "common/common/thread.h"
 #include "common/event/dispatcher_impl.h"
@@ -16,6 +18,7 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -33,6 +36,11 @@ public:
     if (tls_) {
       tls_->shutdownGlobalThreading();
     }
+    if (worker_thread_) {
+      worker_dispatcher_->exit();
+      worker_thread_->join();
+      tls_->shutdownThread();
+    }
   }
 
   void accessCounters() {
@@ -46,6 +54,58 @@ public:
     store_.initializeThreading(*dispatcher_, *tls_);
   }
 
+  // Like initThreading(), but also registers the main thread and a worker thread with tls, so
+  // that histogram merges run as they do in the server.
+  void initThreadingWithWorker() {
+    dispatcher_ = api_->allocateDispatcher();
+    worker_dispatcher_ = api_->allocateDispatcher();
+    tls_ = std::make_unique<ThreadLocal::InstanceImpl>();
+    tls_->registerThread(*dispatcher_, true);
+    tls_->registerThread(*worker_dispatcher_, false);
+    worker_thread_ = api_->threadFactory().createThread([this]() -> void {
+      worker_dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+      tls_->shutdownThread();
+    });
+    store_.initializeThreading(*dispatcher_, *tls_);
+  }
+
+  void createHistograms(uint32_t num_histograms) {
+    for (uint32_t i = 0; i < num_histograms; i++) {
+      histograms_.push_back(&store_.histogram(absl::StrCat("histogram.", i)));
+    }
+  }
+
+  // Records a value into every step'th histogram, then merges all histograms as a stats flush
+  // does.
+  void recordAndMergeHistograms(uint32_t step) {
+    for (uint32_t i = 0; i < histograms_.size(); i += step) {
+      histograms_[i]->recordValue(i);
+    }
+    bool merged = false;
+    store_.mergeHistograms([&merged]() -> void { merged = true; });
+    while (!merged) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  // Increments the same counter from num_threads threads at once, and returns its value.
+  uint64_t incrementCounterFromThreads(uint32_t num_threads, uint64_t increments_per_thread) {
+    Stats::Counter& counter = store_.counter("hot_counter");
+    std::vector<Thread::ThreadPtr> threads;
+    for (uint32_t i = 0; i < num_threads; i++) {
+      threads.push_back(
+          api_->threadFactory().createThread([&counter, increments_per_thread]() -> void {
+            for (uint64_t j = 0; j < increments_per_thread; j++) {
+              counter.inc();
+            }
+          }));
+    }
+    for (Thread::ThreadPtr& thread : threads) {
+      thread->join();
+    }
+    return counter.value();
+  }
+
 private:
   Stats::FakeSymbolTableImpl symbol_table_;
   Event::SimulatedTimeSystem time_system_;
@@ -54,8 +114,11 @@ private:
   Stats::ThreadLocalStoreImpl store_;
   Api::ApiPtr api_;
   Event::DispatcherPtr dispatcher_;
+  Event::DispatcherPtr worker_dispatcher_;
   std::unique_ptr<ThreadLocal::InstanceImpl> tls_;
+  Thread::ThreadPtr worker_thread_;
   envoy::config::metrics::v2::StatsConfig stats_config_;
+  std::vector<Stats::Histogram*> histograms_;
 };
 
 } // namespace Envoy
@@ -84,6 +147,41 @@ static void BM_StatsWithTls(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTls);
 
+// Tests how counter increments scale as more threads increment the same
+// counter. Counters are sharded per thread, so the time per iteration should
+// stay roughly flat as the number of threads grows.
+static void BM_CounterIncrementThreads(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  context.initThreading();
+  const uint32_t num_threads = state.range(0);
+  const uint64_t increments_per_thread = 1000000;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        context.incrementCounterFromThreads(num_threads, increments_per_thread));
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * increments_per_thread);
+}
+BENCHMARK(BM_CounterIncrementThreads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+// Measures the main thread cost of merging histograms during a stats flush, when all of them or
+// only some of them have been recorded to since the last flush.
+static void BM_HistogramMerge(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  context.initThreadingWithWorker();
+  context.createHistograms(state.range(0));
+  const uint32_t step = state.range(1);
+
+  for (auto _ : state) {
+    context.recordAndMergeHistograms(step);
+  }
+}
+BENCHMARK(BM_HistogramMerge)
+    ->Args({1000, 1})
+    ->Args({20000, 1})
+    ->Args({20000, 100})
+    ->Unit(benchmark::kMillisecond);
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
 
@@ -92,6 +190,12 @@ BENCHMARK(BM_StatsWithTls);
 
 // Boilerplate main(), which discovers benchmarks in the same file and runs them.
 int main(int argc, char** argv) {
+  // Thread creation in BM_CounterIncrementThreads and BM_HistogramMerge requires logging to be
+  // initialized.
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
   benchmark::Initialize(&argc, argv);
 
   Envoy::Event::Libevent::Global::initialize();
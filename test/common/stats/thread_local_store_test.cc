@@ -1059,6 +1059,23 @@ TEST_F(HistogramTest, MultiHistogramMultipleMerges) {
   EXPECT_EQ(2, validateMerge());
 }
 
+// Merges that find nothing recorded skip recomputing statistics, which must leave the interval
+// statistics empty and the cumulative statistics intact across several idle intervals.
+TEST_F(HistogramTest, IdleIntervalsBetweenMerges) {
+  Histogram& h1 = store_->histogram("h1");
+
+  expectCallAndAccumulate(h1, 10);
+  expectCallAndAccumulate(h1, 20);
+  EXPECT_EQ(1, validateMerge());
+
+  EXPECT_EQ(1, validateMerge());
+  EXPECT_EQ(1, validateMerge());
+
+  expectCallAndAccumulate(h1, 30);
+  EXPECT_EQ(1, validateMerge());
+  EXPECT_EQ(1, validateMerge());
+}
+
 TEST_F(HistogramTest, BasicScopeHistogramMerge) {
   ScopePtr scope1 = store_->createScope("scope1.");
 
@@ -323,6 +323,58 @@ TEST_F(TcpConnPoolImplTest, VerifyTimingStats) {
   dispatcher_.clearDeferredDeleteList();
 }
 
+/**
+ * Test that prewarming establishes a connection that the first request uses without waiting.
+ */
+TEST_F(TcpConnPoolImplTest, Prewarm) {
+  conn_pool_.expectConnCreate();
+  conn_pool_.prewarm();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+
+  // The pool already has a connection so this is a no-op.
+  conn_pool_.prewarm();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+
+  EXPECT_CALL(*conn_pool_.test_conns_[0].connect_timer_, disableTimer());
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  ActiveTestConn c1(*this, 0, ActiveTestConn::Type::Immediate);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_prefetch_hit_.value());
+
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest());
+  c1.releaseConn();
+
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest());
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Test that the pool keeps perUpstreamPrefetchRatio() connections per outstanding request.
+ */
+TEST_F(TcpConnPoolImplTest, PrefetchRatio) {
+  EXPECT_CALL(*cluster_, perUpstreamPrefetchRatio()).WillRepeatedly(Return(1.5));
+
+  conn_pool_.expectConnCreate();
+  conn_pool_.prewarm();
+  EXPECT_CALL(*conn_pool_.test_conns_[0].connect_timer_, disableTimer());
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // Assigning the first connection prefetches another one since ceil(1.5 * 1) = 2.
+  conn_pool_.expectConnCreate();
+  ActiveTestConn c1(*this, 0, ActiveTestConn::Type::Immediate);
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
+
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest());
+  c1.releaseConn();
+
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+}
+
 /**
  * Test that buffer limits are set.
  */
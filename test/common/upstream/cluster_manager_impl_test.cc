@@ -757,6 +757,73 @@ TEST_F(ClusterManagerImplTest, HttpHealthChecker) {
   factory_.tls_.shutdownThread();
 }
 
+// Test that HTTP/2 pools of clusters with a shared connection pool are handed out by the shared
+// pool manager rather than allocated on the worker.
+TEST_F(ClusterManagerImplTest, SharedHttp2ConnPool) {
+  const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STATIC
+      lb_policy: ROUND_ROBIN
+      http2_protocol_options: {}
+      shared_http2_connection_pool: true
+      hosts:
+      - socket_address:
+          address: "127.0.0.1"
+          port_value: 11001
+  )EOF";
+  EXPECT_CALL(factory_.tls_, registerThread(_, false));
+  Http::Http2::SharedConnPoolManager shared_http2_conn_pools(*api_, factory_.tls_, 1);
+  cluster_manager_ = std::make_unique<TestClusterManagerImpl>(
+      parseBootstrapFromV2Yaml(yaml), factory_, factory_.stats_, factory_.tls_, factory_.runtime_,
+      factory_.random_, factory_.local_info_, log_manager_, factory_.dispatcher_, admin_, *api_,
+      http_context_, &shared_http2_conn_pools);
+
+  // The underlying pool is only allocated on the shared thread once a stream needs it.
+  EXPECT_CALL(factory_, allocateConnPool_(_)).Times(0);
+  Http::ConnectionPool::Instance* cp = cluster_manager_->httpConnPoolForCluster(
+      "cluster_1", ResourcePriority::Default, Http::Protocol::Http2, nullptr);
+  ASSERT_NE(nullptr, cp);
+  EXPECT_EQ(Http::Protocol::Http2, cp->protocol());
+  EXPECT_FALSE(cp->hasActiveConnections());
+  EXPECT_EQ(cp, cluster_manager_->httpConnPoolForCluster("cluster_1", ResourcePriority::Default,
+                                                         Http::Protocol::Http2, nullptr));
+
+  factory_.tls_.shutdownThread();
+  // The shared thread must not destroy the main thread's thread local data of the mock.
+  EXPECT_CALL(factory_.tls_, shutdownThread()).WillOnce(Return());
+  cluster_manager_->shutdown();
+  cluster_manager_.reset();
+}
+
+// Test that without a shared pool manager, clusters with a shared connection pool use worker local
+// pools.
+TEST_F(ClusterManagerImplTest, SharedHttp2ConnPoolDisabled) {
+  const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STATIC
+      lb_policy: ROUND_ROBIN
+      http2_protocol_options: {}
+      shared_http2_connection_pool: true
+      hosts:
+      - socket_address:
+          address: "127.0.0.1"
+          port_value: 11001
+  )EOF";
+  create(parseBootstrapFromV2Yaml(yaml));
+
+  EXPECT_CALL(factory_, allocateConnPool_(_))
+      .WillOnce(ReturnNew<NiceMock<Http::ConnectionPool::MockInstance>>());
+  EXPECT_NE(nullptr, cluster_manager_->httpConnPoolForCluster(
+                         "cluster_1", ResourcePriority::Default, Http::Protocol::Http2, nullptr));
+  factory_.tls_.shutdownThread();
+}
+
 TEST_F(ClusterManagerImplTest, UnknownCluster) {
   const std::string json =
       fmt::sprintf("{%s}", clustersJson({defaultStaticClusterJson("cluster_1")}));
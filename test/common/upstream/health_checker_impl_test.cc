@@ -35,6 +35,7 @@ using testing::InSequence;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
 using testing::NiceMock;
+using testing::Property;
 using testing::Ref;
 using testing::Return;
 using testing::ReturnRef;
@@ -189,6 +190,27 @@ public:
         });
   }
 
+  void setupSpreadInitialChecksHC() {
+    const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 3s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    http_health_check:
+      service_name: locations
+      path: /healthcheck
+    spread_initial_checks: true
+    )EOF";
+
+    health_checker_.reset(new TestHttpHealthCheckerImpl(*cluster_, parseHealthCheckFromV2Yaml(yaml),
+                                                        dispatcher_, runtime_, random_,
+                                                        HealthCheckEventLoggerPtr(event_logger_)));
+    health_checker_->addHostCheckCompleteCb(
+        [this](HostSharedPtr host, HealthTransition changed_state) -> void {
+          onHostStatus(host, changed_state);
+        });
+  }
+
   void setupNoServiceValidationHCAlwaysLogFailure() {
     const std::string yaml = R"EOF(
     timeout: 1s
@@ -814,6 +836,66 @@ TEST_F(HttpHealthCheckerImplTest, SuccessWithMultipleHostSets) {
 }
 
 // Validate that runtime settings can't force a zero lengthy retry duration (and hence livelock).
+// Test that with spread_initial_checks the first checks are evenly spaced over the interval.
+TEST_F(HttpHealthCheckerImplTest, SpreadInitialChecks) {
+  setupSpreadInitialChecksHC();
+  EXPECT_CALL(*this, onHostStatus(_, HealthTransition::Unchanged)).Times(3);
+
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80"),
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:81"),
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:82")};
+  cluster_->info_->stats().upstream_cx_total_.inc();
+  expectSessionCreate();
+  expectStreamCreate(0);
+  EXPECT_CALL(*test_sessions_[0]->timeout_timer_, enableTimer(_));
+  expectSessionCreate();
+  EXPECT_CALL(*test_sessions_[1]->interval_timer_, enableTimer(std::chrono::milliseconds(1000)));
+  expectSessionCreate();
+  EXPECT_CALL(*test_sessions_[2]->interval_timer_, enableTimer(std::chrono::milliseconds(2000)));
+  health_checker_->start();
+  EXPECT_EQ(1U, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+
+  for (size_t i = 1; i < 3; i++) {
+    expectStreamCreate(i);
+    EXPECT_CALL(*test_sessions_[i]->timeout_timer_, enableTimer(_));
+    test_sessions_[i]->interval_timer_->callback_();
+  }
+  EXPECT_EQ(3U, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_CALL(*test_sessions_[i]->interval_timer_, enableTimer(std::chrono::milliseconds(3000)));
+    EXPECT_CALL(*test_sessions_[i]->timeout_timer_, disableTimer());
+    respond(i, "200", false);
+  }
+}
+
+// Test that the time between starting a check and getting its result is recorded.
+TEST_F(HttpHealthCheckerImplTest, LatencyHistogram) {
+  Event::SimulatedTimeSystem time_system;
+  setupNoServiceValidationHC();
+  EXPECT_CALL(*this, onHostStatus(_, HealthTransition::Unchanged));
+
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80")};
+  cluster_->info_->stats().upstream_cx_total_.inc();
+  expectSessionCreate();
+  expectStreamCreate(0);
+  EXPECT_CALL(*test_sessions_[0]->timeout_timer_, enableTimer(_));
+  EXPECT_CALL(cluster_->info_->stats_store_,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "health_check.dispatch_us"),
+                                      0));
+  health_checker_->start();
+
+  time_system.sleep(std::chrono::milliseconds(25));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_));
+  EXPECT_CALL(*test_sessions_[0]->timeout_timer_, disableTimer());
+  EXPECT_CALL(cluster_->info_->stats_store_,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "health_check.latency_ms"),
+                                      25));
+  respond(0, "200", false);
+}
+
 TEST_F(HttpHealthCheckerImplTest, ZeroRetryInterval) {
   const std::string host = "fake_cluster";
   const std::string path = "/healthcheck";
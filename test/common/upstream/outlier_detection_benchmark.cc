@@ -0,0 +1,100 @@
+// Usage: bazel run //test/common/upstream:outlier_detection_benchmark
+
+#include <memory>
+
+#include "common/upstream/outlier_detection_impl.h"
+#include "common/upstream/upstream_impl.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace Outlier {
+namespace {
+
+class DetectorTester {
+public:
+  DetectorTester(uint64_t num_hosts) {
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts_.push_back(makeTestHost(
+          cluster_.info_, fmt::format("tcp://10.{}.{}.{}:80", i / 65536, (i / 256) % 256, i % 256)));
+    }
+    config_.mutable_success_rate_request_volume()->set_value(RequestsPerHost);
+    detector_ = DetectorImpl::create(cluster_, config_, dispatcher_, runtime_, time_system_,
+                                     nullptr);
+  }
+
+  // Loads one interval worth of requests. Every 100th host gets a poor success rate so that the
+  // success rate ejection path is exercised.
+  void loadInterval() {
+    for (uint64_t i = 0; i < hosts_.size(); i++) {
+      const uint64_t code = i % 100 == 0 ? 503 : 200;
+      for (uint64_t j = 0; j < RequestsPerHost; j++) {
+        hosts_[i]->outlierDetector().putHttpResponseCode(j % 2 == 0 ? code : 200);
+      }
+    }
+  }
+
+  static constexpr uint64_t RequestsPerHost = 10;
+
+  NiceMock<MockClusterMockPrioritySet> cluster_;
+  HostVector& hosts_ = cluster_.prioritySet().getMockHostSet(0)->hosts_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Event::MockTimer* interval_timer_ = new Event::MockTimer(&dispatcher_);
+  NiceMock<Runtime::MockLoader> runtime_;
+  Event::SimulatedTimeSystem time_system_;
+  envoy::api::v2::cluster::OutlierDetection config_;
+  std::shared_ptr<DetectorImpl> detector_;
+};
+
+// Measures the main thread cost of a single outlier detection interval.
+void BM_OutlierDetectionInterval(benchmark::State& state) {
+  DetectorTester tester(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    tester.loadInterval();
+    state.ResumeTiming();
+
+    tester.interval_timer_->callback_();
+  }
+}
+BENCHMARK(BM_OutlierDetectionInterval)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(20000)
+    ->Unit(benchmark::kMillisecond);
+
+// Measures the per request cost of recording a result on a host monitor.
+void BM_OutlierDetectionPutHttpResponseCode(benchmark::State& state) {
+  DetectorTester tester(1);
+  DetectorHostMonitor& monitor = tester.hosts_[0]->outlierDetector();
+  uint64_t i = 0;
+  for (auto _ : state) {
+    monitor.putHttpResponseCode(++i % 10 == 0 ? 503 : 200);
+  }
+}
+BENCHMARK(BM_OutlierDetectionPutHttpResponseCode);
+
+} // namespace
+} // namespace Outlier
+} // namespace Upstream
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
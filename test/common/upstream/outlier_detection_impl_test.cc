@@ -860,6 +860,22 @@ TEST(OutlierUtility, SRThreshold) {
   EXPECT_EQ(90.0, ejection_pair.success_rate_average_);
 }
 
+TEST(OutlierUtility, SRThresholdStreaming) {
+  Utility::SuccessRateStats stats;
+  EXPECT_EQ(0, stats.variance());
+  for (double success_rate : {100, 100, 50, 100, 100}) {
+    stats.add(success_rate);
+  }
+  EXPECT_EQ(5U, stats.count());
+  EXPECT_DOUBLE_EQ(90.0, stats.mean());
+  EXPECT_DOUBLE_EQ(400.0, stats.variance());
+
+  Utility::EjectionPair ejection_pair =
+      Utility::successRateEjectionThreshold(stats.mean(), stats.variance(), 1.9);
+  EXPECT_DOUBLE_EQ(52.0, ejection_pair.ejection_threshold_);
+  EXPECT_DOUBLE_EQ(90.0, ejection_pair.success_rate_average_);
+}
+
 TEST(DetectorHostMonitorImpl, resultToHttpCode) {
   EXPECT_EQ(Http::Code::OK, DetectorHostMonitorImpl::resultToHttpCode(Result::SUCCESS));
   EXPECT_EQ(Http::Code::GatewayTimeout, DetectorHostMonitorImpl::resultToHttpCode(Result::TIMEOUT));
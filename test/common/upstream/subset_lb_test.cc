@@ -17,6 +17,7 @@
 #include "test/mocks/filesystem/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "absl/types/optional.h"
 #include "gmock/gmock.h"
@@ -176,7 +177,7 @@ public:
 
     lb_.reset(new SubsetLoadBalancer(lb_type_, priority_set_, nullptr, stats_, stats_store_,
                                      runtime_, random_, subset_info_, ring_hash_lb_config_,
-                                     least_request_lb_config_, common_config_));
+                                     least_request_lb_config_, common_config_, time_system_));
   }
 
   void zoneAwareInit(const std::vector<HostURLMetadataMap>& host_metadata_per_locality,
@@ -223,7 +224,7 @@ public:
 
     lb_.reset(new SubsetLoadBalancer(
         lb_type_, priority_set_, &local_priority_set_, stats_, stats_store_, runtime_, random_,
-        subset_info_, ring_hash_lb_config_, least_request_lb_config_, common_config_));
+        subset_info_, ring_hash_lb_config_, least_request_lb_config_, common_config_, time_system_));
   }
 
   HostSharedPtr makeHost(const std::string& url, const HostMetadata& metadata) {
@@ -396,6 +397,7 @@ public:
   PrioritySetImpl local_priority_set_;
   HostVectorSharedPtr local_hosts_;
   HostsPerLocalitySharedPtr local_hosts_per_locality_;
+  Event::SimulatedTimeSystem time_system_;
   std::shared_ptr<SubsetLoadBalancer> lb_;
 };
 
@@ -1048,7 +1050,7 @@ TEST_F(SubsetLoadBalancerTest, IgnoresHostsWithoutMetadata) {
 
   lb_.reset(new SubsetLoadBalancer(lb_type_, priority_set_, nullptr, stats_, stats_store_, runtime_,
                                    random_, subset_info_, ring_hash_lb_config_,
-                                   least_request_lb_config_, common_config_));
+                                   least_request_lb_config_, common_config_, time_system_));
 
   TestLoadBalancerContext context_version({{"version", "1.0"}});
 
@@ -1453,7 +1455,7 @@ TEST_F(SubsetLoadBalancerTest, DisabledLocalityWeightAwareness) {
 
   lb_.reset(new SubsetLoadBalancer(lb_type_, priority_set_, nullptr, stats_, stats_store_, runtime_,
                                    random_, subset_info_, ring_hash_lb_config_,
-                                   least_request_lb_config_, common_config_));
+                                   least_request_lb_config_, common_config_, time_system_));
 
   TestLoadBalancerContext context({{"version", "1.1"}});
 
@@ -1476,7 +1478,7 @@ TEST_F(SubsetLoadBalancerTest, DoesNotCheckHostHealth) {
 
   lb_.reset(new SubsetLoadBalancer(lb_type_, priority_set_, nullptr, stats_, stats_store_, runtime_,
                                    random_, subset_info_, ring_hash_lb_config_,
-                                   least_request_lb_config_, common_config_));
+                                   least_request_lb_config_, common_config_, time_system_));
 }
 
 TEST_F(SubsetLoadBalancerTest, EnabledLocalityWeightAwareness) {
@@ -1499,7 +1501,7 @@ TEST_F(SubsetLoadBalancerTest, EnabledLocalityWeightAwareness) {
 
   lb_.reset(new SubsetLoadBalancer(lb_type_, priority_set_, nullptr, stats_, stats_store_, runtime_,
                                    random_, subset_info_, ring_hash_lb_config_,
-                                   least_request_lb_config_, common_config_));
+                                   least_request_lb_config_, common_config_, time_system_));
 
   TestLoadBalancerContext context({{"version", "1.1"}});
 
@@ -1531,7 +1533,7 @@ TEST_F(SubsetLoadBalancerTest, EnabledScaleLocalityWeights) {
 
   lb_.reset(new SubsetLoadBalancer(lb_type_, priority_set_, nullptr, stats_, stats_store_, runtime_,
                                    random_, subset_info_, ring_hash_lb_config_,
-                                   least_request_lb_config_, common_config_));
+                                   least_request_lb_config_, common_config_, time_system_));
   TestLoadBalancerContext context({{"version", "1.1"}});
 
   // Since we scale the locality weights by number of hosts removed, we expect to see the second
@@ -1573,7 +1575,7 @@ TEST_F(SubsetLoadBalancerTest, EnabledScaleLocalityWeightsRounding) {
 
   lb_.reset(new SubsetLoadBalancer(lb_type_, priority_set_, nullptr, stats_, stats_store_, runtime_,
                                    random_, subset_info_, ring_hash_lb_config_,
-                                   least_request_lb_config_, common_config_));
+                                   least_request_lb_config_, common_config_, time_system_));
   TestLoadBalancerContext context({{"version", "1.0"}});
 
   // We expect to see a 33/66 split because 2 * 1 / 2 = 1 and 2 * 3 / 4 = 1.5 -> 2
@@ -1603,7 +1605,7 @@ TEST_F(SubsetLoadBalancerTest, ScaleLocalityWeightsWithNoLocalityWeights) {
 
   lb_.reset(new SubsetLoadBalancer(lb_type_, priority_set_, nullptr, stats_, stats_store_, runtime_,
                                    random_, subset_info_, ring_hash_lb_config_,
-                                   least_request_lb_config_, common_config_));
+                                   least_request_lb_config_, common_config_, time_system_));
 }
 
 TEST_P(SubsetLoadBalancerTest, GaugesUpdatedOnDestroy) {
@@ -1626,6 +1628,121 @@ TEST_P(SubsetLoadBalancerTest, GaugesUpdatedOnDestroy) {
   EXPECT_EQ(1U, stats_.lb_subsets_removed_.value());
 }
 
+TEST_P(SubsetLoadBalancerTest, LazySubsetCreation) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+  EXPECT_CALL(subset_info_, lazySubsetCreation()).WillRepeatedly(Return(true));
+
+  std::vector<std::set<std::string>> subset_keys = {{"version"}, {"stage"}};
+  EXPECT_CALL(subset_info_, subsetKeys()).WillRepeatedly(ReturnRef(subset_keys));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}, {"stage", "prod"}}},
+      {"tcp://127.0.0.1:81", {{"version", "1.0"}}},
+      {"tcp://127.0.0.1:82", {{"version", "1.1"}, {"stage", "prod"}}},
+  });
+
+  // No subsets are built until they are selected.
+  EXPECT_EQ(0U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(0U, stats_.lb_subsets_created_.value());
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_prod({{"stage", "prod"}});
+  TestLoadBalancerContext context_unknown({{"version", "2.0"}});
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_10));
+  EXPECT_EQ(1U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(1U, stats_.lb_subsets_created_.value());
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_prod));
+  EXPECT_EQ(host_set_.hosts_[2], lb_->chooseHost(&context_prod));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(2U, stats_.lb_subsets_created_.value());
+
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_unknown));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(4U, stats_.lb_subsets_selected_.value());
+
+  // Materialized subsets pick up host updates.
+  modifyHosts({makeHost("tcp://127.0.0.1:8000", {{"version", "1.0"}})}, {host_set_.hosts_[1]});
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_EQ(host_set_.hosts_[2], lb_->chooseHost(&context_10));
+  EXPECT_EQ(0U, stats_.lb_subsets_evicted_.value());
+}
+
+TEST_F(SubsetLoadBalancerTest, LazySubsetIdleEviction) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+  EXPECT_CALL(subset_info_, lazySubsetCreation()).WillRepeatedly(Return(true));
+  EXPECT_CALL(subset_info_, lazySubsetIdleTimeout())
+      .WillRepeatedly(Return(std::chrono::milliseconds(1000)));
+
+  std::vector<std::set<std::string>> subset_keys = {{"version"}};
+  EXPECT_CALL(subset_info_, subsetKeys()).WillRepeatedly(ReturnRef(subset_keys));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+      {"tcp://127.0.0.1:81", {{"version", "1.1"}}},
+  });
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_11));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+
+  // Only the 1.0 subset is selected within the idle timeout, so the 1.1 subset is evicted on the
+  // next update rather than rebuilt.
+  time_system_.sleep(std::chrono::milliseconds(800));
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  time_system_.sleep(std::chrono::milliseconds(800));
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(1U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(1U, stats_.lb_subsets_evicted_.value());
+
+  // Selecting an evicted subset rebuilds it.
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_11));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
+}
+
+TEST_F(SubsetLoadBalancerTest, LazySubsetLimit) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+  EXPECT_CALL(subset_info_, lazySubsetCreation()).WillRepeatedly(Return(true));
+  EXPECT_CALL(subset_info_, maxLazySubsets()).WillRepeatedly(Return(2));
+
+  std::vector<std::set<std::string>> subset_keys = {{"version"}};
+  EXPECT_CALL(subset_info_, subsetKeys()).WillRepeatedly(ReturnRef(subset_keys));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+      {"tcp://127.0.0.1:81", {{"version", "1.1"}}},
+      {"tcp://127.0.0.1:82", {{"version", "1.2"}}},
+  });
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  TestLoadBalancerContext context_12({{"version", "1.2"}});
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_11));
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+
+  // The least recently selected subset (1.1) is evicted to make room for 1.2.
+  EXPECT_EQ(host_set_.hosts_[2], lb_->chooseHost(&context_12));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(1U, stats_.lb_subsets_evicted_.value());
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_EQ(1U, stats_.lb_subsets_evicted_.value());
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_11));
+  EXPECT_EQ(2U, stats_.lb_subsets_evicted_.value());
+  EXPECT_EQ(4U, stats_.lb_subsets_created_.value());
+}
+
 INSTANTIATE_TEST_SUITE_P(UpdateOrderings, SubsetLoadBalancerTest,
                          testing::ValuesIn({REMOVES_FIRST, SIMULTANEOUS}));
 
@@ -108,6 +108,25 @@ TEST(FileAccessLogConfigTest, FileAccessLogJsonTest) {
                             "Didn't find a registered implementation for name: 'INVALID'");
 }
 
+TEST(FileAccessLogConfigTest, FileAccessLogBinaryTest) {
+  envoy::config::filter::accesslog::v2::AccessLog config;
+  config.set_name(AccessLogNames::get().File);
+
+  envoy::config::accesslog::v2::FileAccessLog fal_config;
+  fal_config.set_path("/dev/null");
+  fal_config.mutable_binary_format()->add_additional_request_headers_to_log("x-custom");
+
+  EXPECT_EQ(fal_config.access_log_format_case(),
+            envoy::config::accesslog::v2::FileAccessLog::kBinaryFormat);
+  MessageUtil::jsonConvert(fal_config, *config.mutable_config());
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  AccessLog::InstanceSharedPtr log = AccessLog::AccessLogFactory::fromProto(config, context);
+
+  EXPECT_NE(nullptr, log);
+  EXPECT_NE(nullptr, dynamic_cast<FileAccessLog*>(log.get()));
+}
+
 TEST(FileAccessLogConfigTest, FileAccessLogJsonWithBoolValueTest) {
   {
     // Make sure we fail if you set a bool value in the format dictionary
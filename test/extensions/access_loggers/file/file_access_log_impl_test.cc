@@ -0,0 +1,63 @@
+#include "envoy/service/accesslog/v2/als.pb.h"
+
+#include "common/protobuf/protobuf.h"
+
+#include "extensions/access_loggers/file/file_access_log_impl.h"
+
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+namespace {
+
+// Test that consecutive binary log entries can be read back with a delimited protobuf parser.
+TEST(BinaryFormatterTest, LengthDelimited) {
+  envoy::config::accesslog::v2::FileAccessLog::BinaryFormat config;
+  config.add_additional_request_headers_to_log("x-custom");
+  BinaryFormatter formatter(config);
+
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  stream_info.host_ = nullptr;
+  stream_info.start_time_ = SystemTime(1h);
+  Http::TestHeaderMapImpl request_headers{{":path", "/first"}, {"x-custom", "value"}};
+  Http::TestHeaderMapImpl second_request_headers{{":path", "/second"}};
+  Http::TestHeaderMapImpl response_headers;
+  Http::TestHeaderMapImpl response_trailers;
+
+  const std::string output =
+      formatter.format(request_headers, response_headers, response_trailers, stream_info) +
+      formatter.format(second_request_headers, response_headers, response_trailers, stream_info);
+
+  Protobuf::io::ArrayInputStream stream(output.data(), output.size());
+  Protobuf::io::CodedInputStream coded_stream(&stream);
+  std::vector<envoy::data::accesslog::v2::HTTPAccessLogEntry> entries;
+  uint32_t length;
+  while (coded_stream.ReadVarint32(&length)) {
+    const auto limit = coded_stream.PushLimit(length);
+    entries.emplace_back();
+    EXPECT_TRUE(entries.back().ParseFromCodedStream(&coded_stream));
+    coded_stream.PopLimit(limit);
+  }
+
+  ASSERT_EQ(2, entries.size());
+  EXPECT_EQ("/first", entries[0].request().path());
+  EXPECT_EQ("value", entries[0].request().request_headers().at("x-custom"));
+  EXPECT_EQ(3600, entries[0].common_properties().start_time().seconds());
+  EXPECT_EQ("/second", entries[1].request().path());
+  EXPECT_TRUE(entries[1].request().request_headers().empty());
+}
+
+} // namespace
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
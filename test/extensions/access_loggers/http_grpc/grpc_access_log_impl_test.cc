@@ -119,8 +119,8 @@ public:
   void init() {
     ON_CALL(*filter_, evaluate(_, _, _, _)).WillByDefault(Return(true));
     config_.mutable_common_config()->set_log_name("hello_log");
-    access_log_ =
-        std::make_unique<HttpGrpcAccessLog>(AccessLog::FilterPtr{filter_}, config_, streamer_);
+    access_log_ = std::make_unique<HttpGrpcAccessLog>(AccessLog::FilterPtr{filter_}, config_, tls_,
+                                                      streamer_);
   }
 
   void expectLog(const std::string& expected_request_msg_yaml) {
@@ -139,6 +139,7 @@ public:
   }
 
   AccessLog::MockFilter* filter_{new NiceMock<AccessLog::MockFilter>()};
+  NiceMock<ThreadLocal::MockInstance> tls_;
   envoy::config::accesslog::v2::HttpGrpcAccessLogConfig config_;
   std::shared_ptr<MockGrpcAccessLogStreamer> streamer_{new MockGrpcAccessLogStreamer()};
   std::unique_ptr<HttpGrpcAccessLog> access_log_;
@@ -476,11 +477,79 @@ http_logs:
   }
 }
 
+// Test that log entries are batched until the buffer size is reached or the flush timer fires.
+TEST_F(HttpGrpcAccessLogTest, Batching) {
+  InSequence s;
+
+  config_.mutable_common_config()->mutable_buffer_size_bytes()->set_value(2000);
+  Event::MockTimer* timer = new Event::MockTimer(&tls_.dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(1000)));
+  init();
+
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  stream_info.host_ = nullptr;
+  stream_info.start_time_ = SystemTime(1h);
+  Http::TestHeaderMapImpl request_headers{{":path", std::string(900, 'a')}};
+
+  // The first two entries fit in the buffer, and the third fills it.
+  EXPECT_CALL(*streamer_, send(_, "hello_log"))
+      .WillOnce(Invoke([](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                          const std::string&) {
+        EXPECT_EQ(3, message.http_logs().log_entry().size());
+      }));
+  access_log_->log(&request_headers, nullptr, nullptr, stream_info);
+  access_log_->log(&request_headers, nullptr, nullptr, stream_info);
+  access_log_->log(&request_headers, nullptr, nullptr, stream_info);
+
+  // The timer flushes what is left over and is re-enabled.
+  access_log_->log(&request_headers, nullptr, nullptr, stream_info);
+  EXPECT_CALL(*streamer_, send(_, "hello_log"))
+      .WillOnce(Invoke([](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                          const std::string&) {
+        EXPECT_EQ(1, message.http_logs().log_entry().size());
+      }));
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(1000)));
+  timer->callback_();
+
+  // Nothing is sent when there is nothing to flush.
+  EXPECT_CALL(*streamer_, send(_, _)).Times(0);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(1000)));
+  timer->callback_();
+}
+
+// Test that buffered entries are sent when the access log, and so its thread local logger, is
+// destroyed.
+TEST_F(HttpGrpcAccessLogTest, FlushOnDestruction) {
+  InSequence s;
+
+  config_.mutable_common_config()->mutable_buffer_size_bytes()->set_value(2000);
+  Event::MockTimer* timer = new Event::MockTimer(&tls_.dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(1000)));
+  init();
+
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  stream_info.host_ = nullptr;
+  stream_info.start_time_ = SystemTime(1h);
+  Http::TestHeaderMapImpl request_headers{{":path", "/"}};
+
+  EXPECT_CALL(*streamer_, send(_, _)).Times(0);
+  access_log_->log(&request_headers, nullptr, nullptr, stream_info);
+  access_log_->log(&request_headers, nullptr, nullptr, stream_info);
+
+  EXPECT_CALL(*streamer_, send(_, "hello_log"))
+      .WillOnce(Invoke([](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
+                          const std::string&) {
+        EXPECT_EQ(2, message.http_logs().log_entry().size());
+      }));
+  access_log_.reset();
+}
+
 TEST(responseFlagsToAccessLogResponseFlagsTest, All) {
   NiceMock<StreamInfo::MockStreamInfo> stream_info;
   ON_CALL(stream_info, hasResponseFlag(_)).WillByDefault(Return(true));
   envoy::data::accesslog::v2::AccessLogCommon common_access_log;
-  HttpGrpcAccessLog::responseFlagsToAccessLogResponseFlags(common_access_log, stream_info);
+  Common::HttpLogEntryBuilder::responseFlagsToAccessLogResponseFlags(common_access_log,
+                                                                    stream_info);
 
   envoy::data::accesslog::v2::AccessLogCommon common_access_log_expected;
   common_access_log_expected.mutable_response_flags()->set_failed_local_healthcheck(true);
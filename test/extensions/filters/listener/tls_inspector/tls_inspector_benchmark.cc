@@ -72,9 +72,8 @@ public:
   const std::vector<uint8_t> client_hello_;
 };
 
-static void BM_TlsInspector(benchmark::State& state) {
-  NiceMock<FastMockOsSysCalls> os_sys_calls(
-      Tls::Test::generateClientHello("example.com", "\x02h2\x08http/1.1"));
+static void runTlsInspector(benchmark::State& state, const std::vector<uint8_t>& client_hello) {
+  NiceMock<FastMockOsSysCalls> os_sys_calls(client_hello);
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&os_sys_calls};
   NiceMock<Stats::MockStore> store;
   ConfigSharedPtr cfg(std::make_shared<Config>(store));
@@ -98,8 +97,22 @@ static void BM_TlsInspector(benchmark::State& state) {
   }
 }
 
+// Measures a ClientHello in a single record, which the filter parses directly.
+static void BM_TlsInspector(benchmark::State& state) {
+  runTlsInspector(state, Tls::Test::generateClientHello("example.com", "\x02h2\x08http/1.1"));
+}
+
 BENCHMARK(BM_TlsInspector)->Unit(benchmark::kMicrosecond);
 
+// Measures a ClientHello split across records, which falls back to parsing with BoringSSL.
+static void BM_TlsInspectorFragmentedClientHello(benchmark::State& state) {
+  runTlsInspector(state, Tls::Test::fragmentClientHello(
+                             Tls::Test::generateClientHello("example.com", "\x02h2\x08http/1.1"),
+                             64));
+}
+
+BENCHMARK(BM_TlsInspectorFragmentedClientHello)->Unit(benchmark::kMicrosecond);
+
 } // namespace TlsInspector
 } // namespace ListenerFilters
 } // namespace Extensions
@@ -171,6 +171,32 @@ TEST_F(TlsInspectorTest, MultipleReads) {
   EXPECT_EQ(1, cfg_->stats().alpn_found_.value());
 }
 
+// Test that a ClientHello split across multiple TLS records, which is parsed by BoringSSL rather
+// than directly by the filter, is still detected.
+TEST_F(TlsInspectorTest, FragmentedClientHello) {
+  init();
+  const std::vector<absl::string_view> alpn_protos = {absl::string_view("h2"),
+                                                      absl::string_view("http/1.1")};
+  const std::string servername("example.com");
+  std::vector<uint8_t> client_hello = Tls::Test::fragmentClientHello(
+      Tls::Test::generateClientHello(servername, "\x02h2\x08http/1.1"), 64);
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(
+          Invoke([&client_hello](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+            ASSERT(length >= client_hello.size());
+            memcpy(buffer, client_hello.data(), client_hello.size());
+            return Api::SysCallSizeResult{ssize_t(client_hello.size()), 0};
+          }));
+  EXPECT_CALL(socket_, setRequestedServerName(Eq(servername)));
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(alpn_protos));
+  EXPECT_CALL(socket_, setDetectedTransportProtocol(absl::string_view("tls")));
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_found_.value());
+  EXPECT_EQ(1, cfg_->stats().sni_found_.value());
+  EXPECT_EQ(1, cfg_->stats().alpn_found_.value());
+}
+
 // Test that the filter correctly handles a ClientHello with no extensions present.
 TEST_F(TlsInspectorTest, NoExtensions) {
   init();
@@ -231,6 +257,105 @@ TEST_F(TlsInspectorTest, NotSsl) {
   EXPECT_EQ(1, cfg_->stats().tls_not_found_.value());
 }
 
+// Test that a ClientHello with a repeated extension falls back to BoringSSL, which rejects it.
+TEST_F(TlsInspectorTest, DuplicateExtension) {
+  std::vector<uint8_t> client_hello = Tls::Test::generateClientHello("example.com", "\x02h2");
+  // Turn the ALPN extension into a second server_name extension.
+  const size_t offset = Tls::Test::findExtension(
+      client_hello, TLSEXT_TYPE_application_layer_protocol_negotiation);
+  client_hello[offset] = 0;
+  client_hello[offset + 1] = TLSEXT_TYPE_server_name;
+  init();
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(
+          Invoke([&client_hello](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+            ASSERT(length >= client_hello.size());
+            memcpy(buffer, client_hello.data(), client_hello.size());
+            return Api::SysCallSizeResult{ssize_t(client_hello.size()), 0};
+          }));
+  EXPECT_CALL(socket_, setRequestedServerName(_)).Times(0);
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_not_found_.value());
+}
+
+// Test that a ClientHello without null compression falls back to BoringSSL, which rejects it.
+TEST_F(TlsInspectorTest, NonNullCompression) {
+  std::vector<uint8_t> client_hello = Tls::Test::generateClientHello("example.com", "");
+  const size_t offset = Tls::Test::findCompressionMethods(client_hello);
+  ASSERT(client_hello[offset] == 1 && client_hello[offset + 1] == 0);
+  client_hello[offset + 1] = 1;
+  init();
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(
+          Invoke([&client_hello](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+            ASSERT(length >= client_hello.size());
+            memcpy(buffer, client_hello.data(), client_hello.size());
+            return Api::SysCallSizeResult{ssize_t(client_hello.size()), 0};
+          }));
+  EXPECT_CALL(socket_, setRequestedServerName(_)).Times(0);
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_not_found_.value());
+}
+
+// Test that a malformed ALPN list falls back to BoringSSL, and that no protocols are reported.
+TEST_F(TlsInspectorTest, MalformedAlpn) {
+  std::vector<uint8_t> client_hello = Tls::Test::generateClientHello("example.com", "\x02h2");
+  const size_t offset = Tls::Test::findExtension(
+      client_hello, TLSEXT_TYPE_application_layer_protocol_negotiation);
+  // Skip the extension type and length, and the protocol list length, to reach the length of the
+  // first protocol name, which must not be empty.
+  client_hello[offset + 6] = 0;
+  init();
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(
+          Invoke([&client_hello](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+            ASSERT(length >= client_hello.size());
+            memcpy(buffer, client_hello.data(), client_hello.size());
+            return Api::SysCallSizeResult{ssize_t(client_hello.size()), 0};
+          }));
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(_)).Times(0);
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(0, cfg_->stats().alpn_found_.value());
+}
+
+// Test that what could be an SSLv2 compatible ClientHello is handed to BoringSSL, which waits for
+// the rest of it rather than reporting the connection as not TLS.
+TEST_F(TlsInspectorTest, Sslv2FirstByte) {
+  init();
+  const std::vector<uint8_t> data = {0x80, 0x2e, 0x01, 0x03};
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(Invoke([&data](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+        ASSERT(length >= data.size());
+        memcpy(buffer, data.data(), data.size());
+        return Api::SysCallSizeResult{ssize_t(data.size()), 0};
+      }));
+  // Only the close below may end the inspection.
+  EXPECT_CALL(cb_, continueFilterChain(false));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(0, cfg_->stats().tls_not_found_.value());
+  file_event_callback_(Event::FileReadyType::Closed);
+  EXPECT_EQ(1, cfg_->stats().connection_closed_.value());
+}
+
+// Test that data whose first byte cannot start a TLS record is reported as not TLS right away,
+// without waiting for more data.
+TEST_F(TlsInspectorTest, NotTlsFirstByte) {
+  init();
+  const std::string data = "G";
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(Invoke([&data](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+        ASSERT(length >= data.size());
+        memcpy(buffer, data.data(), data.size());
+        return Api::SysCallSizeResult{ssize_t(data.size()), 0};
+      }));
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_not_found_.value());
+}
+
 } // namespace
 } // namespace TlsInspector
 } // namespace ListenerFilters
@@ -1,7 +1,10 @@
 #include "test/extensions/filters/listener/tls_inspector/tls_utility.h"
 
+#include <algorithm>
+
 #include "common/common/assert.h"
 
+#include "openssl/bytestring.h"
 #include "openssl/ssl.h"
 
 namespace Envoy {
@@ -39,6 +42,67 @@ std::vector<uint8_t> generateClientHello(const std::string& sni_name, const std:
   return buf;
 }
 
+std::vector<uint8_t> fragmentClientHello(const std::vector<uint8_t>& client_hello,
+                                         size_t fragment_size) {
+  ASSERT(client_hello.size() > SSL3_RT_HEADER_LENGTH && client_hello[0] == SSL3_RT_HANDSHAKE);
+  ASSERT(fragment_size > 0);
+  std::vector<uint8_t> buf;
+  for (size_t offset = SSL3_RT_HEADER_LENGTH; offset < client_hello.size();
+       offset += fragment_size) {
+    const size_t len = std::min(fragment_size, client_hello.size() - offset);
+    // Keep the content type and record version of the original record.
+    buf.insert(buf.end(), client_hello.begin(), client_hello.begin() + 3);
+    buf.push_back(static_cast<uint8_t>(len >> 8));
+    buf.push_back(static_cast<uint8_t>(len));
+    buf.insert(buf.end(), client_hello.begin() + offset, client_hello.begin() + offset + len);
+  }
+  return buf;
+}
+
+namespace {
+
+// Skips to the extensions block, filling in the compression methods on the way.
+CBS skipToExtensions(const std::vector<uint8_t>& client_hello, CBS* compression_methods) {
+  CBS cbs, session_id, cipher_suites, extensions;
+  CBS_init(&cbs, client_hello.data(), client_hello.size());
+  const bool ok =
+      CBS_skip(&cbs, SSL3_RT_HEADER_LENGTH + SSL3_HM_HEADER_LENGTH + 2 + SSL3_RANDOM_SIZE) &&
+      CBS_get_u8_length_prefixed(&cbs, &session_id) &&
+      CBS_get_u16_length_prefixed(&cbs, &cipher_suites);
+  RELEASE_ASSERT(ok, "");
+  *compression_methods = cbs;
+  CBS ignored;
+  RELEASE_ASSERT(CBS_get_u8_length_prefixed(&cbs, &ignored) &&
+                     CBS_get_u16_length_prefixed(&cbs, &extensions),
+                 "");
+  return extensions;
+}
+
+} // namespace
+
+size_t findCompressionMethods(const std::vector<uint8_t>& client_hello) {
+  CBS compression_methods;
+  skipToExtensions(client_hello, &compression_methods);
+  return CBS_data(&compression_methods) - client_hello.data();
+}
+
+size_t findExtension(const std::vector<uint8_t>& client_hello, uint16_t type) {
+  CBS compression_methods;
+  CBS extensions = skipToExtensions(client_hello, &compression_methods);
+  while (CBS_len(&extensions) != 0) {
+    const size_t offset = CBS_data(&extensions) - client_hello.data();
+    uint16_t extension_type;
+    CBS extension;
+    RELEASE_ASSERT(CBS_get_u16(&extensions, &extension_type) &&
+                       CBS_get_u16_length_prefixed(&extensions, &extension),
+                   "");
+    if (extension_type == type) {
+      return offset;
+    }
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
 } // namespace Test
 } // namespace Tls
 } // namespace Envoy
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -16,6 +17,29 @@ namespace Test {
  */
 std::vector<uint8_t> generateClientHello(const std::string& sni_name, const std::string& alpn);
 
+/**
+ * Split a TLS ClientHello in wire-format across multiple records.
+ * @param client_hello A ClientHello in a single record, such as from generateClientHello().
+ * @param fragment_size The maximum number of handshake bytes to put in each record.
+ */
+std::vector<uint8_t> fragmentClientHello(const std::vector<uint8_t>& client_hello,
+                                         size_t fragment_size);
+
+/**
+ * Find a field of a TLS ClientHello in wire-format, so that tests can corrupt it.
+ * @param client_hello A ClientHello in a single record, such as from generateClientHello().
+ * @return size_t the offset of the compression methods list, including its length byte.
+ */
+size_t findCompressionMethods(const std::vector<uint8_t>& client_hello);
+
+/**
+ * Find an extension of a TLS ClientHello in wire-format, so that tests can corrupt it.
+ * @param client_hello A ClientHello in a single record, such as from generateClientHello().
+ * @param type The extension type, which must be present in the ClientHello.
+ * @return size_t the offset of the extension, starting with its type.
+ */
+size_t findExtension(const std::vector<uint8_t>& client_hello, uint16_t type);
+
 } // namespace Test
 } // namespace Tls
 } // namespace Envoy
@@ -138,6 +138,37 @@ TEST_F(TcpStatsdSinkTest, WithCustomPrefix) {
   sink_->flush(source_);
 }
 
+TEST_F(TcpStatsdSinkTest, ChangedStatsOnly) {
+  sink_ = std::make_unique<TcpStatsdSink>(
+      local_info_, "fake_cluster", tls_, cluster_manager_,
+      cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_, "envoy", true);
+
+  auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  counter->name_ = "test_counter";
+  counter->latch_ = 1;
+  counter->used_ = true;
+  source_.counters_.push_back(counter);
+
+  auto gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  gauge->name_ = "test_gauge";
+  gauge->value_ = 2;
+  gauge->used_ = true;
+  source_.gauges_.push_back(gauge);
+
+  expectCreateConnection();
+  EXPECT_CALL(*connection_,
+              write(BufferStringEqual("envoy.test_counter:1|c\nenvoy.test_gauge:2|g\n"), _));
+  sink_->flush(source_);
+
+  counter->latch_ = 0;
+  EXPECT_CALL(*connection_, write(BufferStringEqual(""), _));
+  sink_->flush(source_);
+
+  gauge->value_ = 3;
+  EXPECT_CALL(*connection_, write(BufferStringEqual("envoy.test_gauge:3|g\n"), _));
+  sink_->flush(source_);
+}
+
 TEST_F(TcpStatsdSinkTest, BufferReallocate) {
   InSequence s;
 
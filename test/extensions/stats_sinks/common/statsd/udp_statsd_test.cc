@@ -15,6 +15,8 @@
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
 
+using testing::_;
+using testing::InSequence;
 using testing::NiceMock;
 
 namespace Envoy {
@@ -218,6 +220,69 @@ TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, PackedDatagrams) {
+  NiceMock<Stats::MockSource> source;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  // Fits two 24 byte lines and a separator, but not three.
+  UdpStatsdSink sink(tls_, writer_ptr, false, "envoy", 60);
+
+  for (const std::string name : {"test_counter_a", "test_counter_b", "test_counter_c"}) {
+    auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+    counter->name_ = name;
+    counter->used_ = true;
+    counter->latch_ = 1;
+    source.counters_.push_back(counter);
+  }
+
+  InSequence s;
+  EXPECT_CALL(*writer_ptr, write("envoy.test_counter_a:1|c\nenvoy.test_counter_b:1|c"));
+  EXPECT_CALL(*writer_ptr, write("envoy.test_counter_c:1|c"));
+  sink.flush(source);
+
+  tls_.shutdownThread();
+}
+
+TEST(UdpStatsdSinkWithTagsTest, ChangedStatsOnly) {
+  NiceMock<Stats::MockSource> source;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, true, "envoy", 0, true);
+
+  std::vector<Stats::Tag> tags = {Stats::Tag{"key1", "value1"}};
+  auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  counter->name_ = "test_counter";
+  counter->used_ = true;
+  counter->latch_ = 1;
+  counter->tags_ = tags;
+  source.counters_.push_back(counter);
+
+  auto gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  gauge->name_ = "test_gauge";
+  gauge->value_ = 1;
+  gauge->used_ = true;
+  gauge->tags_ = tags;
+  source.gauges_.push_back(gauge);
+
+  EXPECT_CALL(*writer_ptr, write("envoy.test_counter:1|c|#key1:value1"));
+  EXPECT_CALL(*writer_ptr, write("envoy.test_gauge:1|g|#key1:value1"));
+  sink.flush(source);
+
+  // Nothing changed, so nothing is sent.
+  counter->latch_ = 0;
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  sink.flush(source);
+  testing::Mock::VerifyAndClearExpectations(writer_ptr.get());
+
+  counter->latch_ = 2;
+  gauge->value_ = 3;
+  EXPECT_CALL(*writer_ptr, write("envoy.test_counter:2|c|#key1:value1"));
+  EXPECT_CALL(*writer_ptr, write("envoy.test_gauge:3|g|#key1:value1"));
+  sink.flush(source);
+
+  tls_.shutdownThread();
+}
+
 } // namespace
 } // namespace Statsd
 } // namespace Common
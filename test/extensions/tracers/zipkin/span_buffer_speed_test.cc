@@ -0,0 +1,86 @@
+// Usage: bazel run //test/extensions/tracers/zipkin:span_buffer_speed_test
+
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/utility.h"
+
+#include "extensions/tracers/zipkin/span_buffer.h"
+#include "extensions/tracers/zipkin/zipkin_core_constants.h"
+
+#include "test/test_common/test_time.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Zipkin {
+namespace {
+
+// Builds a client span resembling one reported by the tracer: cs/cr annotations carrying the
+// local endpoint, and a handful of tags.
+Span makeSpan(TimeSource& time_source, uint64_t id) {
+  Endpoint endpoint("service", Network::Utility::parseInternetAddress("10.0.0.1", 8080));
+  Span span(time_source);
+  span.setTraceId(id);
+  span.setId(id + 1);
+  span.setParentId(id);
+  span.setName("egress cluster_0");
+  span.setTimestamp(1556000000000000);
+  span.setDuration(1234);
+
+  Annotation cs(1556000000000000, ZipkinCoreConstants::get().CLIENT_SEND, endpoint);
+  Annotation cr(1556000000001234, ZipkinCoreConstants::get().CLIENT_RECV, endpoint);
+  span.addAnnotation(std::move(cs));
+  span.addAnnotation(std::move(cr));
+
+  span.setTag("component", "proxy");
+  span.setTag("http.url", "http://service/some/path?query=value");
+  span.setTag("http.method", "GET");
+  span.setTag("http.status_code", "200");
+  span.setTag("response_size", "1024");
+  return span;
+}
+
+// Measures the cost of encoding a batch of spans into the request body sent to the collector.
+void BM_EncodeSpans(benchmark::State& state) {
+  DangerousDeprecatedTestTime test_time;
+  const uint64_t batch_size = state.range(0);
+  std::vector<Span> spans;
+  for (uint64_t i = 0; i < batch_size; i++) {
+    spans.push_back(makeSpan(test_time.timeSystem(), i));
+  }
+
+  SpanBuffer span_buffer(batch_size);
+  for (auto _ : state) {
+    for (const Span& span : spans) {
+      span_buffer.addSpan(span);
+    }
+    Buffer::OwnedImpl body;
+    span_buffer.drainJsonArray(body);
+    benchmark::DoNotOptimize(body.length());
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_EncodeSpans)->Arg(1)->Arg(100)->Arg(1000);
+
+} // namespace
+} // namespace Zipkin
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
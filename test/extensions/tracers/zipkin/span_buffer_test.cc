@@ -1,3 +1,5 @@
+#include "common/buffer/buffer_impl.h"
+
 #include "extensions/tracers/zipkin/span_buffer.h"
 
 #include "test/test_common/test_time.h"
@@ -110,6 +112,41 @@ TEST(ZipkinSpanBufferTest, sizeConstructorEndtoEnd) {
   EXPECT_EQ("[]", buffer.toStringifiedJsonArray());
 }
 
+TEST(ZipkinSpanBufferTest, drainJsonArray) {
+  DangerousDeprecatedTestTime test_time;
+  SpanBuffer buffer(2);
+  Span span(test_time.timeSystem());
+  span.setTraceId(1);
+  span.setTraceIdHigh(2);
+  span.setId(3);
+  span.setParentId(4);
+  span.setName("span_name");
+  span.setTag("key", "value");
+
+  EXPECT_TRUE(buffer.addSpan(span));
+  EXPECT_TRUE(buffer.addSpan(span));
+  EXPECT_FALSE(buffer.addSpan(span));
+
+  Buffer::OwnedImpl output;
+  buffer.drainJsonArray(output);
+  // The encoded spans are moved into the output as a single fragment.
+  EXPECT_EQ(1, output.getRawSlices(nullptr, 0));
+  EXPECT_EQ("[" + span.toJson() + "," + span.toJson() + "]", output.toString());
+  EXPECT_EQ(0ULL, buffer.pendingSpans());
+  EXPECT_EQ("[]", buffer.toStringifiedJsonArray());
+
+  // The buffer can be filled and drained again.
+  EXPECT_TRUE(buffer.addSpan(span));
+  Buffer::OwnedImpl second_output;
+  buffer.drainJsonArray(second_output);
+  EXPECT_EQ("[" + span.toJson() + "]", second_output.toString());
+
+  EXPECT_EQ(R"({"traceId":"00000000000000020000000000000001","name":"span_name",)"
+            R"("id":"0000000000000003","parentId":"0000000000000004","annotations":[],)"
+            R"("binaryAnnotations":[{"key":"key","value":"value"}]})",
+            span.toJson());
+}
+
 } // namespace
 } // namespace Zipkin
 } // namespace Tracers
@@ -2,6 +2,8 @@
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
 #include "common/runtime/runtime_impl.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/tracing/http_tracer_impl.h"
 
 #include "extensions/tracers/zipkin/tracer.h"
 #include "extensions/tracers/zipkin/util.h"
@@ -337,6 +339,94 @@ TEST_F(ZipkinTracerTest, finishNotSampledSpan) {
   EXPECT_EQ(0ULL, reporter_object->reportedSpans().size());
 }
 
+class ZipkinTailSamplingTest : public ZipkinTracerTest {
+protected:
+  ZipkinTailSamplingTest()
+      : stats_{ZIPKIN_TAIL_SAMPLING_STATS(POOL_COUNTER(store_))},
+        tracer_("my_service_name", Network::Utility::parseInternetAddressAndPort("127.0.0.1:9000"),
+                random_generator_, false, true, time_system_),
+        reporter_(new TestReporterImpl(0)) {
+    ON_CALL(config_, operationName()).WillByDefault(Return(Tracing::OperationName::Ingress));
+    tracer_.setReporter(ReporterPtr(reporter_));
+  }
+
+  void setTailSampler(absl::optional<std::chrono::microseconds> min_duration,
+                      absl::optional<uint64_t> min_response_code, uint64_t max_spans_per_second) {
+    tracer_.setTailSampler(std::make_unique<TailSampler>(
+        min_duration, min_response_code, max_spans_per_second, stats_, time_system_));
+  }
+
+  // Finishes a span that was not sampled, which took the given time and got the given response.
+  void finishSpan(std::chrono::milliseconds duration, const std::string& response_code) {
+    SpanPtr span = tracer_.startSpan(config_, "my_span", time_system_.systemTime());
+    span->setSampled(false);
+    time_system_.sleep(duration);
+    span->setTag(Tracing::Tags::get().HttpStatusCode, response_code);
+    span->finish();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  TailSamplingStats stats_;
+  NiceMock<Runtime::MockRandomGenerator> random_generator_;
+  NiceMock<Tracing::MockConfig> config_;
+  Tracer tracer_;
+  TestReporterImpl* reporter_;
+};
+
+TEST_F(ZipkinTailSamplingTest, KeepSlowSpans) {
+  setTailSampler(std::chrono::milliseconds(100), absl::nullopt, 10);
+
+  finishSpan(std::chrono::milliseconds(99), "500");
+  EXPECT_EQ(0ULL, reporter_->reportedSpans().size());
+
+  finishSpan(std::chrono::milliseconds(100), "200");
+  EXPECT_EQ(1ULL, reporter_->reportedSpans().size());
+  EXPECT_EQ(1UL, stats_.tail_sampled_.value());
+}
+
+TEST_F(ZipkinTailSamplingTest, KeepFailedSpans) {
+  setTailSampler(absl::nullopt, 500, 10);
+
+  finishSpan(std::chrono::milliseconds(1000), "404");
+  EXPECT_EQ(0ULL, reporter_->reportedSpans().size());
+
+  finishSpan(std::chrono::milliseconds(0), "503");
+  EXPECT_EQ(1ULL, reporter_->reportedSpans().size());
+
+  // The request did not get a response.
+  finishSpan(std::chrono::milliseconds(0), "0");
+  EXPECT_EQ(2ULL, reporter_->reportedSpans().size());
+  EXPECT_EQ(2UL, stats_.tail_sampled_.value());
+}
+
+TEST_F(ZipkinTailSamplingTest, SampledSpansAlwaysReported) {
+  setTailSampler(std::chrono::milliseconds(100), 500, 10);
+
+  SpanPtr span = tracer_.startSpan(config_, "my_span", time_system_.systemTime());
+  span->setSampled(true);
+  span->setTag(Tracing::Tags::get().HttpStatusCode, "200");
+  span->finish();
+
+  EXPECT_EQ(1ULL, reporter_->reportedSpans().size());
+  EXPECT_EQ(0UL, stats_.tail_sampled_.value());
+}
+
+TEST_F(ZipkinTailSamplingTest, MaxSpansPerSecond) {
+  setTailSampler(absl::nullopt, 500, 2);
+
+  for (int i = 0; i < 3; i++) {
+    finishSpan(std::chrono::milliseconds(0), "500");
+  }
+  EXPECT_EQ(2ULL, reporter_->reportedSpans().size());
+  EXPECT_EQ(2UL, stats_.tail_sampled_.value());
+  EXPECT_EQ(1UL, stats_.tail_sampling_overflow_.value());
+
+  // The budget refills over time.
+  finishSpan(std::chrono::milliseconds(500), "500");
+  EXPECT_EQ(3ULL, reporter_->reportedSpans().size());
+  EXPECT_EQ(1UL, stats_.tail_sampling_overflow_.value());
+}
+
 TEST_F(ZipkinTracerTest, SpanSampledPropagatedToChild) {
   Network::Address::InstanceConstSharedPtr addr =
       Network::Utility::parseInternetAddressAndPort("127.0.0.1:9000");
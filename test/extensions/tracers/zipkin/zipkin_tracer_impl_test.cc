@@ -279,6 +279,29 @@ TEST_F(ZipkinDriverTest, NoB3ContextSampledFalse) {
   EXPECT_FALSE(zipkin_span->span().sampled());
 }
 
+TEST_F(ZipkinDriverTest, TailSampling) {
+  EXPECT_CALL(cm_, get("fake_cluster")).WillRepeatedly(Return(&cm_.thread_local_cluster_));
+  const std::string yaml_string = R"EOF(
+  collector_cluster: fake_cluster
+  tail_sampling:
+    min_response_code: 500
+    max_spans_per_second: 1
+  )EOF";
+  envoy::config::trace::v2::ZipkinConfig zipkin_config;
+  MessageUtil::loadFromYaml(yaml_string, zipkin_config);
+  setup(zipkin_config, true);
+
+  for (const char* response_code : {"200", "500", "503"}) {
+    Tracing::SpanPtr span = driver_->startSpan(config_, request_headers_, operation_name_,
+                                               start_time_, {Tracing::Reason::Sampling, false});
+    span->setTag(Tracing::Tags::get().HttpStatusCode, response_code);
+    span->finishSpan();
+  }
+
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.tail_sampled").value());
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.tail_sampling_overflow").value());
+}
+
 TEST_F(ZipkinDriverTest, PropagateB3NoSampleDecisionSampleTrue) {
   setupValidDriver();
 
@@ -455,10 +455,33 @@ TEST_F(SslServerContextImplTicketTest, TicketKeyInlineStringFailTooSmall) {
   EXPECT_THROW(loadConfigV2(cfg), EnvoyException);
 }
 
-TEST_F(SslServerContextImplTicketTest, TicketKeySdsFail) {
+TEST_F(SslServerContextImplTicketTest, TicketKeyStaticSecretSuccess) {
+  envoy::api::v2::auth::Secret secret_config;
+  secret_config.set_name("ticket_keys");
+  secret_config.mutable_session_ticket_keys()->add_keys()->set_inline_bytes(std::string(80, '\0'));
+  factory_context_.secretManager().addStaticSecret(secret_config);
+
+  envoy::api::v2::auth::DownstreamTlsContext cfg;
+  cfg.mutable_session_ticket_keys_sds_secret_config()->set_name("ticket_keys");
+  EXPECT_NO_THROW(loadConfigV2(cfg));
+}
+
+TEST_F(SslServerContextImplTicketTest, TicketKeyStaticSecretInvalidLen) {
+  envoy::api::v2::auth::Secret secret_config;
+  secret_config.set_name("ticket_keys");
+  secret_config.mutable_session_ticket_keys()->add_keys()->set_inline_bytes(std::string(79, '\0'));
+  factory_context_.secretManager().addStaticSecret(secret_config);
+
+  envoy::api::v2::auth::DownstreamTlsContext cfg;
+  cfg.mutable_session_ticket_keys_sds_secret_config()->set_name("ticket_keys");
+  EXPECT_THROW(loadConfigV2(cfg), EnvoyException);
+}
+
+TEST_F(SslServerContextImplTicketTest, TicketKeyStaticSecretMissing) {
   envoy::api::v2::auth::DownstreamTlsContext cfg;
-  cfg.mutable_session_ticket_keys_sds_secret_config();
-  EXPECT_THROW_WITH_MESSAGE(loadConfigV2(cfg), EnvoyException, "SDS not supported yet");
+  cfg.mutable_session_ticket_keys_sds_secret_config()->set_name("missing");
+  EXPECT_THROW_WITH_MESSAGE(loadConfigV2(cfg), EnvoyException,
+                            "Unknown static session ticket keys: missing");
 }
 
 TEST_F(SslServerContextImplTicketTest, CRLSuccess) {
@@ -1077,6 +1100,28 @@ TEST_F(ServerContextConfigImplTest, TlsCertificatesAndSdsConfig) {
       "SDS and non-SDS TLS certificates may not be mixed in server contexts");
 }
 
+// All the configs that offload private key operations share one pool.
+TEST_F(ServerContextConfigImplTest, PrivateKeyOffloadPoolShared) {
+  envoy::api::v2::auth::DownstreamTlsContext tls_context;
+  const std::string tls_certificate_yaml = R"EOF(
+  certificate_chain:
+    filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+  private_key:
+    filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+  )EOF";
+  MessageUtil::loadFromYaml(TestEnvironment::substitute(tls_certificate_yaml),
+                            *tls_context.mutable_common_tls_context()->add_tls_certificates());
+  ServerContextConfigImpl no_offload_config(tls_context, factory_context_);
+  EXPECT_EQ(nullptr, no_offload_config.privateKeyOperationRunner());
+
+  tls_context.mutable_private_key_offload_threads()->set_value(1);
+  ServerContextConfigImpl first_config(tls_context, factory_context_);
+  tls_context.mutable_private_key_offload_threads()->set_value(4);
+  ServerContextConfigImpl second_config(tls_context, factory_context_);
+  ASSERT_NE(nullptr, first_config.privateKeyOperationRunner());
+  EXPECT_EQ(first_config.privateKeyOperationRunner(), second_config.privateKeyOperationRunner());
+}
+
 TEST_F(ServerContextConfigImplTest, MultiSdsConfig) {
   envoy::api::v2::auth::DownstreamTlsContext tls_context;
   tls_context.mutable_common_tls_context()->add_tls_certificate_sds_secret_configs();
@@ -1150,6 +1195,42 @@ TEST_F(ServerContextConfigImplTest, ValidationContextNotReady) {
   server_context_config.setSecretUpdateCallback([]() {});
 }
 
+// Validate server context config is marked as not ready until dynamic session ticket keys are
+// downloaded.
+TEST_F(ServerContextConfigImplTest, SessionTicketKeysNotReady) {
+  envoy::api::v2::auth::DownstreamTlsContext tls_context;
+  envoy::api::v2::auth::TlsCertificate* server_cert =
+      tls_context.mutable_common_tls_context()->add_tls_certificates();
+  server_cert->mutable_certificate_chain()->set_filename(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"));
+  server_cert->mutable_private_key()->set_filename(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"));
+  NiceMock<LocalInfo::MockLocalInfo> local_info;
+  NiceMock<Event::MockDispatcher> dispatcher;
+  NiceMock<Runtime::MockRandomGenerator> random;
+  Stats::IsolatedStoreImpl stats;
+  NiceMock<Upstream::MockClusterManager> cluster_manager;
+  NiceMock<Init::MockManager> init_manager;
+  EXPECT_CALL(factory_context_, localInfo()).WillOnce(ReturnRef(local_info));
+  EXPECT_CALL(factory_context_, dispatcher()).WillOnce(ReturnRef(dispatcher));
+  EXPECT_CALL(factory_context_, random()).WillOnce(ReturnRef(random));
+  EXPECT_CALL(factory_context_, stats()).WillOnce(ReturnRef(stats));
+  EXPECT_CALL(factory_context_, clusterManager()).WillOnce(ReturnRef(cluster_manager));
+  EXPECT_CALL(factory_context_, initManager()).WillRepeatedly(Return(&init_manager));
+  auto sds_secret_config = tls_context.mutable_session_ticket_keys_sds_secret_config();
+  sds_secret_config->set_name("ticket_keys");
+  sds_secret_config->mutable_sds_config();
+  ServerContextConfigImpl server_context_config(tls_context, factory_context_);
+  // When sds secret is not downloaded, config is not ready.
+  EXPECT_FALSE(server_context_config.isReady());
+  EXPECT_TRUE(server_context_config.sessionTicketKeys().empty());
+  // Set various callbacks to config.
+  NiceMock<Secret::MockSecretCallbacks> secret_callback;
+  server_context_config.setSecretUpdateCallback(
+      [&secret_callback]() { secret_callback.onAddOrUpdateSecret(); });
+  server_context_config.setSecretUpdateCallback([]() {});
+}
+
 // TlsCertificate messages must have a cert for servers.
 TEST_F(ServerContextConfigImplTest, TlsCertificateNonEmpty) {
   envoy::api::v2::auth::DownstreamTlsContext tls_context;
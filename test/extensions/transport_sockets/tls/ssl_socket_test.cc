@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -16,6 +17,7 @@
 #include "extensions/filters/listener/tls_inspector/tls_inspector.h"
 #include "extensions/transport_sockets/tls/context_config_impl.h"
 #include "extensions/transport_sockets/tls/context_impl.h"
+#include "extensions/transport_sockets/tls/private_key_offload.h"
 #include "extensions/transport_sockets/tls/ssl_socket.h"
 
 #include "test/extensions/transport_sockets/tls/ssl_certs_test.h"
@@ -197,12 +199,20 @@ public:
     return expected_expiration_peer_cert_;
   }
 
+  TestUtilOptions& setExpectedPrivateKeyOperations(uint64_t expected_private_key_operations) {
+    expected_private_key_operations_ = expected_private_key_operations;
+    return *this;
+  }
+
+  uint64_t expectedPrivateKeyOperations() const { return expected_private_key_operations_; }
+
 private:
   const std::string client_ctx_yaml_;
   const std::string server_ctx_yaml_;
 
   bool expect_no_cert_;
   bool expect_no_cert_chain_;
+  uint64_t expected_private_key_operations_{};
   std::string expected_digest_;
   std::vector<std::string> expected_local_uri_;
   std::string expected_serial_number_;
@@ -214,6 +224,22 @@ private:
   std::string expected_expiration_peer_cert_;
 };
 
+// Counts the private key operations that are offloaded, to tell them apart from operations that
+// are performed on the worker during the handshake. Operations are posted from the dispatcher,
+// which testUtil() runs on the test thread.
+class CountingPrivateKeyOffloadPool : public PrivateKeyOffloadPool {
+public:
+  using PrivateKeyOffloadPool::PrivateKeyOffloadPool;
+
+  // PrivateKeyOffloadPool
+  void post(std::function<void()> operation) override {
+    posted_++;
+    PrivateKeyOffloadPool::post(std::move(operation));
+  }
+
+  uint64_t posted_{};
+};
+
 void testUtil(const TestUtilOptions& options) {
   Event::SimulatedTimeSystem time_system;
 
@@ -222,6 +248,11 @@ void testUtil(const TestUtilOptions& options) {
   testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext>
       server_factory_context;
   ON_CALL(server_factory_context, api()).WillByDefault(ReturnRef(*server_api));
+  // Server context configs that offload private key operations take the pool from the singleton
+  // manager under the name registered in context_config_impl.cc.
+  auto offload_pool = std::make_shared<CountingPrivateKeyOffloadPool>(server_api->threadFactory());
+  server_factory_context.singletonManager().getTyped<PrivateKeyOffloadPool>(
+      "private_key_offload_pool_singleton", [&offload_pool] { return offload_pool; });
 
   envoy::api::v2::auth::DownstreamTlsContext server_tls_context;
   MessageUtil::loadFromYaml(TestEnvironment::substitute(options.serverCtxYaml()),
@@ -369,6 +400,7 @@ void testUtil(const TestUtilOptions& options) {
   if (!options.expectedServerStats().empty()) {
     EXPECT_EQ(1UL, server_stats_store.counter(options.expectedServerStats()).value());
   }
+  EXPECT_EQ(options.expectedPrivateKeyOperations(), offload_pool->posted_);
 }
 
 /**
@@ -689,7 +721,8 @@ protected:
 
   void testClientSessionResumption(const std::string& server_ctx_yaml,
                                    const std::string& client_ctx_yaml, bool expect_reuse,
-                                   const Network::Address::IpVersion version);
+                                   const Network::Address::IpVersion version,
+                                   const std::string& second_server_name = "");
 
   Event::DispatcherPtr dispatcher_;
 };
@@ -725,6 +758,62 @@ TEST_P(SslSocketTest, GetCertDigest) {
                .setExpectedSerialNumber(TEST_NO_SAN_CERT_SERIAL));
 }
 
+TEST_P(SslSocketTest, PrivateKeyOffload) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+  private_key_offload_threads: 2
+)EOF";
+
+  // The server signs its key exchange parameters once.
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(
+      test_options.setExpectedDigest(TEST_NO_SAN_CERT_HASH).setExpectedPrivateKeyOperations(1));
+}
+
+// The RSA key exchange uses the decrypt operation rather than signing.
+TEST_P(SslSocketTest, PrivateKeyOffloadRsaKeyExchange) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - AES128-SHA
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+  private_key_offload_threads: 1
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options.setExpectedServerStats("ssl.no_certificate")
+               .setExpectNoCert()
+               .setExpectNoCertChain()
+               .setExpectedPrivateKeyOperations(1));
+}
+
 TEST_P(SslSocketTest, GetCertDigestInline) {
   envoy::api::v2::Listener listener;
   envoy::api::v2::listener::FilterChain* filter_chain = listener.add_filter_chains();
@@ -2804,7 +2893,8 @@ TEST_P(SslSocketTest, ClientAuthCrossListenerSessionResumption) {
 void SslSocketTest::testClientSessionResumption(const std::string& server_ctx_yaml,
                                                 const std::string& client_ctx_yaml,
                                                 bool expect_reuse,
-                                                const Network::Address::IpVersion version) {
+                                                const Network::Address::IpVersion version,
+                                                const std::string& second_server_name) {
   InSequence s;
 
   ContextManagerImpl manager(time_system_);
@@ -2914,7 +3004,11 @@ void SslSocketTest::testClientSessionResumption(const std::string& server_ctx_ya
 
   client_connection = dispatcher->createClientConnection(
       socket.localAddress(), Network::Address::InstanceConstSharedPtr(),
-      client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+      client_ssl_socket_factory.createTransportSocket(
+          second_server_name.empty()
+              ? nullptr
+              : std::make_shared<Network::TransportSocketOptionsImpl>(second_server_name)),
+      nullptr);
   client_connection->addConnectionCallbacks(client_connection_callbacks);
   client_connection->connect();
 
@@ -2953,6 +3047,14 @@ void SslSocketTest::testClientSessionResumption(const std::string& server_ctx_ya
 
   EXPECT_EQ(expect_reuse ? 1UL : 0UL, server_stats_store.counter("ssl.session_reused").value());
   EXPECT_EQ(expect_reuse ? 1UL : 0UL, client_stats_store.counter("ssl.session_reused").value());
+  if (second_server_name.empty()) {
+    // Only the first connection finds the cache empty, if the cache is enabled.
+    EXPECT_EQ(expect_reuse ? 1UL : 0UL,
+              client_stats_store.counter("ssl.session_cache_miss").value());
+  } else {
+    // Sessions are cached per SNI, so neither connection finds a session to offer.
+    EXPECT_EQ(2UL, client_stats_store.counter("ssl.session_cache_miss").value());
+  }
 }
 
 // Test client session resumption using default settings (should be enabled).
@@ -2973,6 +3075,27 @@ TEST_P(SslSocketTest, ClientSessionResumptionDefault) {
   testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
 }
 
+// Make sure a session is not offered to an upstream with a different SNI than the one that
+// issued it.
+TEST_P(SslSocketTest, ClientSessionResumptionDifferentServerName) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+  sni: server1.example.com
+)EOF";
+
+  testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, false, GetParam(),
+                              "server2.example.com");
+}
+
 // Make sure client session resumption is not happening with TLS 1.0-1.2 when it's disabled.
 TEST_P(SslSocketTest, ClientSessionResumptionDisabledTls12) {
   const std::string server_ctx_yaml = R"EOF(
@@ -3757,6 +3880,10 @@ protected:
     listener_ = dispatcher_->createListener(socket_, listener_callbacks_, true, false);
 
     MessageUtil::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml_), upstream_tls_context_);
+    if (dynamic_record_sizing_) {
+      upstream_tls_context_.mutable_common_tls_context()->mutable_dynamic_record_sizing()->set_value(
+          true);
+    }
     auto client_cfg =
         std::make_unique<ClientContextConfigImpl>(upstream_tls_context_, factory_context_);
 
@@ -3768,6 +3895,18 @@ protected:
     client_connection_->addConnectionCallbacks(client_callbacks_);
     client_connection_->connect();
     read_filter_.reset(new Network::MockReadFilter());
+
+    // Record the length of each application data record the client writes.
+    SSL* client_ssl = dynamic_cast<const SslSocket*>(client_connection_->ssl())->rawSslForTest();
+    SSL_set_msg_callback(client_ssl, [](int write_p, int, int content_type, const void* buf,
+                                        size_t len, SSL*, void* arg) -> void {
+      const uint8_t* header = static_cast<const uint8_t*>(buf);
+      if (write_p && content_type == SSL3_RT_HEADER && len == SSL3_RT_HEADER_LENGTH &&
+          header[0] == SSL3_RT_APPLICATION_DATA) {
+        static_cast<std::vector<uint64_t>*>(arg)->push_back((header[3] << 8) | header[4]);
+      }
+    });
+    SSL_set_msg_callback_arg(client_ssl, &client_record_lengths_);
   }
 
   void readBufferLimitTest(uint32_t read_buffer_limit, uint32_t expected_chunk_size,
@@ -3945,6 +4084,8 @@ protected:
   std::shared_ptr<Network::MockReadFilter> read_filter_;
   StrictMock<Network::MockConnectionCallbacks> client_callbacks_;
   Network::Address::InstanceConstSharedPtr source_address_;
+  bool dynamic_record_sizing_{};
+  std::vector<uint64_t> client_record_lengths_;
 };
 
 INSTANTIATE_TEST_SUITE_P(IpVersions, SslReadBufferLimitTest,
@@ -3965,6 +4106,26 @@ TEST_P(SslReadBufferLimitTest, SomeLimit) {
   readBufferLimitTest(32 * 1024, 32 * 1024, 256 * 1024, 1, false);
 }
 
+TEST_P(SslReadBufferLimitTest, FullRecords) {
+  readBufferLimitTest(0, 256 * 1024, 256 * 1024, 1, false);
+  // 16KiB of plaintext plus the record overhead.
+  EXPECT_GT(client_record_lengths_.front(), 16384UL);
+}
+
+TEST_P(SslReadBufferLimitTest, DynamicRecordSizing) {
+  dynamic_record_sizing_ = true;
+  readBufferLimitTest(0, 2 * 1024 * 1024, 2 * 1024 * 1024, 1, false);
+  // The first 1MiB is written in records that fit in a single TCP segment, and the rest in full
+  // records.
+  EXPECT_LT(client_record_lengths_.front(), 1400UL);
+  EXPECT_GT(client_record_lengths_.back(), 16384UL);
+  const uint64_t small_records =
+      std::count_if(client_record_lengths_.begin(), client_record_lengths_.end(),
+                    [](uint64_t length) -> bool { return length < 1400; });
+  EXPECT_GE(small_records, 1024UL * 1024 / 1300);
+  EXPECT_LE(small_records, 1024UL * 1024 / 1300 + 1);
+}
+
 TEST_P(SslReadBufferLimitTest, WritesSmallerThanBufferLimit) { singleWriteTest(5 * 1024, 1024); }
 
 TEST_P(SslReadBufferLimitTest, WritesLargerThanBufferLimit) { singleWriteTest(1024, 5 * 1024); }
@@ -39,6 +39,11 @@ public:
     }
   }
 
+  // The KeyHandle variants keep their default implementations, which forward to the string keyed
+  // mocks below.
+  using Snapshot::featureEnabled;
+  using Snapshot::getInteger;
+
   MOCK_CONST_METHOD1(deprecatedFeatureEnabled, bool(const std::string& key));
   MOCK_CONST_METHOD1(runtimeFeatureEnabled, bool(absl::string_view key));
   MOCK_CONST_METHOD2(featureEnabled, bool(const std::string& key, uint64_t default_value));
@@ -21,6 +21,8 @@ public:
                      TlsCertificateConfigProviderSharedPtr(const std::string& name));
   MOCK_CONST_METHOD1(findStaticCertificateValidationContextProvider,
                      CertificateValidationContextConfigProviderSharedPtr(const std::string& name));
+  MOCK_CONST_METHOD1(findStaticTlsSessionTicketKeysProvider,
+                     TlsSessionTicketKeysConfigProviderSharedPtr(const std::string& name));
   MOCK_METHOD1(createInlineTlsCertificateProvider,
                TlsCertificateConfigProviderSharedPtr(
                    const envoy::api::v2::auth::TlsCertificate& tls_certificate));
@@ -37,6 +39,11 @@ public:
                    const envoy::api::v2::core::ConfigSource& config_source,
                    const std::string& config_name,
                    Server::Configuration::TransportSocketFactoryContext& secret_provider_context));
+  MOCK_METHOD3(findOrCreateTlsSessionTicketKeysProvider,
+               TlsSessionTicketKeysConfigProviderSharedPtr(
+                   const envoy::api::v2::core::ConfigSource& config_source,
+                   const std::string& config_name,
+                   Server::Configuration::TransportSocketFactoryContext& secret_provider_context));
 };
 
 class MockSecretCallbacks : public SecretCallbacks {
@@ -71,6 +71,8 @@ public:
   MOCK_CONST_METHOD0(parentShutdownTime, std::chrono::seconds());
   MOCK_CONST_METHOD0(restartEpoch, uint64_t());
   MOCK_CONST_METHOD0(fileFlushIntervalMsec, std::chrono::milliseconds());
+  MOCK_CONST_METHOD0(fileBufferLimitBytes, uint64_t());
+  MOCK_CONST_METHOD0(dropOnFileBufferLimit, bool());
   MOCK_CONST_METHOD0(mode, Mode());
   MOCK_CONST_METHOD0(serviceClusterName, const std::string&());
   MOCK_CONST_METHOD0(serviceNodeName, const std::string&());
@@ -152,6 +154,7 @@ public:
   MOCK_CONST_METHOD0(getRequestHeaders, Http::HeaderMap&());
   MOCK_CONST_METHOD0(getDecoderFilterCallbacks,
                      NiceMock<Http::MockStreamDecoderFilterCallbacks>&());
+  MOCK_METHOD1(streamResponse, void(StreamingCallback));
 };
 
 class MockDrainManager : public DrainManager {
@@ -494,6 +497,7 @@ public:
 
   std::unique_ptr<Secret::SecretManager> secret_manager_;
   testing::NiceMock<Api::MockApi> api_;
+  Singleton::ManagerPtr singleton_manager_;
 };
 
 class MockListenerFactoryContext : public MockFactoryContext, public ListenerFactoryContext {
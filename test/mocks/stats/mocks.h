@@ -149,6 +149,7 @@ public:
 
   MOCK_METHOD1(flush, void(Source& source));
   MOCK_METHOD2(onHistogramComplete, void(const Histogram& histogram, uint64_t value));
+  MOCK_CONST_METHOD0(threadSafeFlush, bool());
 };
 
 class SymbolTableProvider {
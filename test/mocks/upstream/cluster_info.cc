@@ -20,6 +20,8 @@ MockLoadBalancerSubsetInfo::MockLoadBalancerSubsetInfo() {
       .WillByDefault(Return(envoy::api::v2::Cluster::LbSubsetConfig::ANY_ENDPOINT));
   ON_CALL(*this, defaultSubset()).WillByDefault(ReturnRef(ProtobufWkt::Struct::default_instance()));
   ON_CALL(*this, subsetKeys()).WillByDefault(ReturnRef(subset_keys_));
+  ON_CALL(*this, lazySubsetIdleTimeout())
+      .WillByDefault(Return(std::chrono::milliseconds(60000)));
 }
 
 MockLoadBalancerSubsetInfo::~MockLoadBalancerSubsetInfo() {}
@@ -62,6 +64,7 @@ MockClusterInfo::MockClusterInfo()
   ON_CALL(*this, lbOriginalDstConfig()).WillByDefault(ReturnRef(lb_original_dst_config_));
   ON_CALL(*this, lbConfig()).WillByDefault(ReturnRef(lb_config_));
   ON_CALL(*this, clusterSocketOptions()).WillByDefault(ReturnRef(cluster_socket_options_));
+  ON_CALL(*this, perUpstreamPrefetchRatio()).WillByDefault(Return(1.0));
 }
 
 MockClusterInfo::~MockClusterInfo() {}
@@ -37,6 +37,9 @@ public:
   MOCK_CONST_METHOD0(localityWeightAware, bool());
   MOCK_CONST_METHOD0(scaleLocalityWeight, bool());
   MOCK_CONST_METHOD0(panicModeAny, bool());
+  MOCK_CONST_METHOD0(lazySubsetCreation, bool());
+  MOCK_CONST_METHOD0(lazySubsetIdleTimeout, std::chrono::milliseconds());
+  MOCK_CONST_METHOD0(maxLazySubsets, uint32_t());
 
   std::vector<std::set<std::string>> subset_keys_;
 };
@@ -84,6 +87,8 @@ public:
   MOCK_CONST_METHOD0(typedMetadata, const Envoy::Config::TypedMetadata&());
   MOCK_CONST_METHOD0(clusterSocketOptions, const Network::ConnectionSocket::OptionsSharedPtr&());
   MOCK_CONST_METHOD0(drainConnectionsOnHostRemoval, bool());
+  MOCK_CONST_METHOD0(perUpstreamPrefetchRatio, float());
+  MOCK_CONST_METHOD0(prewarmNewHosts, bool());
   MOCK_CONST_METHOD0(eds_service_name, absl::optional<std::string>());
 
   std::string name_{"fake_cluster"};
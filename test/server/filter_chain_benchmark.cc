@@ -0,0 +1,132 @@
+// Usage: bazel run //test/server:filter_chain_benchmark
+//
+// The certificate of each filter chain is read relative to the working directory, which is the
+// runfiles directory under bazel run.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/api/v2/auth/cert.pb.h"
+
+#include "common/common/fmt.h"
+#include "common/network/address_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/listen_socket_impl.h"
+
+#include "server/listener_manager_impl.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/server/utility.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::ReturnNew;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+// Builds a listener with one filter chain per server name, resembling a listener that terminates
+// TLS for many customer domains, each with its own certificate. Every filter chain gets its own
+// TLS context, so that the cost of creating and holding them shows up next to the matching cost.
+class FilterChainTester {
+public:
+  FilterChainTester(uint64_t num_server_names, bool wildcard) : api_(Api::createApiForTest()) {
+    ON_CALL(server_, api()).WillByDefault(ReturnRef(*api_));
+    ON_CALL(worker_factory_, createWorker_()).WillByDefault(ReturnNew<NiceMock<MockWorker>>());
+    manager_ = std::make_unique<ListenerManagerImpl>(server_, listener_factory_, worker_factory_);
+
+    envoy::api::v2::Listener listener = parseListenerFromV2Yaml(R"EOF(
+      name: foo
+      address:
+        socket_address: { address: 127.0.0.1, port_value: 1234 }
+    )EOF");
+    envoy::api::v2::auth::DownstreamTlsContext tls_context;
+    auto* tls_certificate = tls_context.mutable_common_tls_context()->add_tls_certificates();
+    tls_certificate->mutable_certificate_chain()->set_inline_string(api_->fileSystem().fileReadToEnd(
+        "test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"));
+    tls_certificate->mutable_private_key()->set_inline_string(api_->fileSystem().fileReadToEnd(
+        "test/extensions/transport_sockets/tls/test_data/san_dns_key.pem"));
+    for (uint64_t i = 0; i < num_server_names; i++) {
+      auto* filter_chain = listener.add_filter_chains();
+      filter_chain->mutable_filter_chain_match()->add_server_names(
+          fmt::format("{}.customer{}.example.com", wildcard ? "*" : "www", i));
+      filter_chain->mutable_tls_context()->CopyFrom(tls_context);
+      // Every connection is for a www server name, which matches the wildcard domains as well.
+      server_names_.push_back(fmt::format("www.customer{}.example.com", i));
+    }
+    manager_->addOrUpdateListener(listener, "", true);
+  }
+
+  const Network::FilterChainManager& filterChainManager() {
+    return manager_->listeners().back().get().filterChainManager();
+  }
+
+  std::vector<std::string> server_names_;
+
+private:
+  Api::ApiPtr api_;
+  NiceMock<MockInstance> server_;
+  NiceMock<MockListenerComponentFactory> listener_factory_;
+  NiceMock<MockWorkerFactory> worker_factory_;
+  std::unique_ptr<ListenerManagerImpl> manager_;
+};
+
+void findFilterChains(benchmark::State& state, bool wildcard) {
+  FilterChainTester tester(state.range(0), wildcard);
+  const Network::FilterChainManager& filter_chain_manager = tester.filterChainManager();
+  Network::ConnectionSocketImpl socket(std::make_unique<Network::IoSocketHandleImpl>(),
+                                       std::make_shared<Network::Address::Ipv4Instance>(
+                                           "127.0.0.1", 1234),
+                                       nullptr);
+  socket.setDetectedTransportProtocol("tls");
+
+  uint64_t i = 0;
+  for (auto _ : state) {
+    socket.setRequestedServerName(tester.server_names_[i++ % tester.server_names_.size()]);
+    const Network::FilterChain* filter_chain = filter_chain_manager.findFilterChain(socket);
+    RELEASE_ASSERT(filter_chain != nullptr, "");
+    benchmark::DoNotOptimize(filter_chain);
+  }
+}
+
+// Measures matching a connection's SNI against exact server names.
+void BM_FindFilterChainExactServerName(benchmark::State& state) { findFilterChains(state, false); }
+BENCHMARK(BM_FindFilterChainExactServerName)->Arg(1000)->Arg(10000);
+
+// Measures matching a connection's SNI against wildcard server names, which costs an exact probe
+// before the wildcard probe.
+void BM_FindFilterChainWildcardServerName(benchmark::State& state) {
+  findFilterChains(state, true);
+}
+BENCHMARK(BM_FindFilterChainWildcardServerName)->Arg(1000)->Arg(10000);
+
+// Measures loading a listener with a filter chain per server name.
+void BM_AddListener(benchmark::State& state) {
+  for (auto _ : state) {
+    FilterChainTester tester(state.range(0), false);
+    benchmark::DoNotOptimize(tester.filterChainManager());
+  }
+}
+BENCHMARK(BM_AddListener)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
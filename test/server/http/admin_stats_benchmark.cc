@@ -0,0 +1,103 @@
+// Usage: bazel run //test/server/http:admin_stats_benchmark
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/fmt.h"
+#include "common/stats/heap_stat_data.h"
+#include "common/stats/symbol_table_impl.h"
+
+#include "server/http/admin.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+// Builds a set of cluster stats resembling a large deployment: each cluster has the same
+// tag-extracted names, and all the stats in a cluster have the same tags.
+class StatsTester {
+public:
+  StatsTester(uint64_t num_stats) : alloc_(symbol_table_) {
+    for (uint64_t i = 0; i < num_stats; i++) {
+      const std::string cluster = fmt::format("service_{}", i / StatsPerCluster);
+      const std::string stat = fmt::format("upstream_rq_{}", i % StatsPerCluster);
+      std::vector<Stats::Tag> tags{{"envoy.cluster_name", cluster}};
+      Stats::CounterSharedPtr counter =
+          alloc_.makeCounter(fmt::format("cluster.{}.{}", cluster, stat),
+                             fmt::format("cluster.{}", stat), std::move(tags));
+      counter->add(i);
+      counters_.push_back(counter);
+    }
+  }
+
+  static constexpr uint64_t StatsPerCluster = 50;
+
+  Stats::SymbolTableImpl symbol_table_;
+  Stats::HeapStatDataAllocator alloc_;
+  std::vector<Stats::CounterSharedPtr> counters_;
+};
+
+// Measures the cost of formatting a full Prometheus scrape in one go.
+void BM_PrometheusScrape(benchmark::State& state) {
+  StatsTester tester(state.range(0));
+  for (auto _ : state) {
+    Buffer::OwnedImpl response;
+    PrometheusStatsFormatter::statsAsPrometheus(tester.counters_, {}, {}, response, false);
+    benchmark::DoNotOptimize(response.length());
+  }
+}
+BENCHMARK(BM_PrometheusScrape)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(500000)
+    ->Unit(benchmark::kMillisecond);
+
+// Measures the longest time the main thread is held by a streamed Prometheus scrape, which is the
+// time taken to format a single chunk.
+void BM_PrometheusScrapeChunk(benchmark::State& state) {
+  StatsTester tester(state.range(0));
+  std::unique_ptr<PrometheusStatsFormatter::Writer> writer;
+  for (auto _ : state) {
+    if (writer == nullptr) {
+      state.PauseTiming();
+      writer = std::make_unique<PrometheusStatsFormatter::Writer>(
+          std::vector<Stats::CounterSharedPtr>(tester.counters_),
+          std::vector<Stats::GaugeSharedPtr>(), std::vector<Stats::ParentHistogramSharedPtr>(),
+          false);
+      state.ResumeTiming();
+    }
+    Buffer::OwnedImpl chunk;
+    if (!writer->nextChunk(chunk, 1000)) {
+      writer.reset();
+    }
+    benchmark::DoNotOptimize(chunk.length());
+  }
+}
+BENCHMARK(BM_PrometheusScrapeChunk)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(500000)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
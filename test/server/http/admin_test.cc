@@ -29,6 +29,7 @@
 #include "test/test_common/utility.h"
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -589,6 +590,52 @@ TEST_P(AdminFilterTest, Trailers) {
   EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_.decodeTrailers(request_headers_));
 }
 
+TEST_P(AdminFilterTest, StreamedResponse) {
+  uint32_t chunks = 0;
+  admin_.addHandler("/stream", "streams three chunks",
+                    [&chunks](absl::string_view, Http::HeaderMap&, Buffer::Instance& response,
+                              AdminStream& admin_stream) -> Http::Code {
+                      response.add("head ");
+                      admin_stream.streamResponse([&chunks](Buffer::Instance& chunk) -> bool {
+                        chunk.add(fmt::format("chunk{} ", ++chunks));
+                        return chunks < 3;
+                      });
+                      return Http::Code::OK;
+                    },
+                    false, false);
+  Http::TestHeaderMapImpl request_headers{{":path", "/stream"}};
+
+  std::string body;
+  bool end_stream = false;
+  ON_CALL(callbacks_, encodeData(_, _))
+      .WillByDefault(Invoke([&body, &end_stream](Buffer::Instance& data, bool end) -> void {
+        body += data.toString();
+        end_stream = end;
+      }));
+  Event::MockTimer* timer = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(0))).Times(2);
+  filter_.decodeHeaders(request_headers, true);
+  EXPECT_EQ("head ", body);
+
+  // Nothing is sent while the downstream connection is backed up.
+  timer->invokeCallback();
+  EXPECT_EQ("head chunk1 ", body);
+  filter_.onAboveWriteBufferHighWatermark();
+  timer->invokeCallback();
+  EXPECT_EQ("head chunk1 chunk2 ", body);
+  EXPECT_FALSE(timer->enabled_);
+
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(0)));
+  filter_.onBelowWriteBufferLowWatermark();
+  timer->invokeCallback();
+  EXPECT_EQ("head chunk1 chunk2 chunk3 ", body);
+  EXPECT_TRUE(end_stream);
+
+  EXPECT_CALL(callbacks_, removeDownstreamWatermarkCallbacks(_));
+  filter_.onDestroy();
+}
+
 class AdminInstanceTest : public testing::TestWithParam<Network::Address::IpVersion> {
 public:
   AdminInstanceTest()
@@ -608,7 +655,10 @@ public:
                          Buffer::Instance& response, absl::string_view method) {
     request_headers_.insertMethod().value(method.data(), method.size());
     admin_filter_.decodeHeaders(request_headers_, false);
-    return admin_.runCallback(path_and_query, response_headers, response, admin_filter_);
+    const Http::Code code =
+        admin_.runCallback(path_and_query, response_headers, response, admin_filter_);
+    admin_filter_.drainStreamedResponse(response);
+    return code;
   }
 
   Http::Code getCallback(absl::string_view path_and_query, Http::HeaderMap& response_headers,
@@ -897,6 +947,26 @@ TEST_P(AdminInstanceTest, Memory) {
                     Property(&envoy::admin::v2alpha::Memory::total_thread_cache, Ge(0))));
 }
 
+TEST_P(AdminInstanceTest, StatsMemory) {
+  server_.stats().counter("cluster.a.upstream_rq_total");
+  server_.stats().counter("cluster.a.upstream_cx_total");
+  server_.stats().gauge("cluster.bb.membership_total");
+
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/stats/memory", header_map, response));
+  EXPECT_THAT(response.toString(), HasSubstr("\ncluster.a: 2 stats, 54 name bytes\n"));
+  EXPECT_THAT(response.toString(), HasSubstr("\ncluster.bb: 1 stats, 27 name bytes\n"));
+
+  response.drain(response.length());
+  EXPECT_EQ(Http::Code::OK, getCallback("/stats/memory?depth=1", header_map, response));
+  EXPECT_THAT(response.toString(), HasSubstr("\ncluster: 3 stats, 81 name bytes\n"));
+
+  response.drain(response.length());
+  EXPECT_EQ(Http::Code::BadRequest, getCallback("/stats/memory?depth=0", header_map, response));
+  EXPECT_TRUE(absl::StartsWith(response.toString(), "usage:"));
+}
+
 TEST_P(AdminInstanceTest, ContextThatReturnsNullCertDetails) {
   Http::HeaderMapImpl header_map;
   Buffer::OwnedImpl response;
@@ -1230,6 +1300,34 @@ TEST_P(AdminInstanceTest, GetRequestJson) {
               HasSubstr("application/json"));
 }
 
+TEST_P(AdminInstanceTest, GetRequestStatsSorted) {
+  server_.stats().counter("b.counter").add(2);
+  server_.stats().gauge("a.gauge").set(3);
+  server_.stats().counter("c.counter").inc();
+
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::OK, admin_.request("/stats?filter=counter$|gauge$", "GET",
+                                           response_headers, body));
+  EXPECT_EQ("a.gauge: 3\nb.counter: 2\nc.counter: 1\n", body);
+}
+
+// Test that stats spanning several chunks are all written when there are no histograms.
+TEST_P(AdminInstanceTest, GetRequestStatsMultipleChunks) {
+  for (uint32_t i = 0; i < 2500; i++) {
+    server_.stats().counter(fmt::format("chunked.counter{:04}", i)).inc();
+  }
+
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::OK,
+            admin_.request("/stats?filter=^chunked\\.", "GET", response_headers, body));
+  const std::vector<absl::string_view> lines = absl::StrSplit(body, '\n', absl::SkipEmpty());
+  ASSERT_EQ(2500U, lines.size());
+  EXPECT_EQ("chunked.counter0000: 1", lines.front());
+  EXPECT_EQ("chunked.counter2499: 1", lines.back());
+}
+
 TEST_P(AdminInstanceTest, PostRequest) {
   Http::HeaderMapImpl response_headers;
   std::string body;
@@ -1521,6 +1619,25 @@ envoy_cluster_test_1_upstream_rq_time_count{key1="value1",key2="value2"} 7
   EXPECT_EQ(expected_output, response.toString());
 }
 
+TEST_F(PrometheusStatsFormatterTest, WriterChunks) {
+  addCounter("cluster.test_1.upstream_cx_total", {{"a.tag-name", "a.tag-value"}});
+  addCounter("cluster.test_2.upstream_cx_total", {{"a.tag-name", "a.tag-value"}});
+  addGauge("cluster.test_1.upstream_cx_active", {{"a.tag-name", "a.tag-value"}});
+
+  Buffer::OwnedImpl expected;
+  PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_, expected, false);
+
+  PrometheusStatsFormatter::Writer writer(std::vector<Stats::CounterSharedPtr>(counters_),
+                                          std::vector<Stats::GaugeSharedPtr>(gauges_), {},
+                                          false);
+  Buffer::OwnedImpl response;
+  EXPECT_TRUE(writer.nextChunk(response, 2));
+  EXPECT_EQ(2UL, writer.metricTypes());
+  EXPECT_FALSE(writer.nextChunk(response, 2));
+  EXPECT_EQ(3UL, writer.metricTypes());
+  EXPECT_EQ(expected.toString(), response.toString());
+}
+
 TEST_F(PrometheusStatsFormatterTest, OutputWithUsedOnly) {
   addCounter("cluster.test_1.upstream_cx_total", {{"a.tag-name", "a.tag-value"}});
   addCounter("cluster.test_2.upstream_cx_total", {{"another_tag_name", "another_tag-value"}});
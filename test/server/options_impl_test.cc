@@ -74,7 +74,8 @@ TEST_F(OptionsImplTest, All) {
       "envoy --mode validate --concurrency 2 -c hello --admin-address-path path --restart-epoch 1 "
       "--local-address-ip-version v6 -l info --component-log-level upstream:debug,connection:trace "
       "--service-cluster cluster --service-node node --service-zone zone "
-      "--file-flush-interval-msec 9000 "
+      "--file-flush-interval-msec 9000 --file-buffer-limit-bytes 1048576 "
+      "--drop-on-file-buffer-limit "
       "--drain-time-s 60 --log-format [%v] --parent-shutdown-time-s 90 --log-path /foo/bar "
       "--disable-hot-restart --cpuset-threads");
   EXPECT_EQ(Server::Mode::Validate, options->mode());
@@ -91,6 +92,8 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ("node", options->serviceNodeName());
   EXPECT_EQ("zone", options->serviceZone());
   EXPECT_EQ(std::chrono::milliseconds(9000), options->fileFlushIntervalMsec());
+  EXPECT_EQ(1048576U, options->fileBufferLimitBytes());
+  EXPECT_TRUE(options->dropOnFileBufferLimit());
   EXPECT_EQ(std::chrono::seconds(60), options->drainTime());
   EXPECT_EQ(std::chrono::seconds(90), options->parentShutdownTime());
   EXPECT_EQ(true, options->hotRestartDisabled());
@@ -123,6 +126,8 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setParentShutdownTime(std::chrono::seconds(43));
   options->setRestartEpoch(44);
   options->setFileFlushIntervalMsec(std::chrono::milliseconds(45));
+  options->setFileBufferLimitBytes(4096);
+  options->setDropOnFileBufferLimit(true);
   options->setMode(Server::Mode::Validate);
   options->setServiceClusterName("cluster_foo");
   options->setServiceNodeName("node_foo");
@@ -146,6 +151,8 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(std::chrono::seconds(43), options->parentShutdownTime());
   EXPECT_EQ(44, options->restartEpoch());
   EXPECT_EQ(std::chrono::milliseconds(45), options->fileFlushIntervalMsec());
+  EXPECT_EQ(4096U, options->fileBufferLimitBytes());
+  EXPECT_TRUE(options->dropOnFileBufferLimit());
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ("cluster_foo", options->serviceClusterName());
   EXPECT_EQ("node_foo", options->serviceNodeName());
@@ -178,6 +185,8 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->restartEpoch(), command_line_options->restart_epoch());
   EXPECT_EQ(options->fileFlushIntervalMsec().count() / 1000,
             command_line_options->file_flush_interval().seconds());
+  EXPECT_EQ(options->fileBufferLimitBytes(), command_line_options->file_buffer_limit_bytes());
+  EXPECT_EQ(options->dropOnFileBufferLimit(), command_line_options->drop_on_file_buffer_limit());
   EXPECT_EQ(envoy::admin::v2alpha::CommandLineOptions::Validate, command_line_options->mode());
   EXPECT_EQ(options->serviceClusterName(), command_line_options->service_cluster());
   EXPECT_EQ(options->serviceNodeName(), command_line_options->service_node());
@@ -198,6 +207,8 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(Server::Mode::Serve, options->mode());
   EXPECT_EQ(false, options->hotRestartDisabled());
   EXPECT_EQ(false, options->cpusetThreadsEnabled());
+  EXPECT_EQ(0U, options->fileBufferLimitBytes());
+  EXPECT_EQ(false, options->dropOnFileBufferLimit());
 
   // Validate that CommandLineOptions is constructed correctly with default params.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();
@@ -314,6 +325,10 @@ TEST_F(OptionsImplTest, SaneTestConstructor) {
   EXPECT_EQ(regular_options_impl->mode(), test_options_impl.mode());
   EXPECT_EQ(regular_options_impl->fileFlushIntervalMsec(),
             test_options_impl.fileFlushIntervalMsec());
+  EXPECT_EQ(regular_options_impl->fileBufferLimitBytes(),
+            test_options_impl.fileBufferLimitBytes());
+  EXPECT_EQ(regular_options_impl->dropOnFileBufferLimit(),
+            test_options_impl.dropOnFileBufferLimit());
   EXPECT_EQ(regular_options_impl->maxStats(), test_options_impl.maxStats());
   EXPECT_EQ(regular_options_impl->statsOptions().maxNameLength(),
             test_options_impl.statsOptions().maxNameLength());
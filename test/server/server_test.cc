@@ -221,6 +221,23 @@ TEST_P(ServerInstanceImplTest, LifecycleNotifications) {
   server_thread->join();
 }
 
+// Validate that a server flushing stats on a dedicated thread starts and shuts down cleanly.
+TEST_P(ServerInstanceImplTest, StatsFlushOnDedicatedThread) {
+  absl::Notification started;
+
+  auto server_thread = Thread::threadFactoryForTest().createThread([&] {
+    initialize("test/server/stats_flush_thread_bootstrap.yaml");
+    server_->registerCallback(ServerLifecycleNotifier::Stage::Startup, [&] { started.Notify(); });
+    server_->run();
+    server_ = nullptr;
+    thread_local_ = nullptr;
+  });
+
+  started.WaitForNotification();
+  server_->dispatcher().post([&] { server_->shutdown(); });
+  server_thread->join();
+}
+
 TEST_P(ServerInstanceImplTest, V2ConfigOnly) {
   options_.service_cluster_name_ = "some_cluster_name";
   options_.service_node_name_ = "some_node_name";
@@ -0,0 +1,79 @@
+#include <thread>
+
+#include "server/stats_flush_thread.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Ref;
+using testing::Return;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class StatsFlushThreadTest : public testing::Test {
+public:
+  StatsFlushThreadTest()
+      : api_(Api::createApiForTest()), main_dispatcher_(api_->allocateDispatcher()) {
+    EXPECT_CALL(tls_, registerThread(_, false));
+    thread_ = std::make_unique<StatsFlushThread>(tls_, *main_dispatcher_, *api_);
+  }
+
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<MockGuardDog> guard_dog_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr main_dispatcher_;
+  StatsFlushThreadPtr thread_;
+};
+
+// Sinks are flushed on the stats flush thread, and completion is posted back to the main
+// dispatcher.
+TEST_F(StatsFlushThreadTest, Flush) {
+  const std::thread::id main_thread_id = std::this_thread::get_id();
+  NiceMock<Stats::MockStore> store;
+  auto snapshot = std::make_shared<Stats::SnapshotSourceImpl>(store);
+  NiceMock<Stats::MockSink> sink1;
+  NiceMock<Stats::MockSink> sink2;
+  ON_CALL(sink1, threadSafeFlush()).WillByDefault(Return(true));
+  ON_CALL(sink2, threadSafeFlush()).WillByDefault(Return(true));
+  std::thread::id flush_thread_id;
+  EXPECT_CALL(sink1, flush(Ref(*snapshot))).WillOnce(Invoke([&](Stats::Source&) -> void {
+    flush_thread_id = std::this_thread::get_id();
+  }));
+  EXPECT_CALL(sink2, flush(Ref(*snapshot))).WillOnce(Invoke([&](Stats::Source&) -> void {
+    EXPECT_EQ(flush_thread_id, std::this_thread::get_id());
+  }));
+
+  thread_->start(guard_dog_);
+  bool completed = false;
+  thread_->flush({&sink1, &sink2}, snapshot, [&]() -> void {
+    EXPECT_EQ(main_thread_id, std::this_thread::get_id());
+    completed = true;
+    main_dispatcher_->exit();
+  });
+  main_dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_TRUE(completed);
+  EXPECT_NE(main_thread_id, flush_thread_id);
+
+  EXPECT_CALL(tls_, shutdownThread());
+  thread_->stop();
+}
+
+// Stopping a thread that was never started is a no-op.
+TEST_F(StatsFlushThreadTest, StopBeforeStart) {
+  EXPECT_CALL(tls_, shutdownThread()).Times(0);
+  thread_->stop();
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy